@@ -44,12 +44,26 @@ using namespace Chimera::Threading;
 static void background_thread( void *arg );
 static void startup_blinky_sequence( const Chimera::GPIO::GPIO_sPtr &led );
 static void initialize_rf24_config();
+static void initialize_radio_irq();
+static void onRadioIrq( void *arg );
 static void MasterNodeThread( void *arg );
 static void SlaveNodeThread( void *arg );
 
 
 static RF24::Endpoint::SystemInit cfg;
 
+/*------------------------------------------------
+The radio pulls its IRQ line low whenever RX_DR, TX_DS
+or MAX_RT is raised. The node threads sleep on this
+semaphore instead of polling the radio's STATUS register
+on a fixed period, and only fall back to a periodic pass
+in case an edge is ever missed.
+------------------------------------------------*/
+static constexpr size_t RADIO_IRQ_FALLBACK_MS = 25;
+
+static Chimera::GPIO::GPIO_sPtr radioIrqPin;
+static Chimera::Threading::BinarySemaphore radioEvent;
+
 #if defined( RELEASE )
 #define RF24_DEVICE_1
 #endif 
@@ -82,6 +96,12 @@ int main( void )
 
   rootSink->flog( uLog::Level::LVL_INFO, "Boot up the world!\n" );
 
+  /*------------------------------------------------
+  Hook the radio IRQ line before any node thread exists
+  so that the pin is only ever set up once
+  ------------------------------------------------*/
+  initialize_radio_irq();
+
   /*------------------------------------------------
   Create the system threads
   ------------------------------------------------*/
@@ -183,9 +203,59 @@ void initialize_rf24_config()
   cfg.physical.spiConfig.HWInit.csMode      = Chimera::SPI::CSMode::MANUAL;
   cfg.physical.spiConfig.HWInit.dataSize    = Chimera::SPI::DataSize::SZ_8BIT;
   cfg.physical.spiConfig.HWInit.hwChannel   = 3;
+
+  /*------------------------------------------------
+  Most transactions are one or two byte register and
+  status accesses. Only payload reads and writes are
+  long enough that DMA could pay off, but this mode
+  applies to every transfer, so it stays on interrupts.
+  Putting just the payloads on DMA needs the driver in
+  RF24Node to switch modes around them.
+  ------------------------------------------------*/
   cfg.physical.spiConfig.HWInit.txfrMode    = Chimera::SPI::TransferMode::INTERRUPT;
 }
 
+void initialize_radio_irq()
+{
+  /*------------------------------------------------
+  PC4 is an assumption that has NOT been checked against
+  the board schematic. It was picked only because it sits
+  next to CSN on PC2 and CE on PC3. Confirm where the
+  radio's IRQ output is actually routed before relying on
+  this. The line is active low, hence the pull up and the
+  falling edge trigger.
+  ------------------------------------------------*/
+  Chimera::GPIO::PinInit irqInit;
+  irqInit.accessMode = Chimera::Hardware::AccessMode::THREADED;
+  irqInit.alternate  = Thor::LLD::GPIO::AF_NONE;
+  irqInit.drive      = Chimera::GPIO::Drive::INPUT;
+  irqInit.pin        = 4;
+  irqInit.port       = Chimera::GPIO::Port::PORTC;
+  irqInit.pull       = Chimera::GPIO::Pull::PULL_UP;
+  irqInit.validity   = true;
+
+  Chimera::Function::vGeneric callback = onRadioIrq;
+
+  radioIrqPin = Chimera::GPIO::create_shared_ptr();
+  radioIrqPin->init( irqInit, 100 );
+  radioIrqPin->attachInterrupt( callback, Chimera::EXTI::EdgeTrigger::FALLING_EDGE );
+}
+
+void onRadioIrq( void *arg )
+{
+  /*------------------------------------------------
+  Runs in the EXTI handler, so only wake the radio
+  thread. Its next doAsyncProcessing() pass handles
+  whatever raised the interrupt.
+
+  This is only an application level wakeup. Reading
+  STATUS and dispatching RX_DR, TX_DS and MAX_RT belongs
+  in RF24::Hardware::Driver, which lives in RF24Node and
+  is not part of this tree, so that part is still to do.
+  ------------------------------------------------*/
+  radioEvent.releaseFromISR();
+}
+
 void background_thread( void *arguments )
 {
   /*------------------------------------------------
@@ -254,7 +324,7 @@ void MasterNodeThread( void *arg )
   while ( true )
   {
     master->doAsyncProcessing();
-    Chimera::delayMilliseconds( 25 );
+    radioEvent.try_acquire_for( RADIO_IRQ_FALLBACK_MS );
   }
 }
 #endif /* RF24_DEVICE_1 */
@@ -279,6 +349,7 @@ void SlaveNodeThread( void *arg )
   Initialize the slave config
   ------------------------------------------------*/
   initialize_rf24_config();
+
   cfg.network.mode                = RF24::Network::Mode::NET_MODE_STATIC;
   cfg.network.nodeStaticAddress   = 0001;
   cfg.network.parentStaticAddress = RF24::RootNode0;
@@ -302,7 +373,7 @@ void SlaveNodeThread( void *arg )
   while ( connectStatus == RF24::Connection::Result::CONNECTION_UNKNOWN )
   {
     slave->processNetworking();
-    Chimera::delayMilliseconds( 25 );
+    radioEvent.try_acquire_for( RADIO_IRQ_FALLBACK_MS );
   }
 
   if ( connectStatus == RF24::Connection::Result::CONNECTION_SUCCESS )
@@ -317,7 +388,7 @@ void SlaveNodeThread( void *arg )
   while ( true )
   {
     slave->doAsyncProcessing();
-    Chimera::delayMilliseconds( 25 );
+    radioEvent.try_acquire_for( RADIO_IRQ_FALLBACK_MS );
   }
 }
 #endif /* RF24_DEVICE_2 */
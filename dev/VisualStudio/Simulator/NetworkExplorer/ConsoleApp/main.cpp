@@ -11,6 +11,7 @@
 /* STL Includes */
 #include <atomic>
 #include <iostream>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -22,12 +23,23 @@
 #include <uLog/sinks/sink_cout.hpp>
 
 /* Dev Includes */
+#include <sim_benchmark.hpp>
+#include <sim_clock.hpp>
+#include <sim_random.hpp>
+#include <sim_runner.hpp>
 #include <ping_tests.hpp>
 #include <multi_node_tests.hpp>
 #include <test_connection.hpp>
+#include <test_device_profile.hpp>
 #include <test_messaging.hpp>
+#include <test_retry_tuning.hpp>
+#include <test_streaming.hpp>
+#include <test_forwarding.hpp>
+#include <test_routing.hpp>
 
-int main()
+static constexpr uint64_t SimulationSeed = Sim::Random::DEFAULT_SEED;
+
+int main( int argc, char *argv[] )
 {
   ChimeraInit();
 
@@ -45,6 +57,34 @@ int main()
   uLog::setGlobalLogLevel( uLog::Level::LVL_TRACE );
   uLog::setRootSink( rootSink );
 
+  /*------------------------------------------------
+  Select the time source. The network stack times its
+  work with Chimera::millis() and Chimera::delayMilliseconds(),
+  which the Chimera sim backend still takes from the host
+  clock, so the stack can't run on virtual time yet.
+  VIRTUAL_TIME and DETERMINISTIC only move Sim::* code,
+  and using them here would leave the stack's timeouts
+  and the simulated radios on different clocks.
+  ------------------------------------------------*/
+  Sim::Random::setSeed( SimulationSeed );
+  Sim::Clock::setMode( Sim::Clock::Mode::REAL_TIME );
+
+  /*------------------------------------------------
+  Run headless when given a scenario file or run the
+  end to end benchmark. Per-node trace logging would
+  drown out the final report.
+  ------------------------------------------------*/
+  if ( ( argc > 1 ) && ( std::string( argv[ 1 ] ) == "--bench" ) )
+  {
+    uLog::setGlobalLogLevel( uLog::Level::LVL_WARN );
+    return Sim::Benchmark::runDefault( ( argc > 2 ) ? argv[ 2 ] : "" );
+  }
+  else if ( argc > 1 )
+  {
+    uLog::setGlobalLogLevel( uLog::Level::LVL_WARN );
+    return Sim::runScenarioFile( argv[ 1 ] );
+  }
+
   /*------------------------------------------------
   Enable which tests to run
   ------------------------------------------------*/
@@ -53,6 +93,11 @@ int main()
   //RunMultiNodeTests();
   //RunConnectionTests();
   RunMessagingTests();
+  //RunRetryTuningTests();
+  //RunStreamingTests();
+  //RunForwardingTests();
+  //RunDeviceProfile();
+  //RunRoutingBenchmark();
   
   return 0;
 }
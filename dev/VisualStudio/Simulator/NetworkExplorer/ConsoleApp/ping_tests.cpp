@@ -13,24 +13,37 @@
 #include <uLog/ulog.hpp>
 #include <uLog/sinks/sink_cout.hpp>
 
-static constexpr size_t AsyncUpdateRate  = 50;
-static constexpr size_t ThreadUpdateRate = 15;
+/* Dev Includes */
+#include <sim_clock.hpp>
+#include <sim_work.hpp>
 
-static void MasterNodeThread();
-static void SlaveNode001Thread();
+static constexpr size_t AsyncUpdateRate = 50;
+
+static void MasterNodeThread( Sim::WorkSignal_sPtr work );
+static void SlaveNode001Thread( Sim::WorkSignal_sPtr work );
 
 void RunPingTests()
 {
-  auto masterThread = std::thread( MasterNodeThread );
-  auto slaveThread  = std::thread( SlaveNode001Thread );
+  std::thread masterThread;
+  std::thread slaveThread;
+
+  {
+    Sim::Clock::HoldScope hold;
+
+    auto masterWork = std::make_shared<Sim::WorkSignal>();
+    auto slaveWork  = std::make_shared<Sim::WorkSignal>();
+
+    masterThread = Sim::Clock::createThread( MasterNodeThread, masterWork );
+    slaveThread  = Sim::Clock::createThread( SlaveNode001Thread, slaveWork );
+  }
 
   while ( true )
   {
-    Chimera::delayMilliseconds( 100 );
+    Sim::Clock::delayMilliseconds( 100 );
   }
 }
 
-static void MasterNodeThread()
+static void MasterNodeThread( Sim::WorkSignal_sPtr work )
 {
   uLog::SinkHandle masterSink = std::make_shared<uLog::CoutSink>();
   masterSink->setLogLevel( uLog::Level::LVL_DEBUG );
@@ -61,35 +74,32 @@ static void MasterNodeThread()
   /*------------------------------------------------
   Main processing loop for the slave node
   ------------------------------------------------*/
-  const size_t start_time       = Chimera::millis();
-  size_t asyncUpdateProcessTime = start_time;
-  size_t testCodeProcessTime    = start_time;
+  size_t testCodeProcessTime = Sim::Clock::millis();
 
   while ( true )
   {
     /*------------------------------------------------
     Handle the incoming RF data
     ------------------------------------------------*/
-    if ( ( Chimera::millis() - asyncUpdateProcessTime ) > AsyncUpdateRate )
-    {
-      master->doAsyncProcessing();
-      asyncUpdateProcessTime = Chimera::millis();
-    }
+    master->doAsyncProcessing();
 
     /*------------------------------------------------
     Process any test code used for development
     ------------------------------------------------*/
-    if ( ( Chimera::millis() - testCodeProcessTime ) > 1000 )
+    if ( ( Sim::Clock::millis() - testCodeProcessTime ) > 1000 )
     {
       ;
     }
 
-
-    Chimera::delayMilliseconds( ThreadUpdateRate );
+    /*------------------------------------------------
+    Sleep until the housekeeping and test code come
+    due again
+    ------------------------------------------------*/
+    work->waitForWork( AsyncUpdateRate );
   }
 }
 
-static void SlaveNode001Thread()
+static void SlaveNode001Thread( Sim::WorkSignal_sPtr work )
 {
   uLog::SinkHandle slaveSink = std::make_shared<uLog::CoutSink>();
   slaveSink->setLogLevel( uLog::Level::LVL_DEBUG );
@@ -130,9 +140,7 @@ static void SlaveNode001Thread()
   /*------------------------------------------------
   Main processing loop for the slave node
   ------------------------------------------------*/
-  const size_t start_time       = Chimera::millis();
-  size_t asyncUpdateProcessTime = start_time;
-  size_t testCodeProcessTime    = start_time;
+  size_t testCodeProcessTime = Sim::Clock::millis();
 
   std::string_view hello_world = "hello world!";
 
@@ -141,32 +149,31 @@ static void SlaveNode001Thread()
     /*------------------------------------------------
     Handle the incoming RF data
     ------------------------------------------------*/
-    if ( ( Chimera::millis() - asyncUpdateProcessTime ) > AsyncUpdateRate )
-    {
-      slave->doAsyncProcessing();
-      asyncUpdateProcessTime = Chimera::millis();
-    }
+    slave->doAsyncProcessing();
 
     /*------------------------------------------------
     Process any test code used for development
     ------------------------------------------------*/
-    if ( ( Chimera::millis() - testCodeProcessTime ) > 1000 )
+    if ( ( Sim::Clock::millis() - testCodeProcessTime ) > 1000 )
     {
       // slave->write( RF24::RootNode0, hello_world.data(), hello_world.size() );
-      slaveSink->flog( uLog::Level::LVL_INFO, "%d-Pinging the root node\n", Chimera::millis() );
+      slaveSink->flog( uLog::Level::LVL_INFO, "%d-Pinging the root node\n", Sim::Clock::millis() );
       if ( slave->ping( RF24::RootNode0, 150 ) )
       {
-        slaveSink->flog( uLog::Level::LVL_INFO, "%d-Success!\n", Chimera::millis() );
+        slaveSink->flog( uLog::Level::LVL_INFO, "%d-Success!\n", Sim::Clock::millis() );
       }
       else
       {
-        slaveSink->flog( uLog::Level::LVL_INFO, "%d-Failure :(\n", Chimera::millis() );
+        slaveSink->flog( uLog::Level::LVL_INFO, "%d-Failure :(\n", Sim::Clock::millis() );
       }
 
-      testCodeProcessTime = Chimera::millis();
+      testCodeProcessTime = Sim::Clock::millis();
     }
 
-
-    Chimera::delayMilliseconds( ThreadUpdateRate );
+    /*------------------------------------------------
+    Sleep until the housekeeping and test code come
+    due again
+    ------------------------------------------------*/
+    work->waitForWork( AsyncUpdateRate );
   }
 }
@@ -0,0 +1,271 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_benchmark.cpp
+ *
+ *  Description:
+ *    End-to-end benchmark implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+/* RF24 Includes */
+#include <RF24Node/src/common/utility.hpp>
+
+/* Dev Includes */
+#include <sim_benchmark.hpp>
+#include <sim_clock.hpp>
+#include <sim_endpoint.hpp>
+#include <sim_scenario.hpp>
+
+namespace Sim::Benchmark
+{
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  static std::string formatAddress( const RF24::LogicalAddress address )
+  {
+    char buffer[ 16 ];
+    snprintf( buffer, sizeof( buffer ), "%04o", address );
+    return buffer;
+  }
+
+  static double perSecond( const size_t count, const uint64_t us )
+  {
+    return us ? ( 1e6 * static_cast<double>( count ) / static_cast<double>( us ) ) : 0.0;
+  }
+
+  /**
+   *  Writes a scenario containing every node on the route and their ancestors,
+   *  so the network can form, with a single flow between the route's ends.
+   */
+  static std::string describePass( const Config &cfg, const Route &route, const size_t size, const bool latencyPass )
+  {
+    std::vector<RF24::LogicalAddress> nodes = { RF24::RootNode0 };
+
+    for ( RF24::LogicalAddress end : { route.source, route.destination } )
+    {
+      for ( RF24::LogicalAddress node = end; node != RF24::RootNode0; node = RF24::getParent( node ) )
+      {
+        nodes.push_back( node );
+      }
+    }
+
+    std::sort( nodes.begin(), nodes.end() );
+    nodes.erase( std::unique( nodes.begin(), nodes.end() ), nodes.end() );
+
+    std::ostringstream text;
+    text << "name     " << ( latencyPass ? "latency" : "throughput" ) << ", " << route.hops << " hops, " << size << " bytes\n";
+    text << "duration " << cfg.durationMs << "\n";
+    text << "workers  2\n";
+    text << "seed     " << cfg.seed << "\n";
+    text << "defaults rxQueueSize=160 txQueueSize=160 channel=96 dataRate=1MBPS power=HIGH\n";
+
+    for ( const RF24::LogicalAddress node : nodes )
+    {
+      text << "node " << formatAddress( node ) << "\n";
+    }
+
+    text << "traffic " << formatAddress( route.source ) << " -> " << formatAddress( route.destination ) << " every 0 ms size "
+         << size;
+
+    if ( latencyPass )
+    {
+      text << " count " << cfg.latencyMessages << " window 1 echo\n";
+    }
+    else
+    {
+      text << " count " << cfg.throughputMessages << "\n";
+    }
+
+    return text.str();
+  }
+
+  static bool runPass( const Config &cfg, const Route &route, const size_t size, const bool latencyPass, FlowReport &flow )
+  {
+    Scenario::Description desc;
+    std::string error;
+    std::istringstream text( describePass( cfg, route, size, latencyPass ) );
+
+    flow = FlowReport{};
+    if ( !Scenario::parse( text, desc, error ) )
+    {
+      std::cerr << "benchmark scenario rejected: " << error << std::endl;
+      return false;
+    }
+
+    ScenarioRunner runner( desc );
+    const ScenarioReport report = runner.run();
+
+    if ( !report.flows.empty() )
+    {
+      flow = report.flows.front();
+    }
+
+    return report.connected == report.nodes;
+  }
+
+  static void writePercentiles( std::ostream &stream, const char *name, const size_t samples, const uint64_t p50,
+                                const uint64_t p99, const uint64_t p999, const uint64_t max )
+  {
+    char line[ 256 ];
+    snprintf( line, sizeof( line ), "\"%s\": { \"samples\": %zu, \"p50\": %llu, \"p99\": %llu, \"p999\": %llu, \"max\": %llu }",
+              name, samples, static_cast<unsigned long long>( p50 ), static_cast<unsigned long long>( p99 ),
+              static_cast<unsigned long long>( p999 ), static_cast<unsigned long long>( max ) );
+    stream << line;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  Config defaultConfig()
+  {
+    Config cfg;
+
+    /*------------------------------------------------
+    Hops count the nodes that relay a message. The tree
+    is only five levels deep, so the longest route has
+    to go up through the root and back down again.
+    ------------------------------------------------*/
+    cfg.routes = {
+      { 0, 0000, 0001 },
+      { 1, 0000, 0013 },
+      { 3, 0000, 02113 },
+      { 5, 0113, 0122 },
+    };
+
+    cfg.sizes              = { 1, 4, 8, 16, Endpoint::MAX_PAYLOAD_SIZE };
+    cfg.throughputMessages = 1000;
+    cfg.latencyMessages    = 1000;
+    cfg.durationMs         = 60000;
+    cfg.seed               = 1;
+
+    return cfg;
+  }
+
+  std::vector<Result> run( const Config &cfg, std::ostream *progress )
+  {
+    std::vector<Result> results;
+
+    for ( const Route &route : cfg.routes )
+    {
+      for ( const size_t size : cfg.sizes )
+      {
+        const auto start = std::chrono::steady_clock::now();
+
+        Result result;
+        result.route  = route;
+        result.size   = size;
+        result.formed = runPass( cfg, route, size, false, result.throughput );
+        result.formed = runPass( cfg, route, size, true, result.latency ) && result.formed;
+        result.hostUs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start ).count() );
+
+        if ( progress )
+        {
+          char line[ 256 ];
+          snprintf( line, sizeof( line ), "%u hops, %2zu bytes: %8.1f msg/s, one-way p50 %llu us, round trip p50 %llu us%s\n",
+                    static_cast<unsigned>( route.hops ), size,
+                    perSecond( result.throughput.delivered, result.throughput.activeUs ),
+                    static_cast<unsigned long long>( result.latency.p50Us ),
+                    static_cast<unsigned long long>( result.latency.rttP50Us ), result.formed ? "" : " (network did not form)" );
+          *progress << line << std::flush;
+        }
+
+        results.push_back( result );
+      }
+    }
+
+    return results;
+  }
+
+  void writeJson( const Config &cfg, const std::vector<Result> &results, std::ostream &stream )
+  {
+    char line[ 512 ];
+
+    stream << "{\n";
+    snprintf( line, sizeof( line ),
+              "  \"format\": %u,\n  \"seed\": %llu,\n  \"data_rate\": \"1MBPS\",\n"
+              "  \"throughput_messages\": %zu,\n  \"latency_messages\": %zu,\n  \"limitations\": \"%s\",\n",
+              REPORT_FORMAT, static_cast<unsigned long long>( cfg.seed ), cfg.throughputMessages, cfg.latencyMessages,
+              LIMITATIONS );
+    stream << line;
+    stream << "  \"cases\": [\n";
+
+    for ( size_t x = 0; x < results.size(); x++ )
+    {
+      const Result &result   = results[ x ];
+      const FlowReport &tput = result.throughput;
+      const FlowReport &lat  = result.latency;
+
+      snprintf( line, sizeof( line ),
+                "    {\n      \"hops\": %zu,\n      \"source\": \"%s\",\n      \"destination\": \"%s\",\n"
+                "      \"payload_bytes\": %zu,\n      \"formed\": %s,\n      \"host_ms\": %.1f,\n",
+                result.route.hops, formatAddress( result.route.source ).c_str(),
+                formatAddress( result.route.destination ).c_str(), result.size, result.formed ? "true" : "false",
+                static_cast<double>( result.hostUs ) / 1000.0 );
+      stream << line;
+
+      snprintf( line, sizeof( line ),
+                "      \"throughput\": { \"sent\": %zu, \"delivered\": %zu, \"duration_us\": %llu, "
+                "\"msgs_per_sec\": %.1f, \"bytes_per_sec\": %.1f },\n",
+                tput.sent, tput.delivered, static_cast<unsigned long long>( tput.activeUs ),
+                perSecond( tput.delivered, tput.activeUs ), perSecond( tput.bytes, tput.activeUs ) );
+      stream << line;
+
+      stream << "      ";
+      writePercentiles( stream, "one_way_us", lat.delivered, lat.p50Us, lat.p99Us, lat.p999Us, lat.maxUs );
+      stream << ",\n      ";
+      writePercentiles( stream, "round_trip_us", lat.echoed, lat.rttP50Us, lat.rttP99Us, lat.rttP999Us, lat.rttMaxUs );
+      stream << "\n    }" << ( ( x + 1 < results.size() ) ? "," : "" ) << "\n";
+    }
+
+    stream << "  ]\n}\n";
+  }
+
+  int runDefault( const std::string &path )
+  {
+    /*------------------------------------------------
+    The stack times everything on the host clock, so
+    any other mode would measure a different clock
+    than the one the messages actually travel on.
+    ------------------------------------------------*/
+    if ( Clock::getMode() != Clock::Mode::REAL_TIME )
+    {
+      std::cerr << "the benchmark needs Sim::Clock in REAL_TIME" << std::endl;
+      return 2;
+    }
+
+    std::cerr << "Limitations: " << LIMITATIONS << std::endl;
+
+    const Config cfg                  = defaultConfig();
+    const std::vector<Result> results = run( cfg, &std::cerr );
+
+    if ( path.empty() )
+    {
+      writeJson( cfg, results, std::cout );
+    }
+    else
+    {
+      std::ofstream file( path );
+      if ( !file )
+      {
+        std::cerr << "unable to create " << path << std::endl;
+        return 2;
+      }
+
+      writeJson( cfg, results, file );
+    }
+
+    const bool formed = std::all_of( results.begin(), results.end(), []( const Result &result ) { return result.formed; } );
+    return formed ? 0 : 1;
+  }
+
+}    // namespace Sim::Benchmark
@@ -0,0 +1,122 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_benchmark.hpp
+ *
+ *  Description:
+ *    End-to-end benchmark of Endpoint::write()/read() across a fixed set of
+ *    routes and payload sizes. Each case runs two scenarios: a back to back
+ *    stream for sustained throughput and a one-at-a-time echo for one-way and
+ *    round trip latency. Results are written as JSON so they can be compared
+ *    from one release to the next.
+ *
+ *    Timing comes from Sim::Clock in REAL_TIME, the same host clock the stack
+ *    runs on, so the benchmark refuses to run in any other mode.
+ *
+ *    Not done yet: numbers for the relay routes. The RF24Node submodule isn't
+ *    part of this tree, so the benchmark has only run against a stand-in
+ *    endpoint that delivers every message in a single hop, and no 1, 3 or 5
+ *    hop result has come from the real stack. Both the console output and the
+ *    JSON "limitations" field report this gap.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_BENCHMARK_HPP
+#define RF24_SIM_BENCHMARK_HPP
+
+/* STL Includes */
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+
+/* Dev Includes */
+#include <sim_runner.hpp>
+
+namespace Sim::Benchmark
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint32_t REPORT_FORMAT = 3; /**< Bumped whenever the JSON layout changes */
+
+  static constexpr const char *LIMITATIONS = "relay routes have no results from the RF24Node stack yet, "
+                                             "only a single hop stand-in endpoint has been measured";
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct Route
+  {
+    size_t hops;                      /**< Nodes relaying each message between source and destination */
+    RF24::LogicalAddress source;
+    RF24::LogicalAddress destination;
+  };
+
+  struct Config
+  {
+    std::vector<Route> routes;
+    std::vector<size_t> sizes;        /**< Payload bytes handed to Endpoint::write() */
+    size_t throughputMessages;        /**< Messages streamed back to back in the throughput pass */
+    size_t latencyMessages;           /**< Messages sent one at a time and echoed in the latency pass */
+    size_t durationMs;                /**< Simulation time each pass is given, including network formation */
+    uint64_t seed;
+  };
+
+  struct Result
+  {
+    Route route;
+    size_t size;
+    bool formed;                      /**< Both passes managed to connect every node on the route */
+    FlowReport throughput;
+    FlowReport latency;
+    uint64_t hostUs;                  /**< Wall clock time spent running both passes */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Routes of 0, 1, 3 and 5 hops crossing the tree, payload sizes from a
+   *  single byte up to Endpoint::MAX_PAYLOAD_SIZE and enough messages per
+   *  case for a meaningful p99.9.
+   *
+   *  @return Config
+   */
+  Config defaultConfig();
+
+  /**
+   *  Runs every route and payload size combination
+   *
+   *  @param[in]  cfg       What to measure
+   *  @param[in]  progress  Where to note each case as it completes, may be nullptr
+   *  @return std::vector<Result>
+   */
+  std::vector<Result> run( const Config &cfg, std::ostream *progress );
+
+  /**
+   *  Writes the results as a single JSON document
+   *
+   *  @param[in]  cfg       Configuration the results were produced with
+   *  @param[in]  results   Output of run()
+   *  @param[in]  stream    Where to write
+   *  @return void
+   */
+  void writeJson( const Config &cfg, const std::vector<Result> &results, std::ostream &stream );
+
+  /**
+   *  Runs the default benchmark and writes the JSON report
+   *
+   *  @param[in]  path      Output file, or empty for stdout
+   *  @return int           Process exit code, 0 if every case formed its network
+   */
+  int runDefault( const std::string &path );
+
+}    // namespace Sim::Benchmark
+
+#endif /* !RF24_SIM_BENCHMARK_HPP */
@@ -0,0 +1,293 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_capture.cpp
+ *
+ *  Description:
+ *    Frame capture and trace reader implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#if defined( _WIN32 )
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Dev Includes */
+#include <sim_capture.hpp>
+#include <sim_clock.hpp>
+
+namespace Sim::Capture
+{
+  /*-------------------------------------------------------------------------------
+  Private Data
+  -------------------------------------------------------------------------------*/
+  static std::atomic<bool> s_active( false );
+  static std::mutex s_lock;
+  static std::FILE *s_file = nullptr;
+  static std::vector<Record> s_staged;
+  static size_t s_written = 0;
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  static FileHeader makeHeader( const uint64_t count )
+  {
+    FileHeader header{};
+    memcpy( header.magic, TRACE_MAGIC, sizeof( header.magic ) );
+    header.version     = TRACE_VERSION;
+    header.recordSize  = sizeof( Record );
+    header.recordCount = count;
+
+    return header;
+  }
+
+  /**
+   *  Writes out the staged records. Expects s_lock to be held.
+   */
+  static void writeStaged()
+  {
+    if ( s_file && !s_staged.empty() )
+    {
+      s_written += fwrite( s_staged.data(), sizeof( Record ), s_staged.size(), s_file );
+    }
+
+    s_staged.clear();
+  }
+
+  /*-------------------------------------------------------------------------------
+  TraceReader Implementation
+  -------------------------------------------------------------------------------*/
+  TraceReader::TraceReader() : mBase( nullptr ), mLength( 0 ), mCount( 0 ), mHandle( nullptr )
+  {
+  }
+
+  TraceReader::~TraceReader()
+  {
+    close();
+  }
+
+  bool TraceReader::open( const std::string &path )
+  {
+    close();
+
+#if defined( _WIN32 )
+    HANDLE file = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if ( file == INVALID_HANDLE_VALUE )
+    {
+      return false;
+    }
+
+    LARGE_INTEGER size;
+    if ( !GetFileSizeEx( file, &size ) || ( static_cast<uint64_t>( size.QuadPart ) < sizeof( FileHeader ) ) )
+    {
+      CloseHandle( file );
+      return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    CloseHandle( file );
+
+    if ( !mapping )
+    {
+      return false;
+    }
+
+    mBase = static_cast<const uint8_t *>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+    if ( !mBase )
+    {
+      CloseHandle( mapping );
+      return false;
+    }
+
+    mHandle = mapping;
+    mLength = static_cast<size_t>( size.QuadPart );
+#else
+    const int fd = ::open( path.c_str(), O_RDONLY );
+    if ( fd < 0 )
+    {
+      return false;
+    }
+
+    struct stat info;
+    if ( ( fstat( fd, &info ) != 0 ) || ( static_cast<size_t>( info.st_size ) < sizeof( FileHeader ) ) )
+    {
+      ::close( fd );
+      return false;
+    }
+
+    void *base = mmap( nullptr, static_cast<size_t>( info.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+    ::close( fd );
+
+    if ( base == MAP_FAILED )
+    {
+      return false;
+    }
+
+    mBase   = static_cast<const uint8_t *>( base );
+    mLength = static_cast<size_t>( info.st_size );
+#endif
+
+    /*------------------------------------------------
+    Reject anything written by an incompatible build. The
+    record count comes from the file length so a capture
+    that was never stopped cleanly is still readable.
+    ------------------------------------------------*/
+    const FileHeader *header = reinterpret_cast<const FileHeader *>( mBase );
+
+    if ( ( memcmp( header->magic, TRACE_MAGIC, sizeof( header->magic ) ) != 0 ) || ( header->version != TRACE_VERSION ) ||
+         ( header->recordSize != sizeof( Record ) ) )
+    {
+      close();
+      return false;
+    }
+
+    mCount = ( mLength - sizeof( FileHeader ) ) / sizeof( Record );
+    return true;
+  }
+
+  void TraceReader::close()
+  {
+    if ( !mBase )
+    {
+      return;
+    }
+
+#if defined( _WIN32 )
+    UnmapViewOfFile( mBase );
+    CloseHandle( static_cast<HANDLE>( mHandle ) );
+#else
+    munmap( const_cast<uint8_t *>( mBase ), mLength );
+#endif
+
+    mBase   = nullptr;
+    mLength = 0;
+    mCount  = 0;
+    mHandle = nullptr;
+  }
+
+  size_t TraceReader::size() const
+  {
+    return mCount;
+  }
+
+  const Record &TraceReader::operator[]( const size_t index ) const
+  {
+    return begin()[ index ];
+  }
+
+  const Record *TraceReader::begin() const
+  {
+    return mBase ? reinterpret_cast<const Record *>( mBase + sizeof( FileHeader ) ) : nullptr;
+  }
+
+  const Record *TraceReader::end() const
+  {
+    return mBase ? ( begin() + mCount ) : nullptr;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  bool start( const std::string &path )
+  {
+    stop();
+
+    std::lock_guard<std::mutex> lock( s_lock );
+
+    s_file = fopen( path.c_str(), "wb" );
+    if ( !s_file )
+    {
+      return false;
+    }
+
+    const FileHeader header = makeHeader( 0 );
+    fwrite( &header, sizeof( header ), 1, s_file );
+
+    s_staged.clear();
+    s_staged.reserve( WRITE_BLOCK_RECORDS );
+    s_written = 0;
+    s_active  = true;
+
+    return true;
+  }
+
+  size_t stop()
+  {
+    std::lock_guard<std::mutex> lock( s_lock );
+
+    if ( !s_file )
+    {
+      return 0;
+    }
+
+    s_active = false;
+    writeStaged();
+
+    const FileHeader header = makeHeader( s_written );
+    fseek( s_file, 0, SEEK_SET );
+    fwrite( &header, sizeof( header ), 1, s_file );
+    fclose( s_file );
+    s_file = nullptr;
+
+    return s_written;
+  }
+
+  void flush()
+  {
+    std::lock_guard<std::mutex> lock( s_lock );
+
+    writeStaged();
+
+    if ( s_file )
+    {
+      fflush( s_file );
+    }
+  }
+
+  bool isActive()
+  {
+    return s_active.load( std::memory_order_relaxed );
+  }
+
+  void record( const Medium::Frame &frame, const Medium::Address destination, const Channel::Outcome outcome )
+  {
+    Record entry;
+    entry.timestampUs = Clock::micros();
+    entry.source      = frame.source;
+    entry.destination = destination;
+    entry.channel     = frame.channel;
+    entry.length      = frame.length;
+    entry.pid         = frame.pid;
+    entry.flags       = frame.flags;
+    entry.outcome     = static_cast<uint8_t>( outcome );
+    memset( entry.reserved, 0, sizeof( entry.reserved ) );
+    memcpy( entry.payload, frame.payload.data(), sizeof( entry.payload ) );
+
+    std::lock_guard<std::mutex> lock( s_lock );
+
+    if ( !s_file )
+    {
+      return;
+    }
+
+    s_staged.push_back( entry );
+
+    if ( s_staged.size() >= WRITE_BLOCK_RECORDS )
+    {
+      writeStaged();
+    }
+  }
+
+}    // namespace Sim::Capture
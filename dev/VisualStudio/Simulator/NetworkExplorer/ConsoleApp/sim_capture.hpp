@@ -0,0 +1,163 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_capture.hpp
+ *
+ *  Description:
+ *    Binary capture of every frame crossing Sim::Channel, plus a reader to
+ *    scan a capture afterwards. Traces are a 64 byte header followed by fixed
+ *    64 byte records, so a file can be memory mapped and indexed directly
+ *    without any parsing.
+ *
+ *    Only the Sim::ShockBurst model transmits through Sim::Channel, so that is
+ *    the only traffic a capture sees. RF24::Endpoint still uses the RF24Node
+ *    loopback sockets and never shows up in a trace, which is also why there
+ *    is no replay into an endpoint.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_CAPTURE_HPP
+#define RF24_SIM_CAPTURE_HPP
+
+/* STL Includes */
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/* Dev Includes */
+#include <sim_channel.hpp>
+#include <sim_medium.hpp>
+
+namespace Sim::Capture
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr char TRACE_MAGIC[ 8 ]        = { 'R', 'F', '2', '4', 'T', 'R', 'C', '\0' };
+  static constexpr uint32_t TRACE_VERSION       = 1;
+  static constexpr size_t WRITE_BLOCK_RECORDS   = 4096; /**< Records staged in memory between file writes */
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct FileHeader
+  {
+    char magic[ 8 ];
+    uint32_t version;
+    uint32_t recordSize;  /**< sizeof( Record ), lets readers reject mismatched builds */
+    uint64_t recordCount; /**< Filled in when the capture stops, readers trust the file length instead */
+    uint8_t reserved[ 40 ];
+  };
+
+  struct Record
+  {
+    uint64_t timestampUs; /**< Simulation time the frame's fate was decided */
+    uint64_t source;      /**< Physical address of the transmitting pipe */
+    uint64_t destination; /**< Physical address of the receiving pipe */
+    uint8_t channel;
+    uint8_t length;
+    uint8_t pid;
+    uint8_t flags;        /**< Medium::FRAME_FLAG_xxx */
+    uint8_t outcome;      /**< Channel::Outcome */
+    uint8_t reserved[ 3 ];
+    uint8_t payload[ Medium::FRAME_WIDTH ];
+  };
+
+  static_assert( sizeof( FileHeader ) == 64, "Trace header must stay a fixed size" );
+  static_assert( sizeof( Record ) == 64, "Trace records must stay a fixed size" );
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Read-only, memory mapped view of a trace file
+   */
+  class TraceReader
+  {
+  public:
+    TraceReader();
+    ~TraceReader();
+
+    TraceReader( const TraceReader & ) = delete;
+    TraceReader &operator=( const TraceReader & ) = delete;
+
+    /**
+     *  Maps a trace file into memory
+     *
+     *  @param[in]  path      File to open
+     *  @return bool          False if the file is missing or isn't a compatible trace
+     */
+    bool open( const std::string &path );
+
+    /**
+     *  Unmaps the file
+     *
+     *  @return void
+     */
+    void close();
+
+    /**
+     *  Number of records in the trace
+     *
+     *  @return size_t
+     */
+    size_t size() const;
+
+    const Record &operator[]( const size_t index ) const;
+    const Record *begin() const;
+    const Record *end() const;
+
+  private:
+    const uint8_t *mBase;
+    size_t mLength;
+    size_t mCount;
+    void *mHandle; /**< Platform specific mapping handle */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Starts recording every frame that passes through Sim::Channel
+   *
+   *  @param[in]  path      Trace file to create, overwritten if it exists
+   *  @return bool          False if the file couldn't be created
+   */
+  bool start( const std::string &path );
+
+  /**
+   *  Flushes and closes the trace, filling in the final record count
+   *
+   *  @return size_t        Number of records written
+   */
+  size_t stop();
+
+  /**
+   *  Pushes staged records out to the file without stopping the capture.
+   *  Useful for tests that never return, so the trace survives a kill.
+   *
+   *  @return void
+   */
+  void flush();
+
+  /**
+   *  Cheap check used on the per-frame path before calling record()
+   *
+   *  @return bool
+   */
+  bool isActive();
+
+  /**
+   *  Appends a frame to the active trace. Safe to call from any thread.
+   *
+   *  @param[in]  frame       The frame
+   *  @param[in]  destination Physical address it was sent to
+   *  @param[in]  outcome     What became of it
+   *  @return void
+   */
+  void record( const Medium::Frame &frame, const Medium::Address destination, const Channel::Outcome outcome );
+
+}    // namespace Sim::Capture
+
+#endif /* !RF24_SIM_CAPTURE_HPP */
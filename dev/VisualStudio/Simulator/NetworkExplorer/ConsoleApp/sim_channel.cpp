@@ -0,0 +1,418 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_channel.cpp
+ *
+ *  Description:
+ *    RF channel model implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/* RF24 Includes */
+#include <RF24Node/src/common/conversion.hpp>
+
+/* Dev Includes */
+#include <sim_capture.hpp>
+#include <sim_channel.hpp>
+#include <sim_clock.hpp>
+#include <sim_random.hpp>
+
+namespace Sim::Channel
+{
+  /*-------------------------------------------------------------------------------
+  Private Structures
+  -------------------------------------------------------------------------------*/
+  struct Transmission
+  {
+    uint64_t start;
+    uint64_t end;
+    bool collided; /**< Guarded by the owning channel's lock */
+  };
+
+  using Transmission_sPtr = std::shared_ptr<Transmission>;
+
+  struct ChannelState
+  {
+    std::mutex lock;
+    std::vector<Transmission_sPtr> active;                /**< Transmissions that may still overlap new ones */
+    std::unordered_map<Medium::Address, uint64_t> txFree; /**< When each transmitter finishes its last frame */
+    uint64_t busyUntil;
+    std::mt19937_64 rng;
+    Stats stats;
+  };
+
+  /*-------------------------------------------------------------------------------
+  Private Data
+  -------------------------------------------------------------------------------*/
+  static std::mutex s_configLock;
+  static Config s_config = defaultConfig();
+  static std::map<std::pair<Medium::Address, Medium::Address>, LinkParams> s_links;
+  static std::array<ChannelState, NUM_CHANNELS> s_channels;
+  static std::mutex s_receiverLock;
+  static std::unordered_map<Medium::Address, Receiver> s_receivers;
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  static LinkParams lookupLink( const Medium::Address from, const Medium::Address to )
+  {
+    std::lock_guard<std::mutex> lock( s_configLock );
+
+    auto iter = s_links.find( { from, to } );
+    return ( iter == s_links.end() ) ? s_config.defaultLink : iter->second;
+  }
+
+  /**
+   *  Hands a frame that survived the air to whoever listens on the destination address
+   */
+  static Outcome accept( const Medium::Address destination, const Medium::Pipe &pipe, const Medium::Frame &frame )
+  {
+    Receiver receiver;
+
+    {
+      std::lock_guard<std::mutex> lock( s_receiverLock );
+
+      auto iter = s_receivers.find( destination );
+      if ( iter != s_receivers.end() )
+      {
+        receiver = iter->second;
+      }
+    }
+
+    if ( receiver )
+    {
+      return receiver( frame );
+    }
+
+    return pipe->push( frame ) ? Outcome::DELIVERED : Outcome::DROPPED;
+  }
+
+  /**
+   *  Resolves what happens to a frame once its airtime and link latency have passed.
+   *  No locks are held while calling out so receivers are free to transmit a reply.
+   */
+  static void deliver( ChannelState *const state, const Transmission_sPtr &tx, const bool lost,
+                       const Medium::Address destination, const Medium::Pipe &pipe, const Medium::Frame &frame,
+                       const Completion &onComplete )
+  {
+    bool collided = false;
+
+    if ( state )
+    {
+      std::lock_guard<std::mutex> lock( state->lock );
+      collided = tx->collided;
+    }
+
+    Outcome outcome = Outcome::DELIVERED;
+
+    if ( collided )
+    {
+      outcome = Outcome::COLLIDED;
+    }
+    else if ( lost )
+    {
+      outcome = Outcome::LOST;
+    }
+    else
+    {
+      outcome = accept( destination, pipe, frame );
+    }
+
+    if ( Capture::isActive() )
+    {
+      Capture::record( frame, destination, outcome );
+    }
+
+    if ( state )
+    {
+      std::lock_guard<std::mutex> lock( state->lock );
+
+      switch ( outcome )
+      {
+        case Outcome::COLLIDED:
+          state->stats.collided++;
+          break;
+
+        case Outcome::LOST:
+          state->stats.lost++;
+          break;
+
+        case Outcome::DROPPED:
+          state->stats.dropped++;
+          break;
+
+        case Outcome::DELIVERED:
+        default:
+          state->stats.delivered++;
+          break;
+      }
+    }
+
+    if ( onComplete )
+    {
+      onComplete( outcome );
+    }
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  Config defaultConfig()
+  {
+    Config cfg;
+    cfg.enabled                     = false;
+    cfg.contention                  = Contention::COLLIDE;
+    cfg.addressWidth                = 5;
+    cfg.crcLength                   = 2;
+    cfg.jitterUs                    = 0;
+    cfg.defaultLink.latencyUs       = 0;
+    cfg.defaultLink.lossProbability = 0.0;
+
+    return cfg;
+  }
+
+  void configure( const Config &cfg )
+  {
+    std::lock_guard<std::mutex> lock( s_configLock );
+    s_config = cfg;
+  }
+
+  Config getConfig()
+  {
+    std::lock_guard<std::mutex> lock( s_configLock );
+    return s_config;
+  }
+
+  uint64_t airtimeUs( const RF24::Hardware::DataRate rate, const size_t length )
+  {
+    size_t addressWidth = 0;
+    size_t crcLength    = 0;
+
+    {
+      std::lock_guard<std::mutex> lock( s_configLock );
+      addressWidth = s_config.addressWidth;
+      crcLength    = s_config.crcLength;
+    }
+
+    /*------------------------------------------------
+    Preamble, address, payload and CRC are whole bytes.
+    The packet control field adds 9 more bits.
+    ------------------------------------------------*/
+    const uint64_t bits = ( 8 * ( PREAMBLE_BYTES + addressWidth + length + crcLength ) ) + PCF_BITS;
+
+    switch ( rate )
+    {
+      case RF24::Hardware::DataRate::DR_250KBPS:
+        return bits * 4;
+
+      case RF24::Hardware::DataRate::DR_2MBPS:
+        return ( bits + 1 ) / 2;
+
+      case RF24::Hardware::DataRate::DR_1MBPS:
+      default:
+        return bits;
+    }
+  }
+
+  void setLinkParams( const Medium::Address from, const Medium::Address to, const LinkParams &params )
+  {
+    std::lock_guard<std::mutex> lock( s_configLock );
+    s_links[ { from, to } ] = params;
+  }
+
+  void setLinkParams( const RF24::LogicalAddress nodeA, const RF24::LogicalAddress nodeB, const LinkParams &params )
+  {
+    for ( size_t pipeA = 0; pipeA < RF24::Hardware::MAX_NUM_PIPES; pipeA++ )
+    {
+      for ( size_t pipeB = 0; pipeB < RF24::Hardware::MAX_NUM_PIPES; pipeB++ )
+      {
+        const auto a = RF24::Physical::Conversion::getPhysicalAddress( nodeA, static_cast<RF24::Hardware::PipeNumber>( pipeA ) );
+        const auto b = RF24::Physical::Conversion::getPhysicalAddress( nodeB, static_cast<RF24::Hardware::PipeNumber>( pipeB ) );
+
+        setLinkParams( a, b, params );
+        setLinkParams( b, a, params );
+      }
+    }
+  }
+
+  void attachReceiver( const Medium::Address address, Receiver receiver )
+  {
+    std::lock_guard<std::mutex> lock( s_receiverLock );
+    s_receivers[ address ] = std::move( receiver );
+  }
+
+  void detachReceiver( const Medium::Address address )
+  {
+    std::lock_guard<std::mutex> lock( s_receiverLock );
+    s_receivers.erase( address );
+  }
+
+  uint64_t transmit( const Medium::Frame &frame, const Medium::Address destination, const RF24::Hardware::DataRate rate,
+                     Completion onComplete )
+  {
+    const Config cfg   = getConfig();
+    const uint64_t now = Clock::micros();
+    Medium::Pipe pipe  = Medium::openPipe( destination );
+
+    if ( !cfg.enabled || ( frame.channel >= NUM_CHANNELS ) )
+    {
+      bool hasReceiver = static_cast<bool>( onComplete );
+
+      if ( !hasReceiver )
+      {
+        std::lock_guard<std::mutex> lock( s_receiverLock );
+        hasReceiver = ( s_receivers.find( destination ) != s_receivers.end() );
+      }
+
+      /*------------------------------------------------
+      Plain frames go straight into the pipe. Anything a
+      receiver may reply to is deferred so the reply never
+      re-enters the transmitter from within this call.
+      ------------------------------------------------*/
+      if ( !hasReceiver )
+      {
+        const bool pushed = pipe->push( frame );
+
+        if ( Capture::isActive() )
+        {
+          Capture::record( frame, destination, pushed ? Outcome::DELIVERED : Outcome::DROPPED );
+        }
+      }
+      else
+      {
+        Clock::schedule( 0, [ destination, pipe, frame, onComplete ]() {
+          deliver( nullptr, nullptr, false, destination, pipe, frame, onComplete );
+        } );
+      }
+
+      return now;
+    }
+
+    const LinkParams link = lookupLink( frame.source, destination );
+    const uint64_t air    = airtimeUs( rate, frame.length );
+    ChannelState &state   = s_channels[ frame.channel ];
+
+    auto tx  = std::make_shared<Transmission>();
+    bool lost = false;
+
+    {
+      std::lock_guard<std::mutex> lock( state.lock );
+
+      /*------------------------------------------------
+      Anything that finished before now can't overlap a
+      new transmission, which always starts in the future.
+      ------------------------------------------------*/
+      state.active.erase( std::remove_if( state.active.begin(), state.active.end(),
+                                          [ now ]( const Transmission_sPtr &item ) { return item->end <= now; } ),
+                          state.active.end() );
+
+      /*------------------------------------------------
+      A radio sends one frame at a time and has to settle
+      its PLL before every transmission.
+      ------------------------------------------------*/
+      uint64_t start = std::max( now, state.txFree[ frame.source ] ) + PLL_SETTLE_US;
+
+      /*------------------------------------------------
+      Under virtual time every node wakes on the exact
+      same microsecond. Real radios never line up like
+      that, so spread them out to avoid lockstep collisions.
+      ACKs and retransmits are timed by the radio itself.
+      ------------------------------------------------*/
+      if ( cfg.jitterUs && !( frame.flags & ( Medium::FRAME_FLAG_ACK | Medium::FRAME_FLAG_RETRY ) ) )
+      {
+        start += std::uniform_int_distribution<uint64_t>( 0, cfg.jitterUs )( state.rng );
+      }
+
+      if ( cfg.contention == Contention::SERIALIZE )
+      {
+        start = std::max( start, state.busyUntil );
+      }
+
+      tx->start    = start;
+      tx->end      = start + air;
+      tx->collided = false;
+
+      if ( cfg.contention == Contention::COLLIDE )
+      {
+        for ( auto &other : state.active )
+        {
+          if ( ( other->start < tx->end ) && ( tx->start < other->end ) )
+          {
+            other->collided = true;
+            tx->collided    = true;
+          }
+        }
+      }
+
+      state.active.push_back( tx );
+      state.txFree[ frame.source ] = tx->end;
+      state.busyUntil              = std::max( state.busyUntil, tx->end );
+
+      /*------------------------------------------------
+      Rolling for loss here rather than at delivery keeps
+      the random sequence tied to the order of transmits.
+      ------------------------------------------------*/
+      if ( link.lossProbability > 0.0 )
+      {
+        lost = std::generate_canonical<double, 32>( state.rng ) < link.lossProbability;
+      }
+
+      state.stats.transmitted++;
+      state.stats.airtimeUs += air;
+    }
+
+    Clock::schedule( ( tx->end - now ) + link.latencyUs, [ &state, tx, lost, destination, pipe, frame, onComplete ]() {
+      deliver( &state, tx, lost, destination, pipe, frame, onComplete );
+    } );
+
+    return tx->end;
+  }
+
+  Stats getStats( const uint8_t channel )
+  {
+    if ( channel >= NUM_CHANNELS )
+    {
+      return {};
+    }
+
+    std::lock_guard<std::mutex> lock( s_channels[ channel ].lock );
+    return s_channels[ channel ].stats;
+  }
+
+  void reset()
+  {
+    {
+      std::lock_guard<std::mutex> lock( s_configLock );
+      s_links.clear();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock( s_receiverLock );
+      s_receivers.clear();
+    }
+
+    for ( size_t channel = 0; channel < NUM_CHANNELS; channel++ )
+    {
+      ChannelState &state = s_channels[ channel ];
+      std::lock_guard<std::mutex> lock( state.lock );
+
+      state.active.clear();
+      state.txFree.clear();
+      state.busyUntil = 0;
+      state.stats     = {};
+      state.rng.seed( Random::deriveSeed( Random::STREAM_CHANNEL + channel ) );
+    }
+  }
+
+}    // namespace Sim::Channel
@@ -0,0 +1,198 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_channel.hpp
+ *
+ *  Description:
+ *    Airtime accurate model of the 2.4GHz channels sitting between simulated
+ *    radios. Frames occupy their RF channel for as long as the real hardware
+ *    would need to send them at the configured data rate, and can be delayed,
+ *    lost or destroyed by an overlapping transmission before they reach the
+ *    receiving pipe in the medium. Only Sim::ShockBurst transmits through it;
+ *    RF24::Endpoint still uses the loopback sockets of the RF24Node submodule.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_CHANNEL_HPP
+#define RF24_SIM_CHANNEL_HPP
+
+/* STL Includes */
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+
+/* Dev Includes */
+#include <sim_medium.hpp>
+
+namespace Sim::Channel
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t NUM_CHANNELS      = 126; /**< RF channels 2400MHz to 2525MHz */
+  static constexpr uint64_t PLL_SETTLE_US   = 130; /**< Standby-II to TX/RX settling time (Tstby2a) */
+  static constexpr size_t PREAMBLE_BYTES    = 1;
+  static constexpr size_t PCF_BITS          = 9;   /**< Packet control field when dynamic payloads are enabled */
+
+  /*-------------------------------------------------------------------------------
+  Enumerations
+  -------------------------------------------------------------------------------*/
+  enum class Contention : uint8_t
+  {
+    COLLIDE,   /**< Overlapping transmissions on a channel destroy each other, like the real radio */
+    SERIALIZE  /**< Transmissions queue behind each other, giving the channel's ideal capacity */
+  };
+
+  enum class Outcome : uint8_t
+  {
+    DELIVERED, /**< Frame was accepted at the destination */
+    COLLIDED,  /**< Another transmission overlapped it on the same channel */
+    LOST,      /**< Dropped by the link's loss probability */
+    DROPPED    /**< Made it across the air, but the receiver had no room for it */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct LinkParams
+  {
+    uint64_t latencyUs;     /**< Extra propagation/processing delay added after the frame's airtime */
+    double lossProbability; /**< Chance [0, 1] a frame is lost in transit */
+  };
+
+  struct Config
+  {
+    bool enabled;           /**< When false, frames are pushed straight into the receiving pipe */
+    Contention contention;  /**< How simultaneous transmissions on one channel are treated */
+    size_t addressWidth;    /**< Bytes in the on-air address field */
+    size_t crcLength;       /**< Bytes of CRC appended to each frame */
+    uint64_t jitterUs;      /**< Random spread (us) before a transmission starts, models MCU/SPI timing */
+    LinkParams defaultLink; /**< Used for any link without explicit parameters */
+  };
+
+  struct Stats
+  {
+    size_t transmitted; /**< Frames put on the air */
+    size_t delivered;
+    size_t collided;
+    size_t lost;
+    size_t dropped;
+    uint64_t airtimeUs; /**< Total time the channel carried a frame */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Aliases
+  -------------------------------------------------------------------------------*/
+  using Receiver   = std::function<Outcome( const Medium::Frame &frame )>; /**< Consumes a frame that survived the air */
+  using Completion = std::function<void( const Outcome outcome )>;         /**< Reports a transmission's fate */
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Gets a configuration matching the nRF24L01 defaults: 5 byte addresses,
+   *  2 byte CRC, colliding transmissions, an ideal link and the model disabled.
+   *
+   *  @return Config
+   */
+  Config defaultConfig();
+
+  /**
+   *  Applies a new configuration. Should be set before any traffic starts.
+   *
+   *  @param[in]  cfg       The configuration to use
+   *  @return void
+   */
+  void configure( const Config &cfg );
+
+  /**
+   *  Gets the active configuration
+   *
+   *  @return Config
+   */
+  Config getConfig();
+
+  /**
+   *  Time a single frame spends on the air, excluding PLL settling
+   *
+   *  @param[in]  rate      Data rate the frame is sent at
+   *  @param[in]  length    Payload bytes in the frame
+   *  @return uint64_t      Airtime in microseconds
+   */
+  uint64_t airtimeUs( const RF24::Hardware::DataRate rate, const size_t length );
+
+  /**
+   *  Overrides the link parameters for frames sent from one pipe address to another
+   *
+   *  @param[in]  from      Physical address of the transmitting pipe
+   *  @param[in]  to        Physical address of the receiving pipe
+   *  @param[in]  params    Parameters to use for the link
+   *  @return void
+   */
+  void setLinkParams( const Medium::Address from, const Medium::Address to, const LinkParams &params );
+
+  /**
+   *  Overrides the link parameters in both directions between every pipe of two nodes
+   *
+   *  @param[in]  nodeA     Logical address of the first node
+   *  @param[in]  nodeB     Logical address of the second node
+   *  @param[in]  params    Parameters to use for the link
+   *  @return void
+   */
+  void setLinkParams( const RF24::LogicalAddress nodeA, const RF24::LogicalAddress nodeB, const LinkParams &params );
+
+  /**
+   *  Routes frames arriving at an address through a receiver instead of pushing
+   *  them straight into the medium pipe. Used by radio models that need to see
+   *  each frame, e.g. to filter duplicates or send an acknowledgement.
+   *
+   *  @param[in]  address   Physical address to intercept
+   *  @param[in]  receiver  Callback invoked from the simulation clock on arrival
+   *  @return void
+   */
+  void attachReceiver( const Medium::Address address, Receiver receiver );
+
+  /**
+   *  Removes a receiver, frames go back to being pushed into the pipe
+   *
+   *  @param[in]  address   Physical address to release
+   *  @return void
+   */
+  void detachReceiver( const Medium::Address address );
+
+  /**
+   *  Puts a frame on the air. It arrives in the destination pipe after its
+   *  airtime plus the link latency, unless it is lost or collides first.
+   *
+   *  @param[in]  frame       The frame to send, frame.channel selects the RF channel
+   *  @param[in]  destination Physical address of the receiving pipe
+   *  @param[in]  rate        Data rate of the transmitting radio
+   *  @param[in]  onComplete  Optional callback told what became of the frame
+   *  @return uint64_t        Simulation time (us) the transmitter finishes sending
+   */
+  uint64_t transmit( const Medium::Frame &frame, const Medium::Address destination, const RF24::Hardware::DataRate rate,
+                     Completion onComplete = nullptr );
+
+  /**
+   *  Gets the accumulated statistics for a single RF channel
+   *
+   *  @param[in]  channel   The RF channel to query
+   *  @return Stats
+   */
+  Stats getStats( const uint8_t channel );
+
+  /**
+   *  Clears all statistics, link overrides and in-flight bookkeeping, and
+   *  reseeds each channel's random generator from Sim::Random
+   *
+   *  @return void
+   */
+  void reset();
+
+}    // namespace Sim::Channel
+
+#endif /* !RF24_SIM_CHANNEL_HPP */
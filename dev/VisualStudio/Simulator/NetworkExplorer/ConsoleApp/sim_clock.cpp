@@ -0,0 +1,496 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_clock.cpp
+ *
+ *  Description:
+ *    Simulation time source implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+/* Dev Includes */
+#include <sim_clock.hpp>
+
+namespace Sim::Clock
+{
+  /*-------------------------------------------------------------------------------
+  Private Data
+  -------------------------------------------------------------------------------*/
+  using SleepKey   = std::pair<uint64_t, uint64_t>; /**< Wakeup time (us) and a sequence number breaking ties */
+  using SleeperMap = std::map<SleepKey, Sleeper *>;
+
+  struct Sleeper
+  {
+    bool participant;           /**< True if the sleeping thread holds back the virtual clock */
+    bool released;              /**< Set once the thread is allowed to resume */
+    bool signalled;             /**< Released by a Signal rather than by time passing */
+    bool timed;                 /**< Has an entry in the sleeper map */
+    SleeperMap::iterator entry; /**< Position in the sleeper map, valid when timed */
+  };
+
+  struct TimedEvent
+  {
+    uint64_t time;  /**< Absolute simulation time to fire at (us) */
+    uint64_t order; /**< Tie breaker keeping same-time events in FIFO order */
+    Event callback; /**< Work to execute */
+
+    bool operator>( const TimedEvent &rhs ) const
+    {
+      return ( time > rhs.time ) || ( ( time == rhs.time ) && ( order > rhs.order ) );
+    }
+  };
+
+  using EventQueue = std::priority_queue<TimedEvent, std::vector<TimedEvent>, std::greater<TimedEvent>>;
+
+  static std::mutex s_lock;
+  static std::condition_variable s_wakeup;
+  static Mode s_mode = Mode::REAL_TIME;
+
+  static uint64_t s_virtualTime       = 0; /**< Current virtual time (us) */
+  static size_t s_participants        = 0; /**< Number of registered node threads */
+  static size_t s_blockedParticipants = 0; /**< Registered node threads currently sleeping */
+  static SleeperMap s_sleepers;
+  static uint64_t s_sleepOrder        = 0; /**< Next tie breaker handed out for the sleeper map */
+  static bool s_advancing             = false;
+
+  static EventQueue s_events;
+  static uint64_t s_eventOrder    = 0;
+  static bool s_dispatcherStarted = false;
+
+  static thread_local bool s_isParticipant = false;
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  static uint64_t hostMicros()
+  {
+    using namespace std::chrono;
+    return duration_cast<microseconds>( steady_clock::now().time_since_epoch() ).count();
+  }
+
+  static bool isVirtual()
+  {
+    return s_mode != Mode::REAL_TIME;
+  }
+
+  /**
+   *  Lets a blocked thread resume and removes it from the idle bookkeeping.
+   *  Must be called with s_lock held.
+   *
+   *  @param[in]  sleeper   The thread to release
+   *  @return void
+   */
+  static void release( Sleeper *const sleeper )
+  {
+    if ( sleeper->timed )
+    {
+      s_sleepers.erase( sleeper->entry );
+      sleeper->timed = false;
+    }
+
+    if ( isVirtual() && sleeper->participant )
+    {
+      s_blockedParticipants--;
+    }
+
+    sleeper->released = true;
+  }
+
+  /**
+   *  Moves virtual time forward to the next pending sleeper or event, but only
+   *  while every registered node thread is idle. Stops once at least one sleeping
+   *  thread has been released so it gets a chance to run at the new time. In
+   *  deterministic mode exactly one node thread is released per call.
+   *
+   *  @param[in]  lock      Held lock on s_lock, temporarily released to run events
+   *  @return void
+   */
+  static void tryAdvance( std::unique_lock<std::mutex> &lock )
+  {
+    s_advancing = true;
+
+    while ( ( s_blockedParticipants == s_participants ) && ( !s_sleepers.empty() || !s_events.empty() ) )
+    {
+      /*------------------------------------------------
+      Jump to whichever comes first: an event or a wakeup
+      ------------------------------------------------*/
+      uint64_t next = UINT64_MAX;
+
+      if ( !s_sleepers.empty() )
+      {
+        next = s_sleepers.begin()->first.first;
+      }
+
+      if ( !s_events.empty() && ( s_events.top().time < next ) )
+      {
+        next = s_events.top().time;
+      }
+
+      if ( next > s_virtualTime )
+      {
+        s_virtualTime = next;
+      }
+
+      /*------------------------------------------------
+      Fire all due events. The lock is dropped so that the
+      callbacks are free to query time or queue more events.
+      ------------------------------------------------*/
+      while ( !s_events.empty() && ( s_events.top().time <= s_virtualTime ) )
+      {
+        Event callback = s_events.top().callback;
+        s_events.pop();
+
+        lock.unlock();
+        callback();
+        lock.lock();
+      }
+
+      /*------------------------------------------------
+      Deterministic mode hands the CPU to one node thread
+      at a time, in the order the wakeups were requested.
+      Observers (e.g. the thread running a scenario) only
+      resume once no node thread is due, so they always
+      see the same state at a given time.
+      ------------------------------------------------*/
+      if ( s_mode == Mode::DETERMINISTIC )
+      {
+        Sleeper *turn = nullptr;
+
+        for ( auto iter = s_sleepers.begin(); ( iter != s_sleepers.end() ) && ( iter->first.first <= s_virtualTime ); iter++ )
+        {
+          if ( iter->second->participant )
+          {
+            turn = iter->second;
+            break;
+          }
+        }
+
+        if ( turn )
+        {
+          release( turn );
+          s_wakeup.notify_all();
+          break;
+        }
+      }
+
+      /*------------------------------------------------
+      Release everyone whose wakeup time has been reached
+      ------------------------------------------------*/
+      bool releasedAny = false;
+
+      while ( !s_sleepers.empty() && ( s_sleepers.begin()->first.first <= s_virtualTime ) )
+      {
+        release( s_sleepers.begin()->second );
+        releasedAny = true;
+      }
+
+      if ( releasedAny )
+      {
+        s_wakeup.notify_all();
+        break;
+      }
+    }
+
+    s_advancing = false;
+  }
+
+  /**
+   *  Parks the calling thread until it is released, either by simulation time
+   *  reaching the timeout or by another thread calling release() on it.
+   *
+   *  @param[in]  lock      Held lock on s_lock
+   *  @param[in]  self      Bookkeeping for the calling thread
+   *  @param[in]  timeoutUs How long to wait, or WAIT_FOREVER
+   *  @param[in]  order     Tie breaker against other threads waking at the same time
+   *  @return void
+   */
+  static void block( std::unique_lock<std::mutex> &lock, Sleeper &self, const uint64_t timeoutUs, const uint64_t order )
+  {
+    self.participant = s_isParticipant;
+    self.released    = false;
+    self.signalled   = false;
+    self.timed       = false;
+
+    if ( s_mode == Mode::REAL_TIME )
+    {
+      if ( timeoutUs == WAIT_FOREVER )
+      {
+        s_wakeup.wait( lock, [ &self ]() { return self.released; } );
+      }
+      else if ( !s_wakeup.wait_for( lock, std::chrono::microseconds( timeoutUs ), [ &self ]() { return self.released; } ) )
+      {
+        release( &self );
+      }
+
+      return;
+    }
+
+    /*------------------------------------------------
+    Register as idle until the wakeup time and give the
+    clock a chance to move if we were the last one awake.
+    ------------------------------------------------*/
+    if ( timeoutUs != WAIT_FOREVER )
+    {
+      self.entry = s_sleepers.emplace( SleepKey( s_virtualTime + timeoutUs, order ), &self ).first;
+      self.timed = true;
+    }
+
+    if ( self.participant )
+    {
+      s_blockedParticipants++;
+    }
+
+    tryAdvance( lock );
+    s_wakeup.wait( lock, [ &self ]() { return self.released; } );
+  }
+
+  /**
+   *  Executes queued events against the wall clock when running in real time mode
+   *
+   *  @return void
+   */
+  static void realTimeDispatcher()
+  {
+    std::unique_lock<std::mutex> lock( s_lock );
+
+    while ( true )
+    {
+      if ( s_events.empty() )
+      {
+        s_wakeup.wait( lock );
+        continue;
+      }
+
+      const uint64_t now = hostMicros();
+      if ( s_events.top().time > now )
+      {
+        s_wakeup.wait_for( lock, std::chrono::microseconds( s_events.top().time - now ) );
+        continue;
+      }
+
+      Event callback = s_events.top().callback;
+      s_events.pop();
+
+      lock.unlock();
+      callback();
+      lock.lock();
+    }
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  void setMode( const Mode mode )
+  {
+    std::lock_guard<std::mutex> lock( s_lock );
+    s_mode = mode;
+  }
+
+  Mode getMode()
+  {
+    std::lock_guard<std::mutex> lock( s_lock );
+    return s_mode;
+  }
+
+  size_t millis()
+  {
+    return static_cast<size_t>( micros() / 1000 );
+  }
+
+  uint64_t micros()
+  {
+    std::lock_guard<std::mutex> lock( s_lock );
+
+    if ( isVirtual() )
+    {
+      return s_virtualTime;
+    }
+
+    return hostMicros();
+  }
+
+  void delayMilliseconds( const size_t ms )
+  {
+    delayMicroseconds( static_cast<uint64_t>( ms ) * 1000 );
+  }
+
+  void delayMicroseconds( const uint64_t us )
+  {
+    std::unique_lock<std::mutex> lock( s_lock );
+
+    if ( s_mode == Mode::REAL_TIME )
+    {
+      lock.unlock();
+      std::this_thread::sleep_for( std::chrono::microseconds( us ) );
+      return;
+    }
+
+    Sleeper self;
+    block( lock, self, us, s_sleepOrder++ );
+  }
+
+  void schedule( const uint64_t delayUs, Event event )
+  {
+    std::unique_lock<std::mutex> lock( s_lock );
+
+    const uint64_t now = isVirtual() ? s_virtualTime : hostMicros();
+    s_events.push( { now + delayUs, s_eventOrder++, std::move( event ) } );
+
+    if ( ( s_mode == Mode::REAL_TIME ) && !s_dispatcherStarted )
+    {
+      s_dispatcherStarted = true;
+      std::thread( realTimeDispatcher ).detach();
+    }
+
+    s_wakeup.notify_all();
+  }
+
+  uint64_t attachParticipant()
+  {
+    std::lock_guard<std::mutex> lock( s_lock );
+    s_participants++;
+
+    return s_sleepOrder++;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Signal Implementation
+  -------------------------------------------------------------------------------*/
+  Signal::Signal() : mPending( false )
+  {
+  }
+
+  void Signal::notify()
+  {
+    std::unique_lock<std::mutex> lock( s_lock );
+
+    /*------------------------------------------------
+    Skip waiters that already timed out but haven't yet
+    had the chance to remove themselves from the list.
+    ------------------------------------------------*/
+    while ( !mWaiters.empty() )
+    {
+      Sleeper *waiter = mWaiters.front();
+      mWaiters.erase( mWaiters.begin() );
+
+      if ( waiter->released )
+      {
+        continue;
+      }
+
+      waiter->signalled = true;
+
+      if ( s_mode != Mode::DETERMINISTIC )
+      {
+        release( waiter );
+        s_wakeup.notify_all();
+        return;
+      }
+
+      /*------------------------------------------------
+      Waking the waiter right away would let it race the
+      notifier. Instead it joins the back of the line for
+      the current time and gets its turn from the clock.
+      ------------------------------------------------*/
+      if ( waiter->timed )
+      {
+        s_sleepers.erase( waiter->entry );
+      }
+
+      waiter->entry = s_sleepers.emplace( SleepKey( s_virtualTime, s_sleepOrder++ ), waiter ).first;
+      waiter->timed = true;
+
+      if ( !s_advancing )
+      {
+        tryAdvance( lock );
+      }
+
+      return;
+    }
+
+    mPending = true;
+  }
+
+  bool Signal::wait( const uint64_t timeoutUs )
+  {
+    std::unique_lock<std::mutex> lock( s_lock );
+
+    if ( mPending )
+    {
+      mPending = false;
+      return true;
+    }
+
+    Sleeper self;
+    mWaiters.push_back( &self );
+    block( lock, self, timeoutUs, s_sleepOrder++ );
+
+    if ( !self.signalled )
+    {
+      mWaiters.erase( std::remove( mWaiters.begin(), mWaiters.end(), &self ), mWaiters.end() );
+    }
+
+    return self.signalled;
+  }
+
+  /*-------------------------------------------------------------------------------
+  HoldScope Implementation
+  -------------------------------------------------------------------------------*/
+  HoldScope::HoldScope()
+  {
+    attachParticipant();
+  }
+
+  HoldScope::~HoldScope()
+  {
+    std::unique_lock<std::mutex> lock( s_lock );
+    s_participants--;
+
+    if ( isVirtual() )
+    {
+      tryAdvance( lock );
+    }
+  }
+
+  /*-------------------------------------------------------------------------------
+  ParticipantScope Implementation
+  -------------------------------------------------------------------------------*/
+  ParticipantScope::ParticipantScope( const uint64_t ticket )
+  {
+    s_isParticipant = true;
+
+    /*------------------------------------------------
+    New threads start in whatever order the OS likes.
+    Park until the clock gets to this thread's ticket.
+    ------------------------------------------------*/
+    std::unique_lock<std::mutex> lock( s_lock );
+
+    if ( s_mode == Mode::DETERMINISTIC )
+    {
+      Sleeper self;
+      block( lock, self, 0, ticket );
+    }
+  }
+
+  ParticipantScope::~ParticipantScope()
+  {
+    std::unique_lock<std::mutex> lock( s_lock );
+
+    s_isParticipant = false;
+    s_participants--;
+
+    if ( isVirtual() )
+    {
+      tryAdvance( lock );
+    }
+  }
+}    // namespace Sim::Clock
@@ -0,0 +1,215 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_clock.hpp
+ *
+ *  Description:
+ *    Simulation time source for the NetworkExplorer scenarios. Supports running
+ *    off the host wall clock or off a virtual clock driven by a discrete event
+ *    queue, where time only advances once every node thread is idle. The
+ *    deterministic variant also serializes node threads so that a run is
+ *    repeatable from one execution to the next.
+ *
+ *    Only code that takes its time from Sim::Clock follows these modes. The
+ *    RF24Node stack times itself with Chimera::millis() and
+ *    Chimera::delayMilliseconds(), which the Chimera sim backend still reads
+ *    from the host clock, so RF24::Endpoint always runs on wall time.
+ *    VIRTUAL_TIME and DETERMINISTIC are only meaningful for the Sim::*
+ *    models and harnesses that don't drive an endpoint. Anything running
+ *    endpoints stays on REAL_TIME.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_CLOCK_HPP
+#define RF24_SIM_CLOCK_HPP
+
+/* STL Includes */
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Sim::Clock
+{
+  /*-------------------------------------------------------------------------------
+  Forward Declarations
+  -------------------------------------------------------------------------------*/
+  struct Sleeper;
+
+  /*-------------------------------------------------------------------------------
+  Aliases
+  -------------------------------------------------------------------------------*/
+  using Event = std::function<void()>;
+
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint64_t WAIT_FOREVER = UINT64_MAX;
+
+  /*-------------------------------------------------------------------------------
+  Enumerations
+  -------------------------------------------------------------------------------*/
+  enum class Mode : uint8_t
+  {
+    REAL_TIME,    /**< Time follows the host wall clock */
+    VIRTUAL_TIME, /**< Time jumps to the next pending wakeup once all node threads are idle, Sim::* code only */
+    DETERMINISTIC /**< Virtual time, with node threads run one at a time in a fixed order, Sim::* code only */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Selects the time source. Must be called before any simulation threads
+   *  are created, as switching sources mid-run would corrupt every timestamp.
+   *
+   *  @param[in]  mode      The time source to use
+   *  @return void
+   */
+  void setMode( const Mode mode );
+
+  /**
+   *  Gets the currently selected time source
+   *
+   *  @return Mode
+   */
+  Mode getMode();
+
+  /**
+   *  Current simulation time in milliseconds
+   *
+   *  @return size_t
+   */
+  size_t millis();
+
+  /**
+   *  Current simulation time in microseconds
+   *
+   *  @return uint64_t
+   */
+  uint64_t micros();
+
+  /**
+   *  Blocks the calling thread for the given amount of simulation time. In
+   *  virtual mode, node threads calling this are considered idle and allow
+   *  the clock to advance.
+   *
+   *  @param[in]  ms        Milliseconds to delay
+   *  @return void
+   */
+  void delayMilliseconds( const size_t ms );
+
+  /**
+   *  Microsecond resolution variant of delayMilliseconds()
+   *
+   *  @param[in]  us        Microseconds to delay
+   *  @return void
+   */
+  void delayMicroseconds( const uint64_t us );
+
+  /**
+   *  Queues an event to execute once the given amount of simulation time has
+   *  elapsed. Events at the same timestamp execute in the order they were queued.
+   *
+   *  @note In virtual mode the event runs on whichever thread advanced the clock,
+   *        so it must not block on simulation time itself.
+   *
+   *  @param[in]  delayUs   Microseconds from now the event should fire
+   *  @param[in]  event     The callback to execute
+   *  @return void
+   */
+  void schedule( const uint64_t delayUs, Event event );
+
+  /**
+   *  Registers a new node thread with the clock. Prefer createThread(), which
+   *  handles registration before the thread is able to run.
+   *
+   *  @return uint64_t      Ticket fixing the thread's place in the run order
+   */
+  uint64_t attachParticipant();
+
+  /**
+   *  Marks the calling thread as a registered node thread for the duration
+   *  of its lifetime. Unregisters on destruction.
+   */
+  class ParticipantScope
+  {
+  public:
+    /**
+     *  @param[in]  ticket    Value returned by attachParticipant(). In deterministic
+     *                        mode the thread waits here until its turn comes up.
+     */
+    explicit ParticipantScope( const uint64_t ticket );
+    ~ParticipantScope();
+  };
+
+  /**
+   *  Freezes virtual time for as long as the scope exists. Without it, the
+   *  first node thread to go idle could advance the clock before its siblings
+   *  have even been created.
+   */
+  class HoldScope
+  {
+  public:
+    HoldScope();
+    ~HoldScope();
+  };
+
+  /**
+   *  Wakeup primitive that is aware of the simulation time source. A thread
+   *  waiting on a Signal counts as idle, so in virtual mode the clock keeps
+   *  moving while it waits. Notifications that arrive with nobody waiting are
+   *  latched and consumed by the next wait() call.
+   */
+  class Signal
+  {
+  public:
+    Signal();
+    ~Signal() = default;
+
+    /**
+     *  Wakes one waiting thread, or latches the notification if none are waiting
+     *
+     *  @return void
+     */
+    void notify();
+
+    /**
+     *  Blocks until notified or until the timeout expires in simulation time
+     *
+     *  @param[in]  timeoutUs Microseconds to wait, or WAIT_FOREVER
+     *  @return bool          True if notified, false on timeout
+     */
+    bool wait( const uint64_t timeoutUs );
+
+  private:
+    bool mPending;
+    std::vector<Sleeper *> mWaiters;
+  };
+
+  /**
+   *  Creates a node thread that the virtual clock waits on before advancing time.
+   *  Threads created with plain std::thread are treated as observers and never
+   *  hold back the clock.
+   *
+   *  @param[in]  fn        Thread entry function
+   *  @param[in]  args      Arguments to forward to the entry function
+   *  @return std::thread
+   */
+  template<typename Function, typename... Args>
+  std::thread createThread( Function &&fn, Args &&... args )
+  {
+    auto task = std::bind( std::forward<Function>( fn ), std::forward<Args>( args )... );
+
+    const uint64_t ticket = attachParticipant();
+    return std::thread( [ task, ticket ]() mutable {
+      ParticipantScope scope( ticket );
+      task();
+    } );
+  }
+}    // namespace Sim::Clock
+
+#endif /* !RF24_SIM_CLOCK_HPP */
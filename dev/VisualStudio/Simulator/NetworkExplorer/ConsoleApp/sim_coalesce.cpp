@@ -0,0 +1,270 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_coalesce.cpp
+ *
+ *  Description:
+ *    Small message coalescing implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <cstring>
+
+/* Chimera Includes */
+#include <Chimera/common>
+
+/* Dev Includes */
+#include <sim_clock.hpp>
+#include <sim_coalesce.hpp>
+
+namespace Sim::Coalesce
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t DefaultHoldTime = 5;
+  static constexpr size_t DefaultOpen     = 4;
+  static constexpr size_t DefaultPending  = 8;
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  Config defaultConfig()
+  {
+    Config cfg;
+
+    cfg.holdTimeMs = DefaultHoldTime;
+    cfg.maxOpen    = DefaultOpen;
+    cfg.maxPending = DefaultPending;
+
+    return cfg;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Packer Implementation
+  -------------------------------------------------------------------------------*/
+  Packer::Packer( RF24::Endpoint::Interface_sPtr device, const Config &cfg ) :
+      mDevice( device ), mConfig( cfg ), mStats{}
+  {
+    mConfig.maxOpen    = std::max<size_t>( mConfig.maxOpen, 1 );
+    mConfig.maxPending = std::max<size_t>( mConfig.maxPending, 1 );
+
+    mOpen.reserve( mConfig.maxOpen );
+  }
+
+  bool Packer::write( const RF24::LogicalAddress destination, const void *data, const size_t length )
+  {
+    if ( !data || !length || ( length > MAX_MESSAGE_SIZE ) )
+    {
+      return false;
+    }
+
+    auto iter = std::find_if( mOpen.begin(), mOpen.end(), [ destination ]( const Frame &frame ) {
+      return frame.destination == destination;
+    } );
+
+    /*------------------------------------------------
+    Starting a new frame, whether the old one is full or
+    a destination needs a slot, closes another one. Only
+    accept the message if there's room to queue that.
+    ------------------------------------------------*/
+    const bool fits = ( iter != mOpen.end() ) && ( ( iter->length + RECORD_SIZE + length ) <= FRAME_SIZE );
+    const bool full = ( iter == mOpen.end() ) ? ( mOpen.size() == mConfig.maxOpen ) : !fits;
+
+    if ( full && ( mClosed.size() >= mConfig.maxPending ) )
+    {
+      mStats.refused++;
+      return false;
+    }
+
+    if ( full )
+    {
+      mStats.framesFilled++;
+      close( ( iter != mOpen.end() ) ? static_cast<size_t>( iter - mOpen.begin() ) : 0 );
+      iter = mOpen.end();
+    }
+
+    if ( iter == mOpen.end() )
+    {
+      Frame frame;
+      frame.destination = destination;
+      frame.openedUs    = Clock::micros();
+      frame.length      = HEADER_SIZE;
+      frame.data[ 0 ]   = COALESCE_MAGIC;
+      frame.data[ 1 ]   = 0;
+
+      mOpen.push_back( frame );
+      iter = mOpen.end() - 1;
+    }
+
+    iter->data[ iter->length ] = static_cast<uint8_t>( length );
+    memcpy( &iter->data[ iter->length + RECORD_SIZE ], data, length );
+    iter->length += RECORD_SIZE + length;
+    iter->data[ 1 ]++;
+
+    /*------------------------------------------------
+    Nothing else could follow a message that leaves no
+    room for another, so don't make it wait.
+    ------------------------------------------------*/
+    if ( ( iter->length + RECORD_SIZE + 1 ) > FRAME_SIZE )
+    {
+      mStats.framesFilled++;
+      close( static_cast<size_t>( iter - mOpen.begin() ) );
+    }
+
+    mStats.messagesSent++;
+    return true;
+  }
+
+  size_t Packer::process()
+  {
+    /*------------------------------------------------
+    Frames open in order, so the oldest is always first
+    ------------------------------------------------*/
+    const uint64_t holdUs = static_cast<uint64_t>( mConfig.holdTimeMs ) * 1000;
+
+    while ( !mOpen.empty() && ( ( Clock::micros() - mOpen.front().openedUs ) >= holdUs ) )
+    {
+      mStats.framesExpired++;
+      close( 0 );
+    }
+
+    const size_t moved = drain();
+
+    while ( mDevice->packetAvailable() )
+    {
+      const size_t length = std::min( mDevice->nextPacketLength(), mFrame.size() );
+
+      if ( mDevice->read( mFrame.data(), length ) == Chimera::CommonStatusCodes::OK )
+      {
+        receive( mFrame.data(), length );
+      }
+    }
+
+    return moved;
+  }
+
+  void Packer::flush()
+  {
+    while ( !mOpen.empty() )
+    {
+      close( 0 );
+    }
+  }
+
+  bool Packer::available() const
+  {
+    return !mInbox.empty();
+  }
+
+  size_t Packer::nextLength() const
+  {
+    return mInbox.empty() ? 0 : mInbox.front().length;
+  }
+
+  bool Packer::read( void *const data, const size_t length )
+  {
+    if ( !data || mInbox.empty() || ( length < mInbox.front().length ) )
+    {
+      return false;
+    }
+
+    memcpy( data, mInbox.front().data.data(), mInbox.front().length );
+    mInbox.pop_front();
+    return true;
+  }
+
+  bool Packer::pendingTx() const
+  {
+    return !mClosed.empty();
+  }
+
+  uint64_t Packer::nextTimeoutUs() const
+  {
+    if ( mOpen.empty() )
+    {
+      return UINT64_MAX;
+    }
+
+    const uint64_t holdUs  = static_cast<uint64_t>( mConfig.holdTimeMs ) * 1000;
+    const uint64_t elapsed = Clock::micros() - mOpen.front().openedUs;
+
+    return ( elapsed >= holdUs ) ? 0 : ( holdUs - elapsed );
+  }
+
+  Stats Packer::getStats() const
+  {
+    return mStats;
+  }
+
+  void Packer::close( const size_t index )
+  {
+    mClosed.push_back( mOpen[ index ] );
+    mOpen.erase( mOpen.begin() + index );
+  }
+
+  size_t Packer::drain()
+  {
+    size_t moved = 0;
+
+    while ( !mClosed.empty() )
+    {
+      const Frame &frame = mClosed.front();
+      if ( mDevice->write( frame.destination, frame.data.data(), frame.length ) != Chimera::CommonStatusCodes::OK )
+      {
+        break;
+      }
+
+      mClosed.pop_front();
+      mStats.framesSent++;
+      moved++;
+    }
+
+    return moved;
+  }
+
+  void Packer::receive( const uint8_t *const frame, const size_t length )
+  {
+    if ( ( length < HEADER_SIZE ) || ( frame[ 0 ] != COALESCE_MAGIC ) )
+    {
+      mStats.rejected++;
+      return;
+    }
+
+    /*------------------------------------------------
+    Check the whole frame before unpacking any of it, so
+    a damaged one can't deliver half of its messages.
+    ------------------------------------------------*/
+    const size_t count = frame[ 1 ];
+    size_t offset      = HEADER_SIZE;
+
+    for ( size_t x = 0; x < count; x++ )
+    {
+      const size_t size = ( offset < length ) ? frame[ offset ] : 0;
+      if ( !size || ( size > MAX_MESSAGE_SIZE ) || ( ( offset + RECORD_SIZE + size ) > length ) )
+      {
+        mStats.rejected++;
+        return;
+      }
+
+      offset += RECORD_SIZE + size;
+    }
+
+    offset = HEADER_SIZE;
+    mStats.framesReceived++;
+
+    for ( size_t x = 0; x < count; x++ )
+    {
+      Message message;
+      message.length = frame[ offset ];
+      memcpy( message.data.data(), &frame[ offset + RECORD_SIZE ], message.length );
+
+      mInbox.push_back( message );
+      mStats.messagesReceived++;
+      offset += RECORD_SIZE + message.length;
+    }
+  }
+
+}    // namespace Sim::Coalesce
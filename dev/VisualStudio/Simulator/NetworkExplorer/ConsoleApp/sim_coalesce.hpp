@@ -0,0 +1,200 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_coalesce.hpp
+ *
+ *  Description:
+ *    Coalescing of small messages into shared frames. A sensor reading is
+ *    only a few bytes, yet each one costs a full frame, header and ACK on
+ *    every hop. A Packer sits on top of an endpoint and holds messages to the
+ *    same destination for a bounded time, packing as many as fit into one
+ *    frame, then splits them apart again on the receiving side.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_COALESCE_HPP
+#define RF24_SIM_COALESCE_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+#include <RF24Node/endpoint>
+
+/* Dev Includes */
+#include <sim_endpoint.hpp>
+
+namespace Sim::Coalesce
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint8_t COALESCE_MAGIC   = 0xC5; /**< First byte of every packed frame */
+  static constexpr size_t HEADER_SIZE       = 2;    /**< Magic and message count */
+  static constexpr size_t RECORD_SIZE       = 1;    /**< Length byte in front of each message */
+  static constexpr size_t FRAME_SIZE        = Endpoint::MAX_PAYLOAD_SIZE; /**< Bytes of a frame left after the network header */
+  static constexpr size_t MAX_MESSAGE_SIZE  = FRAME_SIZE - HEADER_SIZE - RECORD_SIZE;
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct Config
+  {
+    size_t holdTimeMs;    /**< Longest a message waits for company, 0 to send on the next process() */
+    size_t maxOpen;       /**< Destinations that may be collecting messages at once */
+    size_t maxPending;    /**< Packed frames that may wait for room on the endpoint */
+  };
+
+  struct Stats
+  {
+    size_t messagesSent;      /**< Messages accepted by write() */
+    size_t framesSent;        /**< Packed frames handed to the endpoint */
+    size_t framesFilled;      /**< Frames closed before the hold time, full or making way for another destination */
+    size_t framesExpired;     /**< Frames sent because the hold time ran out */
+    size_t messagesReceived;  /**< Messages unpacked from received frames */
+    size_t framesReceived;
+    size_t refused;           /**< Messages write() turned away because too many frames were pending */
+    size_t rejected;          /**< Frames that weren't valid packed frames */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Not thread safe. Every call must come from whichever thread is servicing
+   *  the endpoint, and the endpoint's RX data must only be read through here.
+   *  Every frame carries the packing header, even one holding a single
+   *  message, so both ends of a link have to use a Packer.
+   */
+  class Packer
+  {
+  public:
+    /**
+     *  @param[in]  device    Configured endpoint to send and receive through
+     *  @param[in]  cfg       Packer settings
+     */
+    Packer( RF24::Endpoint::Interface_sPtr device, const Config &cfg );
+
+    Packer( const Packer & ) = delete;
+    Packer &operator=( const Packer & ) = delete;
+
+    /**
+     *  Adds a message to the frame collecting for its destination. Nothing is
+     *  sent until the frame fills up or its hold time runs out, and then only
+     *  on the next call to process().
+     *
+     *  @param[in]  destination   Node to deliver the message to
+     *  @param[in]  data          Message to send
+     *  @param[in]  length        Bytes in the message, up to MAX_MESSAGE_SIZE
+     *  @return bool              True if the message was accepted
+     */
+    bool write( const RF24::LogicalAddress destination, const void *data, const size_t length );
+
+    /**
+     *  Closes frames whose hold time has run out, moves closed frames onto the
+     *  endpoint and unpacks newly received frames. Call it after every
+     *  Endpoint::doAsyncProcessing().
+     *
+     *  @return size_t        Frames handed to the endpoint
+     */
+    size_t process();
+
+    /**
+     *  Closes every collecting frame so it goes out on the next process(),
+     *  regardless of the hold time
+     */
+    void flush();
+
+    /**
+     *  Checks if an unpacked message is waiting
+     *
+     *  @return bool
+     */
+    bool available() const;
+
+    /**
+     *  Length of the next unpacked message
+     *
+     *  @return size_t        Zero if none is waiting
+     */
+    size_t nextLength() const;
+
+    /**
+     *  Copies out the next unpacked message
+     *
+     *  @param[out] data      Where to copy the message
+     *  @param[in]  length    Size of the buffer, must hold nextLength() bytes
+     *  @return bool          True if a message was read
+     */
+    bool read( void *const data, const size_t length );
+
+    /**
+     *  Checks if any closed frames are still waiting for room on the endpoint
+     *
+     *  @return bool
+     */
+    bool pendingTx() const;
+
+    /**
+     *  Time until the oldest collecting frame has to be sent
+     *
+     *  @return uint64_t      Microseconds, UINT64_MAX if nothing is collecting
+     */
+    uint64_t nextTimeoutUs() const;
+
+    /**
+     *  @return Stats
+     */
+    Stats getStats() const;
+
+  private:
+    struct Frame
+    {
+      RF24::LogicalAddress destination;
+      uint64_t openedUs;                    /**< When the first message went in */
+      size_t length;                        /**< Bytes used, header included */
+      std::array<uint8_t, FRAME_SIZE> data;
+    };
+
+    struct Message
+    {
+      size_t length;
+      std::array<uint8_t, MAX_MESSAGE_SIZE> data;
+    };
+
+    RF24::Endpoint::Interface_sPtr mDevice;
+    Config mConfig;
+    Stats mStats;
+    std::vector<Frame> mOpen;               /**< At most one collecting frame per destination */
+    std::deque<Frame> mClosed;              /**< Complete frames waiting for the endpoint */
+    std::deque<Message> mInbox;
+    std::array<uint8_t, FRAME_SIZE> mFrame;
+
+    void close( const size_t index );
+    size_t drain();
+    void receive( const uint8_t *const frame, const size_t length );
+  };
+
+  using Packer_uPtr = std::unique_ptr<Packer>;
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Settings that hold messages just long enough for a handful of readings
+   *  to share a frame
+   *
+   *  @return Config
+   */
+  Config defaultConfig();
+
+}    // namespace Sim::Coalesce
+
+#endif /* !RF24_SIM_COALESCE_HPP */
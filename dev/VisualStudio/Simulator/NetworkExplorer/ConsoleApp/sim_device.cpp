@@ -0,0 +1,624 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_device.cpp
+ *
+ *  Description:
+ *    NRF24L01+ register level emulator implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+/* Dev Includes */
+#include <sim_device.hpp>
+
+namespace Sim::Device
+{
+  using namespace Registers;
+
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint64_t NO_EVENT = std::numeric_limits<uint64_t>::max();
+
+  /**
+   *  Bits the host can change in each single byte register. STATUS is write
+   *  one to clear and the read only registers are handled on their own.
+   */
+  static constexpr std::array<uint8_t, NUM_REGISTERS> WRITE_MASK = {
+    0x7F, /* CONFIG */      0x3F, /* EN_AA */       0x3F, /* EN_RXADDR */   0x03, /* SETUP_AW */
+    0xFF, /* SETUP_RETR */  0x7F, /* RF_CH */       0xBE, /* RF_SETUP */    0x00, /* STATUS */
+    0x00, /* OBSERVE_TX */  0x00, /* RPD */         0xFF, /* RX_ADDR_P0 */  0xFF, /* RX_ADDR_P1 */
+    0xFF, /* RX_ADDR_P2 */  0xFF, /* RX_ADDR_P3 */  0xFF, /* RX_ADDR_P4 */  0xFF, /* RX_ADDR_P5 */
+    0xFF, /* TX_ADDR */     0x3F, /* RX_PW_P0 */    0x3F, /* RX_PW_P1 */    0x3F, /* RX_PW_P2 */
+    0x3F, /* RX_PW_P3 */    0x3F, /* RX_PW_P4 */    0x3F, /* RX_PW_P5 */    0x00, /* FIFO_STATUS */
+    0x00,                   0x00,                   0x00,                   0x00,
+    0x3F, /* DYNPD */       0x07  /* FEATURE */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  Config defaultConfig()
+  {
+    Config cfg;
+    cfg.spiClockHz            = 8000000;
+    cfg.transactionOverheadNs = 0;
+
+    return cfg;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Emulator Implementation
+  -------------------------------------------------------------------------------*/
+  Emulator::Emulator( const Config &cfg ) : mConfig( cfg ), mNowNs( 0 ), mTotals{}
+  {
+    mConfig.spiClockHz = std::max<uint32_t>( mConfig.spiClockHz, 1 );
+    reset();
+  }
+
+  void Emulator::transfer( const uint8_t *const tx, uint8_t *const rx, const size_t length )
+  {
+    if ( !tx || !rx || !length )
+    {
+      return;
+    }
+
+    /*------------------------------------------------
+    Charge the bus time to the innermost operation
+    ------------------------------------------------*/
+    const uint64_t busNs =
+        mConfig.transactionOverheadNs + ( ( length * 8000000000ull ) + mConfig.spiClockHz - 1 ) / mConfig.spiClockHz;
+
+    mTotals.transactions++;
+    mTotals.bytes += length;
+    mTotals.busTimeNs += busNs;
+
+    if ( !mOperations.empty() )
+    {
+      BusStats &bus = mProfile[ mOperations.back() ].bus;
+      bus.transactions++;
+      bus.bytes += length;
+      bus.busTimeNs += busNs;
+    }
+
+    /*------------------------------------------------
+    STATUS shifts out with the command byte. The command
+    itself takes effect once CSN rises at the end.
+    ------------------------------------------------*/
+    const std::vector<uint8_t> in( tx, tx + length );
+    const uint8_t cmd     = in[ 0 ];
+    const size_t argBytes = length - 1;
+
+    memset( rx, 0, length );
+    rx[ 0 ] = status();
+
+    runUntil( mNowNs + busNs );
+
+    if ( cmd <= ( CMD_R_REGISTER | CMD_REGISTER_MASK ) )
+    {
+      readRegister( cmd & CMD_REGISTER_MASK, rx + 1, std::min( argBytes, MAX_REGISTER_WIDTH ) );
+    }
+    else if ( cmd <= ( CMD_W_REGISTER | CMD_REGISTER_MASK ) )
+    {
+      writeRegister( cmd & CMD_REGISTER_MASK, in.data() + 1, std::min( argBytes, MAX_REGISTER_WIDTH ) );
+    }
+    else if ( cmd == CMD_R_RX_PL_WID )
+    {
+      if ( argBytes )
+      {
+        rx[ 1 ] = mRxFifo.empty() ? 0 : static_cast<uint8_t>( mRxFifo.front().length );
+      }
+    }
+    else if ( cmd == CMD_R_RX_PAYLOAD )
+    {
+      if ( !mRxFifo.empty() )
+      {
+        memcpy( rx + 1, mRxFifo.front().data.data(), std::min( argBytes, mRxFifo.front().length ) );
+        mRxFifo.pop_front();
+      }
+    }
+    else if ( ( cmd == CMD_W_TX_PAYLOAD ) || ( cmd == CMD_W_TX_PAYLOAD_NOACK ) ||
+              ( ( cmd >= CMD_W_ACK_PAYLOAD ) && ( cmd < ( CMD_W_ACK_PAYLOAD + NUM_PIPES ) ) ) )
+    {
+      const uint8_t feature = mRegs[ REG_FEATURE ][ 0 ];
+      const bool ack        = ( cmd & 0xF8 ) == CMD_W_ACK_PAYLOAD;
+
+      /*------------------------------------------------
+      Commands whose feature is off, or a full FIFO,
+      leave the radio untouched
+      ------------------------------------------------*/
+      if ( ( mTxFifo.size() < FIFO_DEPTH ) && argBytes &&
+           ( !ack || ( feature & FEATURE_EN_ACK_PAY ) ) &&
+           ( ( cmd != CMD_W_TX_PAYLOAD_NOACK ) || ( feature & FEATURE_EN_DYN_ACK ) ) )
+      {
+        Payload payload{};
+        payload.pipe   = ack ? ( cmd & 0x07 ) : 0;
+        payload.ack    = ack;
+        payload.noAck  = ( cmd == CMD_W_TX_PAYLOAD_NOACK );
+        payload.length = std::min( argBytes, MAX_PAYLOAD_WIDTH );
+        memcpy( payload.data.data(), in.data() + 1, payload.length );
+
+        mTxFifo.push_back( payload );
+        mReuse = mReuse && ack;
+      }
+    }
+    else if ( cmd == CMD_FLUSH_TX )
+    {
+      mTxFifo.clear();
+      mReuse = false;
+    }
+    else if ( cmd == CMD_FLUSH_RX )
+    {
+      mRxFifo.clear();
+    }
+    else if ( cmd == CMD_REUSE_TX_PL )
+    {
+      mReuse = true;
+    }
+
+    runUntil( mNowNs );
+  }
+
+  void Emulator::setCE( const bool level )
+  {
+    runUntil( mNowNs );
+
+    /*------------------------------------------------
+    A rising edge only starts something if the radio can
+    act on it right away, it isn't remembered
+    ------------------------------------------------*/
+    mTrigger = level && !mCE;
+    mCE      = level;
+
+    runUntil( mNowNs );
+    mTrigger = false;
+  }
+
+  void Emulator::advance( const uint64_t us )
+  {
+    runUntil( mNowNs + ( us * 1000 ) );
+  }
+
+  bool Emulator::receive( const uint8_t pipe, const void *const data, const size_t length, const bool noAck )
+  {
+    runUntil( mNowNs );
+
+    if ( !data || ( pipe >= NUM_PIPES ) || ( mMode != Mode::RX ) || !( mRegs[ REG_EN_RXADDR ][ 0 ] & ( 1u << pipe ) ) )
+    {
+      return false;
+    }
+
+    /*------------------------------------------------
+    A full RX FIFO drops the frame without an ACK, so the
+    sender will try again
+    ------------------------------------------------*/
+    const size_t width = dynamicPayloads( pipe ) ? std::min( length, MAX_PAYLOAD_WIDTH ) : mRegs[ REG_RX_PW_P0 + pipe ][ 0 ];
+
+    if ( !width || ( mRxFifo.size() >= FIFO_DEPTH ) )
+    {
+      return false;
+    }
+
+    Payload payload{};
+    payload.pipe   = pipe;
+    payload.noAck  = noAck;
+    payload.length = width;
+    memcpy( payload.data.data(), data, std::min( length, width ) );
+
+    mRxFifo.push_back( payload );
+    mRegs[ REG_STATUS ][ 0 ] |= STATUS_RX_DR;
+
+    /*------------------------------------------------
+    Sending an ACK payload sets TX_DS on the receiver
+    ------------------------------------------------*/
+    if ( !noAck && ( mRegs[ REG_EN_AA ][ 0 ] & ( 1u << pipe ) ) && ( mRegs[ REG_FEATURE ][ 0 ] & FEATURE_EN_ACK_PAY ) )
+    {
+      auto ackPayload = std::find_if( mTxFifo.begin(), mTxFifo.end(),
+                                      [ pipe ]( const Payload &item ) { return item.ack && ( item.pipe == pipe ); } );
+
+      if ( ackPayload != mTxFifo.end() )
+      {
+        mTxFifo.erase( ackPayload );
+        mRegs[ REG_STATUS ][ 0 ] |= STATUS_TX_DS;
+      }
+    }
+
+    return true;
+  }
+
+  bool Emulator::irqAsserted() const
+  {
+    /* The MASK_ bits in CONFIG sit at the same positions as the flags they mask */
+    return ( mRegs[ REG_STATUS ][ 0 ] & STATUS_IRQ_FLAGS & ~mRegs[ REG_CONFIG ][ 0 ] ) != 0;
+  }
+
+  Mode Emulator::mode() const
+  {
+    return mMode;
+  }
+
+  uint64_t Emulator::micros() const
+  {
+    return mNowNs / 1000;
+  }
+
+  void Emulator::setLinkHook( LinkHook hook )
+  {
+    mLinkHook = std::move( hook );
+  }
+
+  void Emulator::beginOperation( const std::string &name )
+  {
+    mOperations.push_back( name );
+    mProfile[ name ].calls++;
+  }
+
+  void Emulator::endOperation()
+  {
+    if ( !mOperations.empty() )
+    {
+      mOperations.pop_back();
+    }
+  }
+
+  BusStats Emulator::getTotals() const
+  {
+    return mTotals;
+  }
+
+  std::map<std::string, OperationStats> Emulator::getProfile() const
+  {
+    return mProfile;
+  }
+
+  void Emulator::reset()
+  {
+    /*------------------------------------------------
+    Power on reset values from the datasheet
+    ------------------------------------------------*/
+    for ( auto &reg : mRegs )
+    {
+      reg.fill( 0 );
+    }
+
+    mRegs[ REG_CONFIG ][ 0 ]     = CONFIG_EN_CRC;
+    mRegs[ REG_EN_AA ][ 0 ]      = 0x3F;
+    mRegs[ REG_EN_RXADDR ][ 0 ]  = 0x03;
+    mRegs[ REG_SETUP_AW ][ 0 ]   = 0x03;
+    mRegs[ REG_SETUP_RETR ][ 0 ] = 0x03;
+    mRegs[ REG_RF_CH ][ 0 ]      = 0x02;
+    mRegs[ REG_RF_SETUP ][ 0 ]   = 0x0E;
+    mRegs[ REG_RX_ADDR_P0 ].fill( 0xE7 );
+    mRegs[ REG_RX_ADDR_P1 ].fill( 0xC2 );
+    mRegs[ REG_RX_ADDR_P2 ][ 0 ] = 0xC3;
+    mRegs[ REG_RX_ADDR_P3 ][ 0 ] = 0xC4;
+    mRegs[ REG_RX_ADDR_P4 ][ 0 ] = 0xC5;
+    mRegs[ REG_RX_ADDR_P5 ][ 0 ] = 0xC6;
+    mRegs[ REG_TX_ADDR ].fill( 0xE7 );
+
+    mTxFifo.clear();
+    mRxFifo.clear();
+
+    mMode         = Mode::POWER_DOWN;
+    mCE           = false;
+    mTrigger      = false;
+    mReuse        = false;
+    mEventNs      = NO_EVENT;
+    mAttempt      = 0;
+    mAttemptAcked = false;
+  }
+
+  void Emulator::runUntil( const uint64_t targetNs )
+  {
+    evaluate();
+
+    while ( ( mEventNs != NO_EVENT ) && ( mEventNs <= targetNs ) )
+    {
+      mNowNs   = mEventNs;
+      mEventNs = NO_EVENT;
+
+      onEvent();
+      evaluate();
+    }
+
+    mNowNs = std::max( mNowNs, targetNs );
+  }
+
+  void Emulator::evaluate()
+  {
+    /*------------------------------------------------
+    Apply transitions that don't take time until the
+    state machine comes to rest
+    ------------------------------------------------*/
+    Mode previous;
+
+    do
+    {
+      previous            = mMode;
+      const uint8_t config = mRegs[ REG_CONFIG ][ 0 ];
+
+      if ( !( config & CONFIG_PWR_UP ) )
+      {
+        /* A packet in flight is abandoned, its payload stays in the FIFO */
+        mMode    = Mode::POWER_DOWN;
+        mEventNs = NO_EVENT;
+        continue;
+      }
+
+      switch ( mMode )
+      {
+        case Mode::POWER_DOWN:
+          mMode    = Mode::START_UP;
+          mEventNs = mNowNs + ( POWER_UP_US * 1000 );
+          break;
+
+        case Mode::STANDBY:
+          if ( config & CONFIG_PRIM_RX )
+          {
+            if ( mCE )
+            {
+              mMode    = Mode::RX_SETTLING;
+              mEventNs = mNowNs + ( SETTLE_US * 1000 );
+            }
+          }
+          else if ( ( mCE || mTrigger ) && !( mRegs[ REG_STATUS ][ 0 ] & STATUS_MAX_RT ) && ( nextTxPayload() != mTxFifo.end() ) )
+          {
+            mTrigger = false;
+            mAttempt = 0;
+            startAttempt();
+          }
+          break;
+
+        case Mode::RX_SETTLING:
+        case Mode::RX:
+          if ( !mCE || !( config & CONFIG_PRIM_RX ) )
+          {
+            mMode    = Mode::STANDBY;
+            mEventNs = NO_EVENT;
+          }
+          break;
+
+        default:
+          break;
+      }
+    } while ( mMode != previous );
+  }
+
+  void Emulator::onEvent()
+  {
+    switch ( mMode )
+    {
+      case Mode::START_UP:
+        mMode = Mode::STANDBY;
+        break;
+
+      case Mode::RX_SETTLING:
+        mMode = Mode::RX;
+        break;
+
+      case Mode::TX:
+        finishPacket();
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  void Emulator::startAttempt()
+  {
+    /*------------------------------------------------
+    Every attempt settles the PLL first. The outcome is
+    decided up front so the attempt can end at the
+    right moment: after the ACK came back, or after the
+    retransmit delay ran out without one.
+    ------------------------------------------------*/
+    const Payload &payload = *nextTxPayload();
+    const bool expectAck   = ( mRegs[ REG_EN_AA ][ 0 ] & 0x01 ) && !payload.noAck;
+
+    mAttempt++;
+    const bool acked = mLinkHook ? mLinkHook( payload, mAttempt ) : true;
+    mAttemptAcked    = !expectAck || acked;
+
+    uint64_t durationNs = ( SETTLE_US * 1000 ) + airtimeNs( payload.length );
+
+    if ( expectAck && acked )
+    {
+      durationNs += ( SETTLE_US * 1000 ) + airtimeNs( 0 );
+    }
+    else if ( expectAck )
+    {
+      durationNs += ( ( mRegs[ REG_SETUP_RETR ][ 0 ] >> 4 ) + 1 ) * ARD_STEP_US * 1000;
+    }
+
+    mMode    = Mode::TX;
+    mEventNs = mNowNs + durationNs;
+  }
+
+  void Emulator::finishPacket()
+  {
+    uint8_t &observe = mRegs[ REG_OBSERVE_TX ][ 0 ];
+    observe          = static_cast<uint8_t>( ( observe & 0xF0 ) | std::min<size_t>( mAttempt - 1, 0x0F ) );
+
+    auto payload = nextTxPayload();
+    if ( payload == mTxFifo.end() )
+    {
+      /* Flushed mid packet */
+      mMode = Mode::STANDBY;
+      return;
+    }
+
+    if ( mAttemptAcked )
+    {
+      mRegs[ REG_STATUS ][ 0 ] |= STATUS_TX_DS;
+
+      if ( !mReuse )
+      {
+        mTxFifo.erase( payload );
+      }
+
+      mMode = Mode::STANDBY;
+    }
+    else if ( ( mAttempt - 1 ) < ( mRegs[ REG_SETUP_RETR ][ 0 ] & 0x0F ) )
+    {
+      startAttempt();
+    }
+    else
+    {
+      /*------------------------------------------------
+      PLOS_CNT saturates at 15 and only resets when RF_CH
+      is written
+      ------------------------------------------------*/
+      mRegs[ REG_STATUS ][ 0 ] |= STATUS_MAX_RT;
+      observe = static_cast<uint8_t>( ( std::min( ( observe >> 4 ) + 1, 0x0F ) << 4 ) | ( observe & 0x0F ) );
+      mMode   = Mode::STANDBY;
+    }
+  }
+
+  uint8_t Emulator::status() const
+  {
+    const uint8_t pipe = mRxFifo.empty() ? 0x07 : mRxFifo.front().pipe;
+    const uint8_t full = ( mTxFifo.size() >= FIFO_DEPTH ) ? STATUS_TX_FULL : 0;
+
+    return ( mRegs[ REG_STATUS ][ 0 ] & STATUS_IRQ_FLAGS ) | static_cast<uint8_t>( pipe << 1 ) | full;
+  }
+
+  uint8_t Emulator::fifoStatus() const
+  {
+    uint8_t value = mReuse ? FIFO_STATUS_TX_REUSE : 0;
+
+    value |= ( mTxFifo.size() >= FIFO_DEPTH ) ? FIFO_STATUS_TX_FULL : 0;
+    value |= mTxFifo.empty() ? FIFO_STATUS_TX_EMPTY : 0;
+    value |= ( mRxFifo.size() >= FIFO_DEPTH ) ? FIFO_STATUS_RX_FULL : 0;
+    value |= mRxFifo.empty() ? FIFO_STATUS_RX_EMPTY : 0;
+
+    return value;
+  }
+
+  size_t Emulator::addressWidth() const
+  {
+    /* SETUP_AW of 0 is illegal, treat it like the narrowest width */
+    return std::max<size_t>( mRegs[ REG_SETUP_AW ][ 0 ] & 0x03, 1 ) + 2;
+  }
+
+  uint64_t Emulator::airtimeNs( const size_t length ) const
+  {
+    /*------------------------------------------------
+    Auto acknowledge forces the CRC on
+    ------------------------------------------------*/
+    const uint8_t config = mRegs[ REG_CONFIG ][ 0 ];
+    size_t crcBytes      = 0;
+
+    if ( ( config & CONFIG_EN_CRC ) || mRegs[ REG_EN_AA ][ 0 ] )
+    {
+      crcBytes = ( config & CONFIG_CRCO ) ? 2 : 1;
+    }
+
+    const uint64_t bits   = ( 8 * ( PREAMBLE_BYTES + addressWidth() + length + crcBytes ) ) + PCF_BITS;
+    const uint8_t rfSetup = mRegs[ REG_RF_SETUP ][ 0 ];
+
+    if ( rfSetup & RF_SETUP_RF_DR_LOW )
+    {
+      return bits * 4000;
+    }
+    else if ( rfSetup & RF_SETUP_RF_DR_HIGH )
+    {
+      return bits * 500;
+    }
+
+    return bits * 1000;
+  }
+
+  bool Emulator::dynamicPayloads( const uint8_t pipe ) const
+  {
+    return ( mRegs[ REG_FEATURE ][ 0 ] & FEATURE_EN_DPL ) && ( mRegs[ REG_DYNPD ][ 0 ] & ( 1u << pipe ) );
+  }
+
+  std::deque<Payload>::iterator Emulator::nextTxPayload()
+  {
+    return std::find_if( mTxFifo.begin(), mTxFifo.end(), []( const Payload &item ) { return !item.ack; } );
+  }
+
+  void Emulator::readRegister( const uint8_t reg, uint8_t *const data, const size_t length )
+  {
+    if ( reg == REG_STATUS )
+    {
+      data[ 0 ] = status();
+      return;
+    }
+    else if ( reg == REG_FIFO_STATUS )
+    {
+      data[ 0 ] = fifoStatus();
+      return;
+    }
+
+    const size_t width = widthOf( reg, addressWidth() );
+    memcpy( data, mRegs[ reg ].data(), std::min( length, width ) );
+  }
+
+  void Emulator::writeRegister( const uint8_t reg, const uint8_t *const data, const size_t length )
+  {
+    if ( !length || ( reg >= NUM_REGISTERS ) )
+    {
+      return;
+    }
+
+    switch ( reg )
+    {
+      case REG_STATUS:
+        mRegs[ REG_STATUS ][ 0 ] &= ~( data[ 0 ] & STATUS_IRQ_FLAGS );
+        break;
+
+      case REG_RX_ADDR_P0:
+      case REG_RX_ADDR_P1:
+      case REG_TX_ADDR:
+        memcpy( mRegs[ reg ].data(), data, std::min( length, addressWidth() ) );
+        break;
+
+      case REG_RF_CH:
+        mRegs[ REG_RF_CH ][ 0 ] = data[ 0 ] & WRITE_MASK[ REG_RF_CH ];
+        mRegs[ REG_OBSERVE_TX ][ 0 ] &= 0x0F;
+        break;
+
+      default:
+        mRegs[ reg ][ 0 ] = static_cast<uint8_t>( ( mRegs[ reg ][ 0 ] & ~WRITE_MASK[ reg ] ) | ( data[ 0 ] & WRITE_MASK[ reg ] ) );
+        break;
+    }
+  }
+
+  /*-------------------------------------------------------------------------------
+  RegisterBus Implementation
+  -------------------------------------------------------------------------------*/
+  RegisterBus::RegisterBus( Emulator &device ) : mDevice( device )
+  {
+  }
+
+  void RegisterBus::readRegister( const uint8_t reg, uint8_t *const data, const size_t length )
+  {
+    std::array<uint8_t, MAX_REGISTER_WIDTH + 1> buffer;
+    const size_t bytes = std::min( length, MAX_REGISTER_WIDTH );
+
+    buffer.fill( CMD_NOP );
+    buffer[ 0 ] = CMD_R_REGISTER | ( reg & CMD_REGISTER_MASK );
+
+    mDevice.transfer( buffer.data(), buffer.data(), bytes + 1 );
+    memcpy( data, buffer.data() + 1, bytes );
+  }
+
+  void RegisterBus::writeRegister( const uint8_t reg, const uint8_t *const data, const size_t length )
+  {
+    std::array<uint8_t, MAX_REGISTER_WIDTH + 1> buffer;
+    const size_t bytes = std::min( length, MAX_REGISTER_WIDTH );
+
+    buffer[ 0 ] = CMD_W_REGISTER | ( reg & CMD_REGISTER_MASK );
+    memcpy( buffer.data() + 1, data, bytes );
+
+    mDevice.transfer( buffer.data(), buffer.data(), bytes + 1 );
+  }
+
+}    // namespace Sim::Device
@@ -0,0 +1,284 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_device.hpp
+ *
+ *  Description:
+ *    Register level emulation of an NRF24L01+ as seen from the SPI bus. The
+ *    register map, the 3-deep TX and RX FIFOs, the status and FIFO bits and
+ *    the CE driven state machine follow the datasheet, including its power
+ *    up, settling and retransmit timing. Every SPI transaction is counted
+ *    and costs simulated bus time, attributed to whichever driver operation
+ *    is running, so driver changes can be profiled on the host without a
+ *    radio attached.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_DEVICE_HPP
+#define RF24_SIM_DEVICE_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/* Dev Includes */
+#include <sim_registers.hpp>
+
+namespace Sim::Device
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t FIFO_DEPTH          = 3;
+  static constexpr size_t MAX_PAYLOAD_WIDTH   = 32;
+  static constexpr size_t NUM_PIPES           = 6;
+  static constexpr uint64_t POWER_UP_US       = 1500; /**< Tpd2stby, power down to standby with the crystal starting */
+  static constexpr uint64_t SETTLE_US         = 130;  /**< Tstby2a, standby to TX or RX */
+  static constexpr uint64_t ARD_STEP_US       = 250;  /**< Auto retransmit delay resolution */
+  static constexpr size_t PCF_BITS            = 9;    /**< Packet control field of an Enhanced ShockBurst frame */
+  static constexpr size_t PREAMBLE_BYTES      = 1;
+
+  /*-------------------------------------------------------------------------------
+  Enumerations
+  -------------------------------------------------------------------------------*/
+  enum class Mode : uint8_t
+  {
+    POWER_DOWN,
+    START_UP,    /**< PWR_UP was set, waiting on the crystal */
+    STANDBY,     /**< Standby-I, or Standby-II with CE high and nothing to send */
+    RX_SETTLING,
+    RX,
+    TX           /**< Sending a packet, waiting on its ACK or the retransmit delay */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct Config
+  {
+    uint32_t spiClockHz;              /**< SCK frequency */
+    uint32_t transactionOverheadNs;   /**< CSN setup/hold and driver call cost added to each transaction */
+  };
+
+  struct BusStats
+  {
+    size_t transactions; /**< CSN low to CSN high */
+    size_t bytes;        /**< Bytes clocked in either direction, command byte included */
+    uint64_t busTimeNs;  /**< Time the bus was busy with those transactions */
+  };
+
+  struct OperationStats
+  {
+    size_t calls;
+    BusStats bus;
+  };
+
+  struct Payload
+  {
+    uint8_t pipe;   /**< Pipe a received payload arrived on, or an ACK payload goes out on */
+    bool ack;       /**< Written with W_ACK_PAYLOAD, waits for a frame on its pipe */
+    bool noAck;     /**< Sent with W_TX_PAYLOAD_NOACK */
+    size_t length;
+    std::array<uint8_t, MAX_PAYLOAD_WIDTH> data;
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Decides the fate of each transmission attempt, standing in for the radio
+   *  on the other end. Returns true if the attempt was acknowledged.
+   *
+   *  @param[in]  payload     What went out on the air
+   *  @param[in]  attempt     1 for the first transmission, counting up with every retransmit
+   */
+  using LinkHook = std::function<bool( const Payload &payload, const size_t attempt )>;
+
+  /**
+   *  Not thread safe. The emulator keeps its own clock, which moves forward
+   *  with every SPI transaction and with advance(), so runs are exactly
+   *  repeatable. Without a link hook every transmission is acknowledged on
+   *  the first attempt.
+   */
+  class Emulator
+  {
+  public:
+    /**
+     *  @param[in]  cfg       SPI bus settings
+     */
+    explicit Emulator( const Config &cfg );
+
+    Emulator( const Emulator & ) = delete;
+    Emulator &operator=( const Emulator & ) = delete;
+
+    /**
+     *  Performs one SPI transaction, from CSN going low until it goes high
+     *  again. The first byte is the command, and the first byte shifted back
+     *  is always STATUS.
+     *
+     *  @param[in]  tx        Bytes clocked into the radio
+     *  @param[out] rx        Bytes clocked out of the radio, may be the same buffer as tx
+     *  @param[in]  length    Bytes in the transaction
+     *  @return void
+     */
+    void transfer( const uint8_t *const tx, uint8_t *const rx, const size_t length );
+
+    /**
+     *  Drives the CE pin. A rising edge in standby starts one transmission,
+     *  holding it high keeps sending while the TX FIFO has payloads, or keeps
+     *  the receiver on when PRIM_RX is set.
+     *
+     *  @param[in]  level     New pin state
+     *  @return void
+     */
+    void setCE( const bool level );
+
+    /**
+     *  Lets time pass without bus activity, e.g. a driver busy waiting
+     *
+     *  @param[in]  us        Microseconds to advance
+     *  @return void
+     */
+    void advance( const uint64_t us );
+
+    /**
+     *  A frame arriving over the air on one of the pipes. It is only taken
+     *  if the receiver is on, the pipe is enabled and the RX FIFO has room.
+     *  An ACK payload queued for the pipe goes out with the ACK.
+     *
+     *  @param[in]  pipe      Pipe the frame is addressed to
+     *  @param[in]  data      Payload
+     *  @param[in]  length    Payload bytes. Without dynamic payloads RX_PW_Px bytes are stored instead.
+     *  @param[in]  noAck     The sender asked for no ACK
+     *  @return bool          True if the frame was received
+     */
+    bool receive( const uint8_t pipe, const void *const data, const size_t length, const bool noAck = false );
+
+    /**
+     *  Level of the active low IRQ pin
+     *
+     *  @return bool          True while an unmasked interrupt flag is set
+     */
+    bool irqAsserted() const;
+
+    /**
+     *  @return Mode          Current state of the radio's state machine
+     */
+    Mode mode() const;
+
+    /**
+     *  @return uint64_t      Emulator time in microseconds
+     */
+    uint64_t micros() const;
+
+    /**
+     *  Sets what answers each transmission attempt
+     *
+     *  @param[in]  hook      Link model, or an empty function to ACK everything
+     *  @return void
+     */
+    void setLinkHook( LinkHook hook );
+
+    /**
+     *  Attributes bus activity to a named driver operation until the matching
+     *  endOperation(). Operations nest, the innermost one is charged.
+     *
+     *  @param[in]  name      Operation to charge
+     *  @return void
+     */
+    void beginOperation( const std::string &name );
+
+    /**
+     *  Stops charging the innermost operation
+     *
+     *  @return void
+     */
+    void endOperation();
+
+    /**
+     *  @return BusStats      Everything since creation
+     */
+    BusStats getTotals() const;
+
+    /**
+     *  @return Per operation statistics, bus activity outside any operation is only in the totals
+     */
+    std::map<std::string, OperationStats> getProfile() const;
+
+  private:
+    Config mConfig;
+    Mode mMode;
+    bool mCE;
+    bool mTrigger;           /**< CE rising edge not yet acted on */
+    bool mReuse;             /**< REUSE_TX_PL is active */
+    uint64_t mNowNs;
+    uint64_t mEventNs;       /**< When the current mode's timed transition happens */
+
+    std::array<std::array<uint8_t, Registers::MAX_REGISTER_WIDTH>, Registers::NUM_REGISTERS> mRegs;
+    std::deque<Payload> mTxFifo;
+    std::deque<Payload> mRxFifo;
+
+    LinkHook mLinkHook;
+    size_t mAttempt;
+    bool mAttemptAcked;
+
+    BusStats mTotals;
+    std::vector<std::string> mOperations;
+    std::map<std::string, OperationStats> mProfile;
+
+    void reset();
+    void runUntil( const uint64_t targetNs );
+    void evaluate();
+    void onEvent();
+    void startAttempt();
+    void finishPacket();
+    uint8_t status() const;
+    uint8_t fifoStatus() const;
+    size_t addressWidth() const;
+    uint64_t airtimeNs( const size_t length ) const;
+    bool dynamicPayloads( const uint8_t pipe ) const;
+    std::deque<Payload>::iterator nextTxPayload();
+    void readRegister( const uint8_t reg, uint8_t *const data, const size_t length );
+    void writeRegister( const uint8_t reg, const uint8_t *const data, const size_t length );
+  };
+
+  /**
+   *  Register accessors carried over the emulated SPI bus, one transaction
+   *  per access. Lets a Registers::Shadow be profiled against the device.
+   */
+  class RegisterBus : public Registers::Bus
+  {
+  public:
+    /**
+     *  @param[in]  device    Emulator to send the transactions to
+     */
+    explicit RegisterBus( Emulator &device );
+
+    void readRegister( const uint8_t reg, uint8_t *const data, const size_t length ) override;
+    void writeRegister( const uint8_t reg, const uint8_t *const data, const size_t length ) override;
+
+  private:
+    Emulator &mDevice;
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  An 8MHz bus with no per transaction overhead, so the statistics show pure
+   *  wire time
+   *
+   *  @return Config
+   */
+  Config defaultConfig();
+
+}    // namespace Sim::Device
+
+#endif /* !RF24_SIM_DEVICE_HPP */
@@ -0,0 +1,34 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_endpoint.hpp
+ *
+ *  Description:
+ *    Limits of what an application can hand to RF24::Endpoint::write() in a
+ *    single frame. The network layer puts its own header in front of every
+ *    payload, so only part of the radio's MAX_PAYLOAD_WIDTH is left for the
+ *    layers built on top of the endpoint.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_ENDPOINT_HPP
+#define RF24_SIM_ENDPOINT_HPP
+
+/* STL Includes */
+#include <cstddef>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+
+namespace Sim::Endpoint
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t FRAME_HEADER_SIZE = 8; /**< Network header RF24Node adds to every frame */
+  static constexpr size_t MAX_PAYLOAD_SIZE  = RF24::Hardware::MAX_PAYLOAD_WIDTH - FRAME_HEADER_SIZE;
+
+}    // namespace Sim::Endpoint
+
+#endif /* !RF24_SIM_ENDPOINT_HPP */
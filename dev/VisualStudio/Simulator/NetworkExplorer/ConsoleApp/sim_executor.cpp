@@ -0,0 +1,374 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_executor.cpp
+ *
+ *  Description:
+ *    Endpoint executor implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* Dev Includes */
+#include <sim_executor.hpp>
+
+namespace Sim
+{
+  /*-------------------------------------------------------------------------------
+  Private Data
+  -------------------------------------------------------------------------------*/
+  static thread_local NodeId s_activeNode = INVALID_NODE;
+
+  /*-------------------------------------------------------------------------------
+  Executor Implementation
+  -------------------------------------------------------------------------------*/
+  Executor::Executor( const ExecutorConfig &cfg ) : mConfig( cfg ), mRunning( false )
+  {
+    if ( mConfig.workers == 0 )
+    {
+      mConfig.workers = 1;
+    }
+
+    for ( size_t x = 0; x < mConfig.workers; x++ )
+    {
+      mWorkers.push_back( std::make_unique<Worker>() );
+    }
+  }
+
+  Executor::~Executor()
+  {
+    stop();
+  }
+
+  NodeId Executor::addNode( RF24::Endpoint::Interface_sPtr device, ServiceCallback service )
+  {
+    const NodeId id = mNodes.size();
+
+    auto node           = std::make_unique<Node>();
+    node->device        = device;
+    node->service       = std::move( service );
+    node->state         = NODE_IDLE;
+    node->serviced      = 0;
+    node->requeues      = 0;
+    node->timerDeadline = Sim::Clock::WAIT_FOREVER;
+    node->homeWorker    = id % mWorkers.size();
+
+    mNodes.push_back( std::move( node ) );
+    return id;
+  }
+
+  void Executor::notify( const NodeId id )
+  {
+    Node *node = mNodes[ id ].get();
+
+    while ( true )
+    {
+      uint8_t state = node->state.load();
+
+      if ( state == NODE_IDLE )
+      {
+        if ( node->state.compare_exchange_weak( state, NODE_QUEUED ) )
+        {
+          enqueue( id );
+          return;
+        }
+      }
+      else if ( state == NODE_RUNNING )
+      {
+        /*------------------------------------------------
+        The worker servicing the node will queue it again
+        once done, so it's never serviced concurrently.
+        ------------------------------------------------*/
+        if ( node->state.compare_exchange_weak( state, NODE_RUNNING_DIRTY ) )
+        {
+          return;
+        }
+      }
+      else
+      {
+        return;
+      }
+    }
+  }
+
+  void Executor::armTimer( const NodeId id, const size_t delayMs )
+  {
+    const uint64_t deadline = Sim::Clock::micros() + ( static_cast<uint64_t>( delayMs ) * 1000 );
+    Node *node              = mNodes[ id ].get();
+
+    {
+      std::lock_guard<std::mutex> lock( mTimerLock );
+
+      /*------------------------------------------------
+      Only the earliest deadline matters. Later entries
+      left in the heap are discarded lazily on expiry.
+      ------------------------------------------------*/
+      if ( deadline >= node->timerDeadline )
+      {
+        return;
+      }
+
+      node->timerDeadline = deadline;
+      mTimers.emplace( deadline, id );
+    }
+
+    /*------------------------------------------------
+    Any worker may be sleeping towards a later deadline
+    and, with stealing, any of them may end up running
+    the node. The home worker alone could be busy with
+    a long service, so let all of them recompute how
+    long to wait and whoever is idle expires the timer.
+    ------------------------------------------------*/
+    if ( !mConfig.workStealing )
+    {
+      mWorkers[ node->homeWorker ]->signal.notify();
+      return;
+    }
+
+    for ( auto &worker : mWorkers )
+    {
+      worker->signal.notify();
+    }
+  }
+
+  void Executor::start()
+  {
+    if ( mRunning.exchange( true ) )
+    {
+      return;
+    }
+
+    Sim::Clock::HoldScope hold;
+
+    for ( size_t x = 0; x < mWorkers.size(); x++ )
+    {
+      mWorkers[ x ]->thread = Sim::Clock::createThread( &Executor::workerThread, this, x );
+    }
+
+    /*------------------------------------------------
+    Every node gets serviced once so it can kick off
+    whatever its application logic needs to do.
+    ------------------------------------------------*/
+    for ( NodeId id = 0; id < mNodes.size(); id++ )
+    {
+      notify( id );
+    }
+  }
+
+  void Executor::stop()
+  {
+    if ( !mRunning.exchange( false ) )
+    {
+      return;
+    }
+
+    for ( auto &worker : mWorkers )
+    {
+      worker->signal.notify();
+    }
+
+    for ( auto &worker : mWorkers )
+    {
+      if ( worker->thread.joinable() )
+      {
+        worker->thread.join();
+      }
+    }
+  }
+
+  size_t Executor::serviceCount( const NodeId id ) const
+  {
+    return mNodes[ id ]->serviced;
+  }
+
+  NodeId Executor::activeNode()
+  {
+    return s_activeNode;
+  }
+
+  void Executor::workerThread( const size_t index )
+  {
+    Worker *self = mWorkers[ index ].get();
+    NodeId id    = INVALID_NODE;
+
+    while ( mRunning )
+    {
+      if ( dequeue( index, id ) )
+      {
+        service( id );
+        continue;
+      }
+
+      /*------------------------------------------------
+      Nothing runnable: move any due timers into the run
+      queues, then sleep until the next one is due.
+      ------------------------------------------------*/
+      const uint64_t nextDeadline = expireTimers();
+      if ( dequeue( index, id ) )
+      {
+        service( id );
+        continue;
+      }
+
+      uint64_t timeout = Sim::Clock::WAIT_FOREVER;
+      if ( nextDeadline != Sim::Clock::WAIT_FOREVER )
+      {
+        const uint64_t now = Sim::Clock::micros();
+        timeout            = ( nextDeadline > now ) ? ( nextDeadline - now ) : 0;
+      }
+
+      self->signal.wait( timeout );
+    }
+  }
+
+  void Executor::enqueue( const NodeId id )
+  {
+    Worker *worker = mWorkers[ mNodes[ id ]->homeWorker ].get();
+
+    {
+      std::lock_guard<std::mutex> lock( worker->lock );
+      worker->runQueue.push_back( id );
+    }
+
+    worker->signal.notify();
+
+    /*------------------------------------------------
+    Give a neighbor the chance to steal the work if the
+    home worker happens to be busy with something else.
+    ------------------------------------------------*/
+    if ( mConfig.workStealing && ( mWorkers.size() > 1 ) )
+    {
+      mWorkers[ ( mNodes[ id ]->homeWorker + 1 ) % mWorkers.size() ]->signal.notify();
+    }
+  }
+
+  bool Executor::dequeue( const size_t index, NodeId &id )
+  {
+    {
+      Worker *self = mWorkers[ index ].get();
+      std::lock_guard<std::mutex> lock( self->lock );
+
+      if ( !self->runQueue.empty() )
+      {
+        id = self->runQueue.front();
+        self->runQueue.pop_front();
+        return true;
+      }
+    }
+
+    if ( !mConfig.workStealing )
+    {
+      return false;
+    }
+
+    /*------------------------------------------------
+    Steal from the back of the other queues, which is
+    the work their owners would get to last anyways.
+    ------------------------------------------------*/
+    for ( size_t offset = 1; offset < mWorkers.size(); offset++ )
+    {
+      Worker *victim = mWorkers[ ( index + offset ) % mWorkers.size() ].get();
+      std::lock_guard<std::mutex> lock( victim->lock );
+
+      if ( !victim->runQueue.empty() )
+      {
+        id = victim->runQueue.back();
+        victim->runQueue.pop_back();
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  void Executor::service( const NodeId id )
+  {
+    Node *node = mNodes[ id ].get();
+    node->state = NODE_RUNNING;
+
+    s_activeNode = id;
+    node->device->doAsyncProcessing();
+
+    if ( node->service )
+    {
+      node->service( id, node->device );
+    }
+
+    s_activeNode = INVALID_NODE;
+    node->serviced++;
+
+    /*------------------------------------------------
+    Data still sitting in the RX queue means the node
+    isn't done, but a callback that never reads it would
+    keep the node spinning here and starve the timers.
+    After a few tries it waits like an idle node would.
+    ------------------------------------------------*/
+    const bool unread = node->device->packetAvailable();
+
+    if ( unread && ( node->requeues < MAX_REQUEUES ) )
+    {
+      node->requeues++;
+      node->state = NODE_QUEUED;
+      enqueue( id );
+      return;
+    }
+
+    node->requeues = 0;
+
+    if ( mConfig.housekeepingRate )
+    {
+      armTimer( id, mConfig.housekeepingRate );
+    }
+    else if ( unread )
+    {
+      armTimer( id, RX_BACKOFF_MS );
+    }
+
+    uint8_t expected = NODE_RUNNING;
+    if ( !node->state.compare_exchange_strong( expected, NODE_IDLE ) )
+    {
+      node->state = NODE_QUEUED;
+      enqueue( id );
+    }
+  }
+
+  uint64_t Executor::expireTimers()
+  {
+    std::vector<NodeId> due;
+    uint64_t nextDeadline = Sim::Clock::WAIT_FOREVER;
+
+    {
+      std::lock_guard<std::mutex> lock( mTimerLock );
+      const uint64_t now = Sim::Clock::micros();
+
+      while ( !mTimers.empty() )
+      {
+        const TimerEntry entry = mTimers.top();
+
+        if ( entry.first > now )
+        {
+          nextDeadline = entry.first;
+          break;
+        }
+
+        mTimers.pop();
+
+        /*------------------------------------------------
+        Skip stale entries superseded by an earlier timer
+        ------------------------------------------------*/
+        Node *node = mNodes[ entry.second ].get();
+        if ( node->timerDeadline == entry.first )
+        {
+          node->timerDeadline = Sim::Clock::WAIT_FOREVER;
+          due.push_back( entry.second );
+        }
+      }
+    }
+
+    for ( const NodeId id : due )
+    {
+      notify( id );
+    }
+
+    return nextDeadline;
+  }
+}    // namespace Sim
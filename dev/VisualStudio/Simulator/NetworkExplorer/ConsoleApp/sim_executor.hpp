@@ -0,0 +1,180 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_executor.hpp
+ *
+ *  Description:
+ *    Multiplexes many simulated endpoints over a small, fixed pool of worker
+ *    threads. An endpoint is only serviced when it has a timer due or was
+ *    told it has work pending.
+ *
+ *    This is a polling pool, not RX-driven scheduling. RF24::Endpoint receives
+ *    over loopback sockets inside the RF24Node submodule and nothing there
+ *    reports a frame arrival, so incoming data is only picked up by the
+ *    housekeeping timer or by whatever notify() call the application makes.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_EXECUTOR_HPP
+#define RF24_SIM_EXECUTOR_HPP
+
+/* STL Includes */
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/* RF24 Includes */
+#include <RF24Node/endpoint>
+
+/* Dev Includes */
+#include <sim_clock.hpp>
+
+namespace Sim
+{
+  /*-------------------------------------------------------------------------------
+  Aliases
+  -------------------------------------------------------------------------------*/
+  using NodeId          = size_t;
+  using ServiceCallback = std::function<void( const NodeId id, RF24::Endpoint::Interface_sPtr &device )>;
+
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr NodeId INVALID_NODE  = SIZE_MAX;
+  static constexpr size_t MAX_REQUEUES  = 8; /**< Back to back services for unread RX data before the node yields to timers */
+  static constexpr size_t RX_BACKOFF_MS = 1; /**< Retry delay for unread RX data when housekeeping is disabled */
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct ExecutorConfig
+  {
+    size_t workers;          /**< Number of OS threads servicing endpoints */
+    bool workStealing;       /**< Let idle workers take queued nodes from busy ones */
+    size_t housekeepingRate; /**< Period (ms) at which idle nodes are polled for RX data, 0 to disable */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  class Executor
+  {
+  public:
+    explicit Executor( const ExecutorConfig &cfg );
+    ~Executor();
+
+    /**
+     *  Hands a configured endpoint over to the executor. The service callback
+     *  runs on a worker thread right after the endpoint's networking has been
+     *  processed and is where the application logic for the node lives.
+     *
+     *  @param[in]  device    The endpoint to service
+     *  @param[in]  service   Application hook, may be empty
+     *  @return NodeId        Handle used with the other methods
+     */
+    NodeId addNode( RF24::Endpoint::Interface_sPtr device, ServiceCallback service );
+
+    /**
+     *  Marks a node as having work pending, such as freshly queued TX data.
+     *  Safe to call from any thread, including from within a service callback.
+     *
+     *  @param[in]  id        The node to schedule
+     *  @return void
+     */
+    void notify( const NodeId id );
+
+    /**
+     *  Schedules the node to be serviced after the given amount of simulation time
+     *
+     *  @param[in]  id        The node to schedule
+     *  @param[in]  delayMs   How far in the future to service the node
+     *  @return void
+     */
+    void armTimer( const NodeId id, const size_t delayMs );
+
+    /**
+     *  Spins up the worker pool
+     *
+     *  @return void
+     */
+    void start();
+
+    /**
+     *  Stops and joins the worker pool
+     *
+     *  @return void
+     */
+    void stop();
+
+    /**
+     *  Number of times a node has been serviced
+     *
+     *  @param[in]  id        The node to query
+     *  @return size_t
+     */
+    size_t serviceCount( const NodeId id ) const;
+
+    /**
+     *  Node currently being serviced by the calling worker thread. Lets
+     *  context-free callbacks (e.g. connection results) find their node.
+     *
+     *  @return NodeId        INVALID_NODE if not called from a service
+     */
+    static NodeId activeNode();
+
+  private:
+    enum NodeState : uint8_t
+    {
+      NODE_IDLE,          /**< Nothing pending */
+      NODE_QUEUED,        /**< Sitting in a run queue */
+      NODE_RUNNING,       /**< Being serviced by a worker */
+      NODE_RUNNING_DIRTY  /**< Being serviced and more work arrived meanwhile */
+    };
+
+    struct Node
+    {
+      RF24::Endpoint::Interface_sPtr device;
+      ServiceCallback service;
+      std::atomic<uint8_t> state;
+      std::atomic<size_t> serviced;
+      size_t requeues;        /**< Consecutive services that left RX data unread */
+      uint64_t timerDeadline; /**< Earliest pending timer (us), guarded by mTimerLock */
+      size_t homeWorker;
+    };
+
+    struct Worker
+    {
+      std::mutex lock;
+      std::deque<NodeId> runQueue;
+      Sim::Clock::Signal signal;
+      std::thread thread;
+    };
+
+    using TimerEntry = std::pair<uint64_t, NodeId>;
+    using TimerQueue = std::priority_queue<TimerEntry, std::vector<TimerEntry>, std::greater<TimerEntry>>;
+
+    ExecutorConfig mConfig;
+    std::atomic<bool> mRunning;
+    std::vector<std::unique_ptr<Node>> mNodes;
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+
+    std::mutex mTimerLock;
+    TimerQueue mTimers;
+
+    void workerThread( const size_t index );
+    void enqueue( const NodeId id );
+    bool dequeue( const size_t index, NodeId &id );
+    void service( const NodeId id );
+    uint64_t expireTimers();
+  };
+}    // namespace Sim
+
+#endif /* !RF24_SIM_EXECUTOR_HPP */
@@ -0,0 +1,499 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_fragment.cpp
+ *
+ *  Description:
+ *    Message fragmentation and reassembly implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <cstring>
+
+/* Chimera Includes */
+#include <Chimera/common>
+
+/* Dev Includes */
+#include <sim_clock.hpp>
+#include <sim_fragment.hpp>
+
+namespace Sim::Fragment
+{
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  static size_t fragmentsFor( const size_t length, const size_t stride )
+  {
+    return ( length + stride - 1 ) / stride;
+  }
+
+  static size_t levelOf( RF24::LogicalAddress address )
+  {
+    size_t level = 0;
+    for ( ; address; address >>= 3 )
+    {
+      level++;
+    }
+
+    return level;
+  }
+
+  /*------------------------------------------------
+  Compact source encoding, the top bits of the first
+  byte select the form:
+    00vvvvvv            Absolute address v
+    01vvvvvv            Digits v below the destination
+    1vvvvvvv vvvvvvvv   Absolute 15 bit address
+  ------------------------------------------------*/
+  static constexpr uint8_t SourceShort    = 0x00;
+  static constexpr uint8_t SourceRelative = 0x40;
+  static constexpr uint8_t SourceLong     = 0x80;
+  static constexpr uint8_t SourceForm     = 0xC0;
+  static constexpr uint8_t SourceValue    = 0x3F;
+
+  static size_t encodeSource( uint8_t *const out, const RF24::LogicalAddress source, const RF24::LogicalAddress destination )
+  {
+    const size_t shift = 3 * levelOf( destination );
+    const bool below   = ( shift < 16 ) && ( ( source & ( ( 1u << shift ) - 1 ) ) == destination ) && ( source >> shift );
+
+    if ( source <= SourceValue )
+    {
+      out[ 0 ] = static_cast<uint8_t>( SourceShort | source );
+      return 1;
+    }
+    else if ( below && ( ( source >> shift ) <= SourceValue ) )
+    {
+      out[ 0 ] = static_cast<uint8_t>( SourceRelative | ( source >> shift ) );
+      return 1;
+    }
+
+    out[ 0 ] = static_cast<uint8_t>( SourceLong | ( ( source >> 8 ) & 0x7F ) );
+    out[ 1 ] = static_cast<uint8_t>( source & 0xFF );
+    return 2;
+  }
+
+  static size_t decodeSource( const uint8_t *const in, const size_t length, const RF24::LogicalAddress self,
+                              RF24::LogicalAddress &source )
+  {
+    if ( !length )
+    {
+      return 0;
+    }
+
+    switch ( in[ 0 ] & SourceForm )
+    {
+      case SourceShort:
+        source = static_cast<RF24::LogicalAddress>( in[ 0 ] & SourceValue );
+        return 1;
+
+      case SourceRelative:
+        source = static_cast<RF24::LogicalAddress>( ( ( in[ 0 ] & SourceValue ) << ( 3 * levelOf( self ) ) ) | self );
+        return 1;
+
+      default:
+        if ( length < 2 )
+        {
+          return 0;
+        }
+
+        source = static_cast<RF24::LogicalAddress>( ( ( in[ 0 ] & 0x7F ) << 8 ) | in[ 1 ] );
+        return 2;
+    }
+  }
+
+  /*-------------------------------------------------------------------------------
+  Stream Implementation
+  -------------------------------------------------------------------------------*/
+  Stream::Stream( RF24::Endpoint::Interface_sPtr device, const Config &cfg ) :
+      mDevice( device ), mConfig( cfg ), mStats{}, mNextMessage( 0 )
+  {
+    mConfig.maxMessageSize = std::min( std::max<size_t>( mConfig.maxMessageSize, 1 ), MAX_MESSAGE_SIZE );
+
+    /*------------------------------------------------
+    A caller's buffer that can't hold even one message
+    would leave no slots at all, so it's not used and
+    the stream allocates its own instead.
+    ------------------------------------------------*/
+    if ( !mConfig.rxBuffer || ( mConfig.rxBufferSize < mConfig.maxMessageSize ) )
+    {
+      mConfig.rxBufferSize = std::max( mConfig.rxBufferSize, mConfig.maxMessageSize );
+      mOwnedBuffer         = std::make_unique<uint8_t[]>( mConfig.rxBufferSize );
+      mConfig.rxBuffer     = mOwnedBuffer.get();
+    }
+
+    /*------------------------------------------------
+    Every slot can hold the largest message, so there's
+    never any need to move a message once it's started.
+    ------------------------------------------------*/
+    mSlots.resize( mConfig.rxBufferSize / mConfig.maxMessageSize );
+
+    for ( size_t x = 0; x < mSlots.size(); x++ )
+    {
+      mSlots[ x ].used = false;
+      mSlots[ x ].data = mConfig.rxBuffer + ( x * mConfig.maxMessageSize );
+    }
+  }
+
+  bool Stream::write( const RF24::LogicalAddress destination, const void *data, const size_t length )
+  {
+    if ( !data || !length || ( length > mConfig.maxMessageSize ) )
+    {
+      return false;
+    }
+
+    /*------------------------------------------------
+    Hold back at most one maximum sized message worth of
+    fragments, otherwise a sender that outpaces the radio
+    would grow the backlog without bound.
+    ------------------------------------------------*/
+    const size_t header = headerSize( destination );
+    const size_t stride = FRAME_SIZE - header;
+    const size_t count  = fragmentsFor( length, stride );
+
+    if ( !mBacklog.empty() && ( ( mBacklog.size() + count ) > fragmentsFor( mConfig.maxMessageSize, stride ) ) )
+    {
+      return false;
+    }
+
+    const uint8_t *bytes  = static_cast<const uint8_t *>( data );
+    const uint8_t message = mConfig.compactHeaders ? ( mNextMessage++ & COMPACT_MESSAGE ) : mNextMessage++;
+
+    for ( size_t index = 0; index < count; index++ )
+    {
+      const size_t offset = index * stride;
+      const size_t size   = std::min( length - offset, stride );
+
+      TxFrame frame;
+      frame.destination = destination;
+      frame.length      = header + size;
+      frame.header      = header;
+      writeHeader( frame.data.data(), destination, message, index, count );
+      memcpy( &frame.data[ header ], bytes + offset, size );
+
+      mBacklog.push_back( frame );
+    }
+
+    mStats.messagesSent++;
+    flush();
+    return true;
+  }
+
+  size_t Stream::process()
+  {
+    const size_t moved = flush();
+
+    while ( mDevice->packetAvailable() )
+    {
+      const size_t length = std::min( mDevice->nextPacketLength(), mFrame.size() );
+
+      if ( mDevice->read( mFrame.data(), length ) == Chimera::CommonStatusCodes::OK )
+      {
+        receive( mFrame.data(), length );
+      }
+    }
+
+    /*------------------------------------------------
+    A message that stops making progress was most likely
+    cut short by a lost fragment. Free its slot rather
+    than let it block newer messages forever.
+    ------------------------------------------------*/
+    const size_t now = Clock::millis();
+
+    for ( Slot &slot : mSlots )
+    {
+      if ( slot.used && !slot.complete && ( ( now - slot.lastActivityMs ) > mConfig.timeoutMs ) )
+      {
+        mStats.timeouts++;
+        release( &slot );
+      }
+    }
+
+    return moved;
+  }
+
+  bool Stream::available() const
+  {
+    return !mCompleted.empty();
+  }
+
+  size_t Stream::nextLength() const
+  {
+    return mCompleted.empty() ? 0 : mCompleted.front()->length;
+  }
+
+  bool Stream::read( void *const data, const size_t length, RF24::LogicalAddress *const source )
+  {
+    if ( mCompleted.empty() || !data || ( length < mCompleted.front()->length ) )
+    {
+      return false;
+    }
+
+    Slot *slot = mCompleted.front();
+    mCompleted.pop_front();
+
+    memcpy( data, slot->data, slot->length );
+    if ( source )
+    {
+      *source = slot->source;
+    }
+
+    release( slot );
+    return true;
+  }
+
+  bool Stream::readChunk( Chunk &chunk )
+  {
+    if ( !mConfig.streaming )
+    {
+      return false;
+    }
+
+    for ( Slot &slot : mSlots )
+    {
+      if ( !slot.used || !slot.have.test( slot.delivered ) )
+      {
+        continue;
+      }
+
+      const size_t index = slot.delivered++;
+
+      chunk.source  = slot.source;
+      chunk.message = slot.message;
+      chunk.offset  = index * slot.stride;
+      chunk.length  = slot.sizes[ index ];
+      chunk.last    = ( slot.delivered == slot.count );
+      chunk.data    = slot.data + chunk.offset;
+
+      /*------------------------------------------------
+      The slot's memory stays intact until the next frame
+      is received, which can't happen before the caller
+      comes back into the stream.
+      ------------------------------------------------*/
+      if ( chunk.last )
+      {
+        release( &slot );
+      }
+
+      return true;
+    }
+
+    return false;
+  }
+
+  bool Stream::pendingTx() const
+  {
+    return !mBacklog.empty();
+  }
+
+  Stats Stream::getStats() const
+  {
+    return mStats;
+  }
+
+  size_t Stream::flush()
+  {
+    size_t moved = 0;
+
+    while ( !mBacklog.empty() )
+    {
+      const TxFrame &frame = mBacklog.front();
+
+      if ( mDevice->write( frame.destination, frame.data.data(), frame.length ) != Chimera::CommonStatusCodes::OK )
+      {
+        break;
+      }
+
+      mStats.fragmentsSent++;
+      mStats.headerBytes += frame.header;
+      mBacklog.pop_front();
+      moved++;
+    }
+
+    return moved;
+  }
+
+  size_t Stream::headerSize( const RF24::LogicalAddress destination ) const
+  {
+    if ( !mConfig.compactHeaders )
+    {
+      return HEADER_SIZE;
+    }
+
+    uint8_t source[ 2 ];
+    return COMPACT_HEADER_MIN - 1 + encodeSource( source, mConfig.address, destination );
+  }
+
+  void Stream::writeHeader( uint8_t *const frame, const RF24::LogicalAddress destination, const uint8_t message,
+                            const size_t index, const size_t count ) const
+  {
+    if ( !mConfig.compactHeaders )
+    {
+      frame[ 0 ] = FRAGMENT_MAGIC;
+      frame[ 1 ] = static_cast<uint8_t>( mConfig.address & 0xFF );
+      frame[ 2 ] = static_cast<uint8_t>( mConfig.address >> 8 );
+      frame[ 3 ] = message;
+      frame[ 4 ] = static_cast<uint8_t>( index );
+      frame[ 5 ] = static_cast<uint8_t>( count );
+      return;
+    }
+
+    const size_t offset = 1 + encodeSource( &frame[ 1 ], mConfig.address, destination );
+
+    frame[ 0 ]          = COMPACT_MAGIC;
+    frame[ offset ]     = static_cast<uint8_t>( message | ( ( index + 1 == count ) ? COMPACT_LAST : 0 ) );
+    frame[ offset + 1 ] = static_cast<uint8_t>( index );
+  }
+
+  void Stream::receive( const uint8_t *const frame, const size_t length )
+  {
+    RF24::LogicalAddress source = 0;
+    uint8_t message             = 0;
+    size_t index                = 0;
+    size_t count                = 0;
+    size_t header               = 0;
+    bool last                   = false;
+
+    /*------------------------------------------------
+    A compact header only names the fragment count in
+    its last fragment, until then the count is unknown.
+    ------------------------------------------------*/
+    if ( length && ( frame[ 0 ] == FRAGMENT_MAGIC ) && ( length > HEADER_SIZE ) )
+    {
+      source  = static_cast<RF24::LogicalAddress>( frame[ 1 ] | ( frame[ 2 ] << 8 ) );
+      message = frame[ 3 ];
+      index   = frame[ 4 ];
+      count   = frame[ 5 ];
+      header  = HEADER_SIZE;
+      last    = ( index + 1 == count );
+    }
+    else if ( length && ( frame[ 0 ] == COMPACT_MAGIC ) )
+    {
+      const size_t sourceSize = decodeSource( &frame[ 1 ], length - 1, mConfig.address, source );
+      header                  = COMPACT_HEADER_MIN - 1 + sourceSize;
+
+      if ( sourceSize && ( length > header ) )
+      {
+        message = frame[ header - 2 ] & COMPACT_MESSAGE;
+        last    = ( frame[ header - 2 ] & COMPACT_LAST ) != 0;
+        index   = frame[ header - 1 ];
+        count   = last ? ( index + 1 ) : 0;
+      }
+      else
+      {
+        header = 0;
+      }
+    }
+
+    /*------------------------------------------------
+    Every fragment but the last is completely full, so
+    a fragment's index alone says where its data goes.
+    ------------------------------------------------*/
+    const size_t stride = FRAME_SIZE - header;
+    const size_t size   = length - header;
+
+    if ( !header || ( count && ( index >= count ) ) || ( index >= MAX_FRAGMENTS ) || ( !last && ( size != stride ) ) ||
+         ( ( ( count ? ( count - 1 ) : index ) * stride ) + ( last ? size : 1 ) > mConfig.maxMessageSize ) )
+    {
+      mStats.rejected++;
+      return;
+    }
+
+    mStats.fragmentsReceived++;
+
+    Slot *slot = findSlot( source, message, count, stride );
+    if ( !slot )
+    {
+      return;
+    }
+
+    if ( slot->have.test( index ) )
+    {
+      mStats.duplicates++;
+      return;
+    }
+
+    if ( slot->count && ( index >= slot->count ) )
+    {
+      mStats.rejected++;
+      return;
+    }
+
+    memcpy( slot->data + ( index * stride ), frame + header, size );
+    slot->have.set( index );
+    slot->sizes[ index ]  = static_cast<uint8_t>( size );
+    slot->lastActivityMs  = Clock::millis();
+    slot->received++;
+
+    if ( last )
+    {
+      slot->length = ( index * stride ) + size;
+    }
+
+    if ( slot->count && ( slot->received == slot->count ) )
+    {
+      slot->complete = true;
+      mStats.messagesReceived++;
+
+      if ( !mConfig.streaming )
+      {
+        mCompleted.push_back( slot );
+      }
+    }
+  }
+
+  Stream::Slot *Stream::findSlot( const RF24::LogicalAddress source, const uint8_t message, const size_t count,
+                                  const size_t stride )
+  {
+    Slot *freeSlot = nullptr;
+
+    for ( Slot &slot : mSlots )
+    {
+      if ( !slot.used )
+      {
+        freeSlot = freeSlot ? freeSlot : &slot;
+      }
+      else if ( ( slot.source == source ) && ( slot.message == message ) )
+      {
+        /*------------------------------------------------
+        Once the count is known no fragment may lie past it
+        ------------------------------------------------*/
+        if ( ( slot.stride != stride ) || ( count && slot.count && ( slot.count != count ) ) ||
+             ( count && !slot.count && ( slot.have >> count ).any() ) )
+        {
+          mStats.rejected++;
+          return nullptr;
+        }
+
+        slot.count = slot.count ? slot.count : count;
+        return &slot;
+      }
+    }
+
+    if ( !freeSlot )
+    {
+      mStats.overflows++;
+      return nullptr;
+    }
+
+    freeSlot->used      = true;
+    freeSlot->complete  = false;
+    freeSlot->source    = source;
+    freeSlot->message   = message;
+    freeSlot->count     = count;
+    freeSlot->stride    = stride;
+    freeSlot->length    = 0;
+    freeSlot->received  = 0;
+    freeSlot->delivered = 0;
+    freeSlot->have.reset();
+
+    return freeSlot;
+  }
+
+  void Stream::release( Slot *const slot )
+  {
+    slot->used = false;
+  }
+
+}    // namespace Sim::Fragment
@@ -0,0 +1,238 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_fragment.hpp
+ *
+ *  Description:
+ *    Fragmentation and reassembly of messages larger than a single frame. A
+ *    Stream sits on top of an endpoint, splits each message into frames that
+ *    are queued back to back, and puts them together again on the receiving
+ *    side. Complete messages can be read whole, or in streaming mode each
+ *    fragment is handed over in order as soon as it arrives.
+ *
+ *    Fragments carry one of two headers. The full header spells out the
+ *    source address, message id, index and fragment count in six bytes. The
+ *    compact header leaves the count out, since the last fragment flags
+ *    itself, and shares a byte between that flag and a shorter message id.
+ *    It writes the source in a single byte when the address is short, or
+ *    relative to the destination when the source sits just below it in the
+ *    tree, only falling back to the full two byte address otherwise. Out of
+ *    the 24 bytes the network layer leaves in each frame, that is 20 bytes
+ *    of data, 19 at worst, instead of 18.
+ *
+ *    Reassembly memory is supplied by the caller or allocated on the heap
+ *    when the stream is created. It can't come out of the endpoint's own RX
+ *    queue, which RF24Node owns and doesn't expose.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_FRAGMENT_HPP
+#define RF24_SIM_FRAGMENT_HPP
+
+/* STL Includes */
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+#include <RF24Node/endpoint>
+
+/* Dev Includes */
+#include <sim_endpoint.hpp>
+
+namespace Sim::Fragment
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint8_t FRAGMENT_MAGIC     = 0xF7; /**< First byte of every fragment with the full header */
+  static constexpr uint8_t COMPACT_MAGIC      = 0xF6; /**< First byte of every fragment with the compact header */
+  static constexpr size_t HEADER_SIZE         = 6;    /**< Magic, source, message id, index and count */
+  static constexpr size_t COMPACT_HEADER_MIN  = 4;    /**< Magic, short source, message id and flag, index */
+  static constexpr size_t COMPACT_HEADER_MAX  = 5;    /**< As above with a full two byte source */
+  static constexpr uint8_t COMPACT_LAST       = 0x80; /**< Set in the message byte of the last fragment */
+  static constexpr uint8_t COMPACT_MESSAGE    = 0x7F; /**< Bits of the message byte holding the id */
+  static constexpr size_t FRAME_SIZE          = Endpoint::MAX_PAYLOAD_SIZE; /**< Bytes of a frame left after the network header */
+  static constexpr size_t FRAGMENT_DATA_SIZE  = FRAME_SIZE - HEADER_SIZE;
+  static constexpr size_t MAX_FRAGMENTS       = 255;
+  static constexpr size_t MAX_MESSAGE_SIZE    = MAX_FRAGMENTS * FRAGMENT_DATA_SIZE;
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct Config
+  {
+    RF24::LogicalAddress address; /**< Address of the endpoint the stream is attached to */
+    uint8_t *rxBuffer;            /**< Reassembly memory, nullptr to allocate it. Not used if smaller than maxMessageSize. */
+    size_t rxBufferSize;          /**< Bytes of reassembly memory, split into maxMessageSize slots */
+    size_t maxMessageSize;        /**< Largest message that will be accepted in either direction */
+    size_t timeoutMs;             /**< A partial message is dropped once it goes this long without a new fragment */
+    bool streaming;               /**< Deliver fragments through readChunk() instead of whole messages */
+    bool compactHeaders;          /**< Send with the compact header, both kinds are always accepted */
+  };
+
+  struct Chunk
+  {
+    RF24::LogicalAddress source;
+    uint8_t message;              /**< Identifies the message among others from the same source */
+    size_t offset;                /**< Position of the data within the message */
+    size_t length;
+    bool last;                    /**< This chunk completes the message */
+    const uint8_t *data;          /**< Valid until the next call into the stream */
+  };
+
+  struct Stats
+  {
+    size_t messagesSent;
+    size_t fragmentsSent;
+    size_t headerBytes;           /**< Header overhead of every fragment sent */
+    size_t messagesReceived;      /**< Messages fully reassembled */
+    size_t fragmentsReceived;
+    size_t duplicates;            /**< Fragments that had already been received */
+    size_t timeouts;              /**< Partial messages dropped by the timeout */
+    size_t overflows;             /**< Fragments dropped because no reassembly slot was free */
+    size_t rejected;              /**< Frames that weren't valid fragments */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Not thread safe. Every call must come from whichever thread is servicing
+   *  the endpoint, and the endpoint's RX data must only be read through here.
+   */
+  class Stream
+  {
+  public:
+    /**
+     *  @param[in]  device    Configured endpoint to send and receive through
+     *  @param[in]  cfg       Stream settings
+     */
+    Stream( RF24::Endpoint::Interface_sPtr device, const Config &cfg );
+
+    Stream( const Stream & ) = delete;
+    Stream &operator=( const Stream & ) = delete;
+
+    /**
+     *  Splits a message into fragments and queues as many of them on the
+     *  endpoint as it will take. The rest are kept back and fed to it from
+     *  process(), so the message is never interleaved with a later one.
+     *
+     *  @param[in]  destination   Node to deliver the message to
+     *  @param[in]  data          Message to send
+     *  @param[in]  length        Bytes in the message, up to maxMessageSize
+     *  @return bool              True if the message was accepted
+     */
+    bool write( const RF24::LogicalAddress destination, const void *data, const size_t length );
+
+    /**
+     *  Moves held back fragments onto the endpoint, pulls newly received
+     *  frames into reassembly and expires stale partial messages. Call it
+     *  after every Endpoint::doAsyncProcessing().
+     *
+     *  @return size_t        Fragments handed to the endpoint
+     */
+    size_t process();
+
+    /**
+     *  Checks if a fully reassembled message is waiting, whole message mode only
+     *
+     *  @return bool
+     */
+    bool available() const;
+
+    /**
+     *  Length of the next complete message
+     *
+     *  @return size_t        Zero if none is waiting
+     */
+    size_t nextLength() const;
+
+    /**
+     *  Copies out the next complete message, whole message mode only
+     *
+     *  @param[out] data      Where to copy the message
+     *  @param[in]  length    Size of the buffer, must hold nextLength() bytes
+     *  @param[out] source    Sender of the message, may be nullptr
+     *  @return bool          True if a message was read
+     */
+    bool read( void *const data, const size_t length, RF24::LogicalAddress *const source );
+
+    /**
+     *  Hands over the next fragment, in order, of any message in progress.
+     *  Streaming mode only. Out of order fragments are held back until the
+     *  gap before them fills in.
+     *
+     *  @param[out] chunk     Description of the fragment
+     *  @return bool          True if a fragment was available
+     */
+    bool readChunk( Chunk &chunk );
+
+    /**
+     *  Checks if any fragments are still waiting for room on the endpoint
+     *
+     *  @return bool
+     */
+    bool pendingTx() const;
+
+    /**
+     *  @return Stats
+     */
+    Stats getStats() const;
+
+  private:
+    struct TxFrame
+    {
+      RF24::LogicalAddress destination;
+      size_t length;
+      size_t header;                        /**< Bytes of the frame taken by the header */
+      std::array<uint8_t, FRAME_SIZE> data;
+    };
+
+    struct Slot
+    {
+      bool used;
+      bool complete;
+      RF24::LogicalAddress source;
+      uint8_t message;
+      size_t count;                         /**< Fragments making up the message, 0 until known */
+      size_t stride;                        /**< Data bytes in every fragment but the last */
+      size_t length;                        /**< Total bytes, known once the last fragment arrives */
+      size_t received;                      /**< Fragments received so far */
+      size_t delivered;                     /**< Fragments handed over through readChunk() */
+      size_t lastActivityMs;
+      std::bitset<MAX_FRAGMENTS> have;
+      std::array<uint8_t, MAX_FRAGMENTS> sizes; /**< Data bytes in each received fragment */
+      uint8_t *data;
+    };
+
+    RF24::Endpoint::Interface_sPtr mDevice;
+    Config mConfig;
+    Stats mStats;
+    uint8_t mNextMessage;
+    std::unique_ptr<uint8_t[]> mOwnedBuffer;
+    std::vector<Slot> mSlots;
+    std::deque<Slot *> mCompleted;          /**< Reassembled messages in the order they finished */
+    std::deque<TxFrame> mBacklog;
+    std::array<uint8_t, FRAME_SIZE> mFrame;
+
+    size_t flush();
+    size_t headerSize( const RF24::LogicalAddress destination ) const;
+    void writeHeader( uint8_t *const frame, const RF24::LogicalAddress destination, const uint8_t message,
+                      const size_t index, const size_t count ) const;
+    void receive( const uint8_t *const frame, const size_t length );
+    Slot *findSlot( const RF24::LogicalAddress source, const uint8_t message, const size_t count, const size_t stride );
+    void release( Slot *const slot );
+  };
+
+  using Stream_uPtr = std::unique_ptr<Stream>;
+
+}    // namespace Sim::Fragment
+
+#endif /* !RF24_SIM_FRAGMENT_HPP */
@@ -0,0 +1,149 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_medium.cpp
+ *
+ *  Description:
+ *    In-process RF medium implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <mutex>
+#include <unordered_map>
+
+/* Dev Includes */
+#include <sim_medium.hpp>
+
+namespace Sim::Medium
+{
+  /*-------------------------------------------------------------------------------
+  Private Data
+  -------------------------------------------------------------------------------*/
+  static std::mutex s_registryLock;
+  static std::unordered_map<Address, Pipe> s_registry;
+  static std::atomic<size_t> s_pipeDepth = DEFAULT_PIPE_DEPTH;
+
+  /*-------------------------------------------------------------------------------
+  FrameRing Implementation
+  -------------------------------------------------------------------------------*/
+  FrameRing::FrameRing( const size_t depth ) : mDropped( 0 ), mEnqueuePos( 0 ), mDequeuePos( 0 )
+  {
+    size_t actualDepth = 2;
+    while ( actualDepth < depth )
+    {
+      actualDepth <<= 1;
+    }
+
+    mMask  = actualDepth - 1;
+    mCells = std::make_unique<Cell[]>( actualDepth );
+
+    for ( size_t x = 0; x < actualDepth; x++ )
+    {
+      mCells[ x ].sequence.store( x, std::memory_order_relaxed );
+    }
+  }
+
+  bool FrameRing::push( const Frame &frame )
+  {
+    size_t pos = mEnqueuePos.load( std::memory_order_relaxed );
+    Cell *cell = nullptr;
+
+    while ( true )
+    {
+      cell               = &mCells[ pos & mMask ];
+      const size_t seq   = cell->sequence.load( std::memory_order_acquire );
+      const intptr_t dif = static_cast<intptr_t>( seq ) - static_cast<intptr_t>( pos );
+
+      if ( dif == 0 )
+      {
+        if ( mEnqueuePos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+        {
+          break;
+        }
+      }
+      else if ( dif < 0 )
+      {
+        mDropped.fetch_add( 1, std::memory_order_relaxed );
+        return false;
+      }
+      else
+      {
+        pos = mEnqueuePos.load( std::memory_order_relaxed );
+      }
+    }
+
+    cell->frame = frame;
+    cell->sequence.store( pos + 1, std::memory_order_release );
+    return true;
+  }
+
+  bool FrameRing::pop( Frame &frame )
+  {
+    size_t pos = mDequeuePos.load( std::memory_order_relaxed );
+    Cell *cell = nullptr;
+
+    while ( true )
+    {
+      cell               = &mCells[ pos & mMask ];
+      const size_t seq   = cell->sequence.load( std::memory_order_acquire );
+      const intptr_t dif = static_cast<intptr_t>( seq ) - static_cast<intptr_t>( pos + 1 );
+
+      if ( dif == 0 )
+      {
+        if ( mDequeuePos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+        {
+          break;
+        }
+      }
+      else if ( dif < 0 )
+      {
+        return false;
+      }
+      else
+      {
+        pos = mDequeuePos.load( std::memory_order_relaxed );
+      }
+    }
+
+    frame = cell->frame;
+    cell->sequence.store( pos + mMask + 1, std::memory_order_release );
+    return true;
+  }
+
+  bool FrameRing::empty() const
+  {
+    const size_t pos = mDequeuePos.load( std::memory_order_relaxed );
+    const size_t seq = mCells[ pos & mMask ].sequence.load( std::memory_order_acquire );
+    return seq != ( pos + 1 );
+  }
+
+  size_t FrameRing::dropped() const
+  {
+    return mDropped.load( std::memory_order_relaxed );
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  void setPipeDepth( const size_t depth )
+  {
+    s_pipeDepth = depth;
+  }
+
+  Pipe openPipe( const Address address )
+  {
+    std::lock_guard<std::mutex> lock( s_registryLock );
+
+    auto iter = s_registry.find( address );
+    if ( iter != s_registry.end() )
+    {
+      return iter->second;
+    }
+
+    Pipe pipe = std::make_shared<FrameRing>( s_pipeDepth );
+    s_registry.emplace( address, pipe );
+    return pipe;
+  }
+
+}    // namespace Sim::Medium
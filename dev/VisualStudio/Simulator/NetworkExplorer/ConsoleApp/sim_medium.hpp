@@ -0,0 +1,152 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_medium.hpp
+ *
+ *  Description:
+ *    In-process RF medium for the simulator. Each physical pipe address maps
+ *    onto a lock-free ring of ShockBurst frames that every simulated radio in
+ *    the process can reach directly, avoiding a loopback socket per frame.
+ *
+ *    These rings carry the frames of the Sim::ShockBurst transceiver model and
+ *    its channel. They are not a backend for RF24::Endpoint: its simulator
+ *    pipe lives in the RF24Node submodule and only knows loopback sockets, so
+ *    selecting this medium at Endpoint::configure() needs a change there
+ *    first. Until then endpoint traffic never reaches these rings.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_MEDIUM_HPP
+#define RF24_SIM_MEDIUM_HPP
+
+/* STL Includes */
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+
+namespace Sim::Medium
+{
+  /*-------------------------------------------------------------------------------
+  Aliases
+  -------------------------------------------------------------------------------*/
+  using Address = RF24::PhysicalAddress;
+
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t FRAME_WIDTH        = RF24::Hardware::MAX_PAYLOAD_WIDTH;
+  static constexpr size_t DEFAULT_PIPE_DEPTH = 32; /**< Frames buffered per pipe address before drops */
+
+  static constexpr uint8_t FRAME_FLAG_NO_ACK = 0x01; /**< Packet control field NO_ACK bit was set */
+  static constexpr uint8_t FRAME_FLAG_ACK    = 0x02; /**< Frame is an acknowledgement, not new data */
+  static constexpr uint8_t FRAME_FLAG_RETRY  = 0x04; /**< Frame is an automatic retransmission */
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct Frame
+  {
+    Address source;  /**< Pipe address of the transmitter */
+    uint8_t channel; /**< RF channel the frame was sent on */
+    uint8_t length;  /**< Number of valid bytes in the payload */
+    uint8_t pid;     /**< 2-bit packet identity used to spot retransmissions */
+    uint8_t flags;   /**< FRAME_FLAG_xxx bits */
+    std::array<uint8_t, FRAME_WIDTH> payload;
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Bounded multi-producer/multi-consumer ring of frames. Each cell carries
+   *  a sequence counter so producers and consumers only ever contend on a
+   *  single atomic index, never on a lock.
+   */
+  class FrameRing
+  {
+  public:
+    /**
+     *  @param[in]  depth     Requested number of frames, rounded up to a power of two
+     */
+    explicit FrameRing( const size_t depth );
+    ~FrameRing() = default;
+
+    /**
+     *  Places a frame into the ring
+     *
+     *  @param[in]  frame     The frame to copy in
+     *  @return bool          False if the ring was full and the frame was dropped
+     */
+    bool push( const Frame &frame );
+
+    /**
+     *  Removes the oldest frame from the ring
+     *
+     *  @param[out] frame     Destination for the frame
+     *  @return bool          False if the ring was empty
+     */
+    bool pop( Frame &frame );
+
+    /**
+     *  Checks if there is at least one frame waiting. Only a hint when
+     *  other threads are actively pushing/popping.
+     *
+     *  @return bool
+     */
+    bool empty() const;
+
+    /**
+     *  Number of frames rejected because the ring was full
+     *
+     *  @return size_t
+     */
+    size_t dropped() const;
+
+  private:
+    struct Cell
+    {
+      std::atomic<size_t> sequence;
+      Frame frame;
+    };
+
+
+    std::unique_ptr<Cell[]> mCells;
+    size_t mMask;
+    std::atomic<size_t> mDropped;
+
+    alignas( 64 ) std::atomic<size_t> mEnqueuePos;
+    alignas( 64 ) std::atomic<size_t> mDequeuePos;
+  };
+
+  using Pipe = std::shared_ptr<FrameRing>;
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Sets the ring depth used for pipes opened after this call
+   *
+   *  @param[in]  depth     Frames per pipe
+   *  @return void
+   */
+  void setPipeDepth( const size_t depth );
+
+  /**
+   *  Looks up (or lazily creates) the ring backing a physical pipe address.
+   *  Receivers and transmitters resolve the same ring, so this is only done
+   *  once when a pipe is opened and never on the per-frame path.
+   *
+   *  @param[in]  address   Physical address of the pipe
+   *  @return Pipe
+   */
+  Pipe openPipe( const Address address );
+
+}    // namespace Sim::Medium
+
+#endif /* !RF24_SIM_MEDIUM_HPP */
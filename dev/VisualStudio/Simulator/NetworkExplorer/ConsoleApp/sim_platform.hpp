@@ -0,0 +1,51 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_platform.hpp
+ *
+ *  Description:
+ *    Thin wrappers over the few OS specific calls the simulator makes so the
+ *    scenario sources don't depend on Windows headers. Only the Visual Studio
+ *    project builds them today; see sim_runner.hpp.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_PLATFORM_HPP
+#define RF24_SIM_PLATFORM_HPP
+
+/* STL Includes */
+#include <string>
+
+#if defined( _WIN32 )
+#include <windows.h>
+#include <processthreadsapi.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace Sim::Platform
+{
+  /**
+   *  Names the calling thread so it is identifiable in a debugger
+   *
+   *  @param[in]  name      The thread name
+   *  @return void
+   */
+  inline void setThreadName( const std::string &name )
+  {
+#if defined( _WIN32 )
+    const std::wstring wide( name.begin(), name.end() );
+    SetThreadDescription( GetCurrentThread(), wide.c_str() );
+#elif defined( __APPLE__ )
+    pthread_setname_np( name.c_str() );
+#else
+    /*------------------------------------------------
+    Linux limits thread names to 15 characters + null
+    ------------------------------------------------*/
+    pthread_setname_np( pthread_self(), name.substr( 0, 15 ).c_str() );
+#endif
+  }
+}    // namespace Sim::Platform
+
+#endif /* !RF24_SIM_PLATFORM_HPP */
@@ -0,0 +1,210 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_priority.cpp
+ *
+ *  Description:
+ *    Priority transmit scheduler implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <cstring>
+
+/* Chimera Includes */
+#include <Chimera/common>
+
+/* Dev Includes */
+#include <sim_clock.hpp>
+#include <sim_priority.hpp>
+
+namespace Sim::Priority
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t DefaultSlots = 32;
+  static constexpr size_t DefaultBurst = 4;
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  Config defaultConfig()
+  {
+    Config cfg;
+
+    cfg.policy  = Policy::STRICT;
+    cfg.slots   = { DefaultSlots, DefaultSlots, DefaultSlots, DefaultSlots };
+    cfg.weights = { 1, 8, 4, 1 };
+    cfg.burst   = DefaultBurst;
+
+    return cfg;
+  }
+
+  const char *toString( const Level level )
+  {
+    switch ( level )
+    {
+      case Level::ALARM:
+        return "alarm";
+
+      case Level::CONTROL:
+        return "control";
+
+      case Level::NORMAL:
+        return "normal";
+
+      case Level::BULK:
+        return "bulk";
+
+      default:
+        return "unknown";
+    }
+  }
+
+  /*-------------------------------------------------------------------------------
+  Scheduler Implementation
+  -------------------------------------------------------------------------------*/
+  Scheduler::Scheduler( RF24::Endpoint::Interface_sPtr device, const Config &cfg ) :
+      mDevice( device ), mConfig( cfg ), mStats{}
+  {
+    for ( size_t x = 0; x < NUM_LEVELS; x++ )
+    {
+      mConfig.slots[ x ]   = std::max<size_t>( mConfig.slots[ x ], 1 );
+      mConfig.weights[ x ] = std::max<size_t>( mConfig.weights[ x ], 1 );
+
+      mQueues[ x ].ring.resize( mConfig.slots[ x ] );
+      mQueues[ x ].head   = 0;
+      mQueues[ x ].count  = 0;
+      mQueues[ x ].credit = mConfig.weights[ x ];
+    }
+  }
+
+  bool Scheduler::write( const RF24::LogicalAddress destination, const void *data, const size_t length, const Level level )
+  {
+    if ( !data || !length || ( length > FRAME_SIZE ) || ( level >= Level::NUM_OPTIONS ) )
+    {
+      return false;
+    }
+
+    const size_t index = static_cast<size_t>( level );
+    Queue &queue       = mQueues[ index ];
+    LevelStats &stats  = mStats.levels[ index ];
+
+    if ( queue.count == queue.ring.size() )
+    {
+      stats.rejected++;
+      return false;
+    }
+
+    Entry &entry      = queue.ring[ ( queue.head + queue.count ) % queue.ring.size() ];
+    entry.destination = destination;
+    entry.length      = length;
+    entry.queuedUs    = Clock::micros();
+    memcpy( entry.data.data(), data, length );
+
+    queue.count++;
+    stats.queued++;
+    stats.peakDepth = std::max( stats.peakDepth, queue.count );
+    return true;
+  }
+
+  size_t Scheduler::process()
+  {
+    const uint64_t now = Clock::micros();
+    size_t moved       = 0;
+
+    while ( !mConfig.burst || ( moved < mConfig.burst ) )
+    {
+      Queue *queue = select();
+      if ( !queue )
+      {
+        break;
+      }
+
+      const Entry &entry = queue->ring[ queue->head ];
+      if ( mDevice->write( entry.destination, entry.data.data(), entry.length ) != Chimera::CommonStatusCodes::OK )
+      {
+        break;
+      }
+
+      LevelStats &stats = mStats.levels[ queue - mQueues.data() ];
+      stats.sent++;
+      stats.maxWaitUs = std::max( stats.maxWaitUs, now - entry.queuedUs );
+
+      queue->head = ( queue->head + 1 ) % queue->ring.size();
+      queue->count--;
+      queue->credit -= std::min<size_t>( queue->credit, 1 );
+      moved++;
+    }
+
+    return moved;
+  }
+
+  bool Scheduler::pendingTx() const
+  {
+    return std::any_of( mQueues.begin(), mQueues.end(), []( const Queue &queue ) { return queue.count != 0; } );
+  }
+
+  size_t Scheduler::depth( const Level level ) const
+  {
+    return ( level < Level::NUM_OPTIONS ) ? mQueues[ static_cast<size_t>( level ) ].count : 0;
+  }
+
+  Stats Scheduler::getStats() const
+  {
+    return mStats;
+  }
+
+  Scheduler::Queue *Scheduler::select()
+  {
+    /*------------------------------------------------
+    Alarms never wait on anything else, whatever the
+    policy. Under STRICT neither does any other level.
+    ------------------------------------------------*/
+    const size_t alarm = static_cast<size_t>( Level::ALARM );
+
+    if ( mQueues[ alarm ].count )
+    {
+      return &mQueues[ alarm ];
+    }
+
+    if ( mConfig.policy == Policy::STRICT )
+    {
+      for ( Queue &queue : mQueues )
+      {
+        if ( queue.count )
+        {
+          return &queue;
+        }
+      }
+
+      return nullptr;
+    }
+
+    /*------------------------------------------------
+    Each round a level may send up to its weight before
+    a lower one is starved of its own share. The round
+    ends once every level with data has used its credit.
+    ------------------------------------------------*/
+    for ( size_t round = 0; round < 2; round++ )
+    {
+      for ( size_t x = alarm + 1; x < NUM_LEVELS; x++ )
+      {
+        if ( mQueues[ x ].count && mQueues[ x ].credit )
+        {
+          return &mQueues[ x ];
+        }
+      }
+
+      for ( size_t x = alarm + 1; x < NUM_LEVELS; x++ )
+      {
+        mQueues[ x ].credit = mConfig.weights[ x ];
+      }
+    }
+
+    return nullptr;
+  }
+
+}    // namespace Sim::Priority
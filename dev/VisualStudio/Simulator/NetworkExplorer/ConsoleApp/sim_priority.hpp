@@ -0,0 +1,193 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_priority.hpp
+ *
+ *  Description:
+ *    Priority classes in front of an endpoint's transmit queue. The endpoint
+ *    sends strictly first in first out, so a burst of bulk data sitting in it
+ *    delays whatever urgent message is written next. A Scheduler holds each
+ *    class in its own bounded queue and only releases a limited number of
+ *    frames to the endpoint per pass, picking the next one by strict priority
+ *    or by weight.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_PRIORITY_HPP
+#define RF24_SIM_PRIORITY_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+#include <RF24Node/endpoint>
+
+/* Dev Includes */
+#include <sim_endpoint.hpp>
+
+namespace Sim::Priority
+{
+  /*-------------------------------------------------------------------------------
+  Enumerations
+  -------------------------------------------------------------------------------*/
+  enum class Level : uint8_t
+  {
+    ALARM,    /**< Always sent first, under either policy */
+    CONTROL,  /**< Connection handshakes, pings and other network housekeeping */
+    NORMAL,
+    BULK,     /**< Telemetry and anything else that can wait */
+
+    NUM_OPTIONS
+  };
+
+  enum class Policy : uint8_t
+  {
+    STRICT,   /**< Highest non-empty level always goes next */
+    WEIGHTED  /**< Alarms go first, the rest share the endpoint in proportion to their weight */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t NUM_LEVELS = static_cast<size_t>( Level::NUM_OPTIONS );
+  static constexpr size_t FRAME_SIZE = Endpoint::MAX_PAYLOAD_SIZE; /**< Bytes of a frame left after the network header */
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct Config
+  {
+    Policy policy;
+    std::array<size_t, NUM_LEVELS> slots;   /**< Messages each level may hold before write() refuses more */
+    std::array<size_t, NUM_LEVELS> weights; /**< Share of each pass per level, WEIGHTED only, alarms ignore it */
+    size_t burst;                           /**< Frames handed to the endpoint per process() call, 0 for no limit */
+  };
+
+  struct LevelStats
+  {
+    size_t queued;      /**< Messages accepted by write() */
+    size_t sent;        /**< Messages handed to the endpoint */
+    size_t rejected;    /**< Messages refused because the level was full */
+    size_t peakDepth;   /**< Most messages waiting at once */
+    uint64_t maxWaitUs; /**< Longest time a message waited to reach the endpoint */
+  };
+
+  struct Stats
+  {
+    std::array<LevelStats, NUM_LEVELS> levels;
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Not thread safe. Every call must come from whichever thread is servicing
+   *  the endpoint. Only the transmit side is handled here, received data is
+   *  still read straight from the endpoint.
+   */
+  class Scheduler
+  {
+  public:
+    /**
+     *  @param[in]  device    Configured endpoint to send through
+     *  @param[in]  cfg       Scheduler settings
+     */
+    Scheduler( RF24::Endpoint::Interface_sPtr device, const Config &cfg );
+
+    Scheduler( const Scheduler & ) = delete;
+    Scheduler &operator=( const Scheduler & ) = delete;
+
+    /**
+     *  Queues a message at the given priority. Nothing is sent until the next
+     *  call to process().
+     *
+     *  @param[in]  destination   Node to deliver the message to
+     *  @param[in]  data          Message to send
+     *  @param[in]  length        Bytes in the message, up to FRAME_SIZE
+     *  @param[in]  level         Priority of the message
+     *  @return bool              True if accepted, false if the level has no free slots
+     */
+    bool write( const RF24::LogicalAddress destination, const void *data, const size_t length, const Level level );
+
+    /**
+     *  Moves up to one burst of queued messages into the endpoint, highest
+     *  priority first. Call it after every Endpoint::doAsyncProcessing() so
+     *  the endpoint's own queue never holds more than a burst.
+     *
+     *  @return size_t        Frames handed to the endpoint
+     */
+    size_t process();
+
+    /**
+     *  Checks if any messages are still waiting in the scheduler
+     *
+     *  @return bool
+     */
+    bool pendingTx() const;
+
+    /**
+     *  @param[in]  level     Level to query
+     *  @return size_t        Messages waiting at that level
+     */
+    size_t depth( const Level level ) const;
+
+    /**
+     *  @return Stats
+     */
+    Stats getStats() const;
+
+  private:
+    struct Entry
+    {
+      RF24::LogicalAddress destination;
+      size_t length;
+      uint64_t queuedUs;
+      std::array<uint8_t, FRAME_SIZE> data;
+    };
+
+    struct Queue
+    {
+      std::vector<Entry> ring;  /**< One entry per slot, allocated up front */
+      size_t head;
+      size_t count;
+      size_t credit;            /**< Sends left for this level in the current weighted round */
+    };
+
+    RF24::Endpoint::Interface_sPtr mDevice;
+    Config mConfig;
+    Stats mStats;
+    std::array<Queue, NUM_LEVELS> mQueues;
+
+    Queue *select();
+  };
+
+  using Scheduler_uPtr = std::unique_ptr<Scheduler>;
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Settings that keep the endpoint's queue short and favour control traffic
+   *  over normal and normal over bulk
+   *
+   *  @return Config
+   */
+  Config defaultConfig();
+
+  /**
+   *  Short lowercase name of a level, as used in scenario files
+   *
+   *  @param[in]  level     Level to name
+   *  @return const char *
+   */
+  const char *toString( const Level level );
+
+}    // namespace Sim::Priority
+
+#endif /* !RF24_SIM_PRIORITY_HPP */
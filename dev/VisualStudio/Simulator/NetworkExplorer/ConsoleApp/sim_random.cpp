@@ -0,0 +1,85 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_random.cpp
+ *
+ *  Description:
+ *    Seeded randomness implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <random>
+
+/* Dev Includes */
+#include <sim_random.hpp>
+
+namespace Sim::Random
+{
+  /*-------------------------------------------------------------------------------
+  Private Data
+  -------------------------------------------------------------------------------*/
+  static std::atomic<uint64_t> s_seed( DEFAULT_SEED );
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  SplitMix64 finalizer. Spreads nearby seed/stream pairs across the whole
+   *  64-bit space so the derived generators don't start out correlated.
+   */
+  static uint64_t mix( uint64_t value )
+  {
+    value += 0x9E3779B97F4A7C15ull;
+    value = ( value ^ ( value >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+    value = ( value ^ ( value >> 27 ) ) * 0x94D049BB133111EBull;
+    return value ^ ( value >> 31 );
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  void setSeed( const uint64_t seed )
+  {
+    s_seed = seed;
+  }
+
+  uint64_t getSeed()
+  {
+    return s_seed;
+  }
+
+  uint64_t deriveSeed( const uint64_t stream )
+  {
+    return deriveSeed( s_seed, stream );
+  }
+
+  uint64_t deriveSeed( const uint64_t seed, const uint64_t stream )
+  {
+    return mix( mix( seed ) ^ stream );
+  }
+
+  std::vector<size_t> permutation( const size_t count, const uint64_t stream )
+  {
+    std::vector<size_t> order( count );
+    std::iota( order.begin(), order.end(), 0 );
+
+    /*------------------------------------------------
+    std::shuffle's algorithm is implementation defined,
+    so do the Fisher-Yates walk by hand to get the same
+    order from every standard library.
+    ------------------------------------------------*/
+    std::mt19937_64 rng( deriveSeed( stream ) );
+
+    for ( size_t x = count; x > 1; x-- )
+    {
+      std::swap( order[ x - 1 ], order[ rng() % x ] );
+    }
+
+    return order;
+  }
+
+}    // namespace Sim::Random
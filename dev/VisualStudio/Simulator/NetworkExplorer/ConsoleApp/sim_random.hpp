@@ -0,0 +1,81 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_random.hpp
+ *
+ *  Description:
+ *    Single source of randomness for the simulator. Every random decision
+ *    (link loss, transmit jitter, node start order) draws from a stream
+ *    derived from one seed, so a run can be reproduced exactly.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_RANDOM_HPP
+#define RF24_SIM_RANDOM_HPP
+
+/* STL Includes */
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Sim::Random
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint64_t DEFAULT_SEED      = 0x5EED;
+  static constexpr uint64_t STREAM_CHANNEL    = 0x0100; /**< Base stream for RF channel N, i.e. STREAM_CHANNEL + N */
+  static constexpr uint64_t STREAM_BOOT_ORDER = 0x0200; /**< Order in which nodes are brought up */
+  static constexpr uint64_t STREAM_TOPOLOGY   = 0x0300; /**< Branches pruned from generated trees */
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Sets the seed every stream is derived from. Takes effect for streams
+   *  derived after the call, so set it before resetting the simulation.
+   *
+   *  @param[in]  seed      The new seed
+   *  @return void
+   */
+  void setSeed( const uint64_t seed );
+
+  /**
+   *  Gets the active seed
+   *
+   *  @return uint64_t
+   */
+  uint64_t getSeed();
+
+  /**
+   *  Derives an independent seed for one consumer of randomness. The same
+   *  seed and stream always give the same result.
+   *
+   *  @param[in]  stream    Identifies the consumer, see STREAM_xxx
+   *  @return uint64_t
+   */
+  uint64_t deriveSeed( const uint64_t stream );
+
+  /**
+   *  Same as deriveSeed( stream ), but from an explicit seed rather than the
+   *  active one. Used where the seed is known before it has been applied.
+   *
+   *  @param[in]  seed      Seed to derive from
+   *  @param[in]  stream    Identifies the consumer, see STREAM_xxx
+   *  @return uint64_t
+   */
+  uint64_t deriveSeed( const uint64_t seed, const uint64_t stream );
+
+  /**
+   *  Shuffles the indices [0, count) using the given stream
+   *
+   *  @param[in]  count     Number of indices
+   *  @param[in]  stream    Identifies the consumer, see STREAM_xxx
+   *  @return std::vector<size_t>
+   */
+  std::vector<size_t> permutation( const size_t count, const uint64_t stream );
+
+}    // namespace Sim::Random
+
+#endif /* !RF24_SIM_RANDOM_HPP */
@@ -0,0 +1,183 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_registers.cpp
+ *
+ *  Description:
+ *    NRF24L01 register shadow implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <cstring>
+
+/* Dev Includes */
+#include <sim_registers.hpp>
+
+namespace Sim::Registers
+{
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  bool isCacheable( const uint8_t reg )
+  {
+    switch ( reg )
+    {
+      case REG_STATUS:
+      case REG_OBSERVE_TX:
+      case REG_RPD:
+      case REG_FIFO_STATUS:
+        return false;
+
+      default:
+        return widthOf( reg, MAX_REGISTER_WIDTH ) != 0;
+    }
+  }
+
+  size_t widthOf( const uint8_t reg, const size_t addressWidth )
+  {
+    switch ( reg )
+    {
+      case REG_RX_ADDR_P0:
+      case REG_RX_ADDR_P1:
+      case REG_TX_ADDR:
+        return addressWidth;
+
+      case 0x18:
+      case 0x19:
+      case 0x1A:
+      case 0x1B:
+        return 0;
+
+      default:
+        return ( reg < NUM_REGISTERS ) ? 1 : 0;
+    }
+  }
+
+  /*-------------------------------------------------------------------------------
+  Shadow Implementation
+  -------------------------------------------------------------------------------*/
+  Shadow::Shadow( Bus &bus ) : mBus( bus ), mStats{}
+  {
+    invalidate();
+  }
+
+  uint8_t Shadow::read( const uint8_t reg )
+  {
+    uint8_t value = 0;
+    read( reg, &value, 1 );
+    return value;
+  }
+
+  void Shadow::read( const uint8_t reg, uint8_t *const data, const size_t length )
+  {
+    if ( !data || !length || ( length > MAX_REGISTER_WIDTH ) )
+    {
+      return;
+    }
+
+    mStats.reads++;
+
+    /*------------------------------------------------
+    An address read at a different width than it was
+    last seen at goes to the radio, SETUP_AW may have
+    changed in between.
+    ------------------------------------------------*/
+    if ( isCacheable( reg ) )
+    {
+      Entry &entry = mEntries[ reg ];
+
+      if ( entry.valid && ( entry.length == length ) )
+      {
+        memcpy( data, entry.data.data(), length );
+        mStats.readHits++;
+        return;
+      }
+
+      mBus.readRegister( reg, data, length );
+
+      entry.valid  = true;
+      entry.length = static_cast<uint8_t>( length );
+      memcpy( entry.data.data(), data, length );
+      return;
+    }
+
+    mBus.readRegister( reg, data, length );
+  }
+
+  void Shadow::write( const uint8_t reg, const uint8_t value )
+  {
+    write( reg, &value, 1 );
+  }
+
+  void Shadow::write( const uint8_t reg, const uint8_t *const data, const size_t length )
+  {
+    if ( !data || !length || ( length > MAX_REGISTER_WIDTH ) )
+    {
+      return;
+    }
+
+    mStats.writes++;
+
+    /*------------------------------------------------
+    Writes to STATUS clear interrupt flags, so anything
+    the radio changes on its own always goes through.
+    ------------------------------------------------*/
+    if ( !isCacheable( reg ) )
+    {
+      mBus.writeRegister( reg, data, length );
+      return;
+    }
+
+    Entry &entry = mEntries[ reg ];
+
+    if ( entry.valid && ( entry.length == length ) && ( memcmp( entry.data.data(), data, length ) == 0 ) )
+    {
+      mStats.writesSkipped++;
+      return;
+    }
+
+    mBus.writeRegister( reg, data, length );
+
+    entry.valid  = true;
+    entry.length = static_cast<uint8_t>( length );
+    memcpy( entry.data.data(), data, length );
+  }
+
+  void Shadow::update( const uint8_t reg, const uint8_t mask, const uint8_t value )
+  {
+    const uint8_t current = read( reg );
+    write( reg, static_cast<uint8_t>( ( current & ~mask ) | ( value & mask ) ) );
+  }
+
+  void Shadow::prime()
+  {
+    const size_t addressWidth = std::clamp<size_t>( read( REG_SETUP_AW ) + 2u, 3, MAX_REGISTER_WIDTH );
+    std::array<uint8_t, MAX_REGISTER_WIDTH> scratch;
+
+    for ( uint8_t reg = 0; reg < NUM_REGISTERS; reg++ )
+    {
+      if ( isCacheable( reg ) )
+      {
+        read( reg, scratch.data(), widthOf( reg, addressWidth ) );
+      }
+    }
+  }
+
+  void Shadow::invalidate()
+  {
+    for ( Entry &entry : mEntries )
+    {
+      entry.valid  = false;
+      entry.length = 0;
+      entry.data.fill( 0 );
+    }
+  }
+
+  Stats Shadow::getStats() const
+  {
+    return mStats;
+  }
+
+}    // namespace Sim::Registers
@@ -0,0 +1,243 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_registers.hpp
+ *
+ *  Description:
+ *    NRF24L01 register map and a write-through shadow of its configuration
+ *    registers. Everything but STATUS, OBSERVE_TX, RPD and FIFO_STATUS only
+ *    changes when the driver itself writes it, so once a value is known a
+ *    read can be answered from RAM and a write of the same value skipped,
+ *    saving an SPI transaction either way. The shadow sits between the
+ *    driver's register accessors and whatever carries them over the bus.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_REGISTERS_HPP
+#define RF24_SIM_REGISTERS_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Sim::Registers
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint8_t REG_CONFIG      = 0x00;
+  static constexpr uint8_t REG_EN_AA       = 0x01;
+  static constexpr uint8_t REG_EN_RXADDR   = 0x02;
+  static constexpr uint8_t REG_SETUP_AW    = 0x03;
+  static constexpr uint8_t REG_SETUP_RETR  = 0x04;
+  static constexpr uint8_t REG_RF_CH       = 0x05;
+  static constexpr uint8_t REG_RF_SETUP    = 0x06;
+  static constexpr uint8_t REG_STATUS      = 0x07; /**< Changed by the radio itself */
+  static constexpr uint8_t REG_OBSERVE_TX  = 0x08; /**< Changed by the radio itself */
+  static constexpr uint8_t REG_RPD         = 0x09; /**< Changed by the radio itself */
+  static constexpr uint8_t REG_RX_ADDR_P0  = 0x0A;
+  static constexpr uint8_t REG_RX_ADDR_P1  = 0x0B;
+  static constexpr uint8_t REG_RX_ADDR_P2  = 0x0C;
+  static constexpr uint8_t REG_RX_ADDR_P3  = 0x0D;
+  static constexpr uint8_t REG_RX_ADDR_P4  = 0x0E;
+  static constexpr uint8_t REG_RX_ADDR_P5  = 0x0F;
+  static constexpr uint8_t REG_TX_ADDR     = 0x10;
+  static constexpr uint8_t REG_RX_PW_P0    = 0x11;
+  static constexpr uint8_t REG_RX_PW_P1    = 0x12;
+  static constexpr uint8_t REG_RX_PW_P2    = 0x13;
+  static constexpr uint8_t REG_RX_PW_P3    = 0x14;
+  static constexpr uint8_t REG_RX_PW_P4    = 0x15;
+  static constexpr uint8_t REG_RX_PW_P5    = 0x16;
+  static constexpr uint8_t REG_FIFO_STATUS = 0x17; /**< Changed by the radio itself */
+  static constexpr uint8_t REG_DYNPD       = 0x1C;
+  static constexpr uint8_t REG_FEATURE     = 0x1D;
+  static constexpr size_t NUM_REGISTERS    = 0x1E;
+
+  static constexpr uint8_t CMD_R_REGISTER         = 0x00; /**< OR'd with the register address */
+  static constexpr uint8_t CMD_W_REGISTER         = 0x20; /**< OR'd with the register address */
+  static constexpr uint8_t CMD_REGISTER_MASK      = 0x1F;
+  static constexpr uint8_t CMD_R_RX_PL_WID        = 0x60;
+  static constexpr uint8_t CMD_R_RX_PAYLOAD       = 0x61;
+  static constexpr uint8_t CMD_W_TX_PAYLOAD       = 0xA0;
+  static constexpr uint8_t CMD_W_ACK_PAYLOAD      = 0xA8; /**< OR'd with the pipe number */
+  static constexpr uint8_t CMD_W_TX_PAYLOAD_NOACK = 0xB0;
+  static constexpr uint8_t CMD_FLUSH_TX           = 0xE1;
+  static constexpr uint8_t CMD_FLUSH_RX           = 0xE2;
+  static constexpr uint8_t CMD_REUSE_TX_PL        = 0xE3;
+  static constexpr uint8_t CMD_NOP                = 0xFF;
+
+  static constexpr uint8_t CONFIG_MASK_RX_DR  = 0x40;
+  static constexpr uint8_t CONFIG_MASK_TX_DS  = 0x20;
+  static constexpr uint8_t CONFIG_MASK_MAX_RT = 0x10;
+  static constexpr uint8_t CONFIG_EN_CRC      = 0x08;
+  static constexpr uint8_t CONFIG_CRCO        = 0x04;
+  static constexpr uint8_t CONFIG_PWR_UP      = 0x02;
+  static constexpr uint8_t CONFIG_PRIM_RX     = 0x01;
+
+  static constexpr uint8_t RF_SETUP_RF_DR_LOW  = 0x20;
+  static constexpr uint8_t RF_SETUP_RF_DR_HIGH = 0x08;
+
+  static constexpr uint8_t STATUS_RX_DR      = 0x40;
+  static constexpr uint8_t STATUS_TX_DS      = 0x20;
+  static constexpr uint8_t STATUS_MAX_RT     = 0x10;
+  static constexpr uint8_t STATUS_RX_P_NO    = 0x0E;
+  static constexpr uint8_t STATUS_TX_FULL    = 0x01;
+  static constexpr uint8_t STATUS_IRQ_FLAGS  = STATUS_RX_DR | STATUS_TX_DS | STATUS_MAX_RT;
+
+  static constexpr uint8_t FIFO_STATUS_TX_REUSE = 0x40;
+  static constexpr uint8_t FIFO_STATUS_TX_FULL  = 0x20;
+  static constexpr uint8_t FIFO_STATUS_TX_EMPTY = 0x10;
+  static constexpr uint8_t FIFO_STATUS_RX_FULL  = 0x02;
+  static constexpr uint8_t FIFO_STATUS_RX_EMPTY = 0x01;
+
+  static constexpr uint8_t FEATURE_EN_DPL     = 0x04;
+  static constexpr uint8_t FEATURE_EN_ACK_PAY = 0x02;
+  static constexpr uint8_t FEATURE_EN_DYN_ACK = 0x01;
+
+  static constexpr size_t MAX_REGISTER_WIDTH = 5; /**< RX_ADDR_P0, RX_ADDR_P1 and TX_ADDR at the full address width */
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct Stats
+  {
+    size_t reads;         /**< Register reads asked of the shadow */
+    size_t readHits;      /**< Reads answered without touching the bus */
+    size_t writes;        /**< Register writes asked of the shadow */
+    size_t writesSkipped; /**< Writes dropped because the register already held the value */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Whatever actually moves register contents to and from the radio, one SPI
+   *  transaction per call
+   */
+  class Bus
+  {
+  public:
+    virtual ~Bus() = default;
+
+    /**
+     *  @param[in]  reg       Register address
+     *  @param[out] data      Where to put the register contents
+     *  @param[in]  length    Bytes to read, LSB first for multi-byte registers
+     */
+    virtual void readRegister( const uint8_t reg, uint8_t *const data, const size_t length ) = 0;
+
+    /**
+     *  @param[in]  reg       Register address
+     *  @param[in]  data      New register contents
+     *  @param[in]  length    Bytes to write, LSB first for multi-byte registers
+     */
+    virtual void writeRegister( const uint8_t reg, const uint8_t *const data, const size_t length ) = 0;
+  };
+
+  /**
+   *  Not thread safe, it belongs to the one driver that owns the radio. The
+   *  shadow starts out empty and learns each register the first time it is
+   *  read or written. Anything that changes the radio behind the driver's
+   *  back, a power cycle in particular, must be followed by invalidate().
+   */
+  class Shadow
+  {
+  public:
+    /**
+     *  @param[in]  bus       Carries every access the shadow can't answer
+     */
+    explicit Shadow( Bus &bus );
+
+    Shadow( const Shadow & ) = delete;
+    Shadow &operator=( const Shadow & ) = delete;
+
+    /**
+     *  @param[in]  reg       Register address
+     *  @return uint8_t       Register contents
+     */
+    uint8_t read( const uint8_t reg );
+
+    /**
+     *  @param[in]  reg       Register address
+     *  @param[out] data      Where to put the register contents
+     *  @param[in]  length    Bytes to read, up to MAX_REGISTER_WIDTH
+     */
+    void read( const uint8_t reg, uint8_t *const data, const size_t length );
+
+    /**
+     *  @param[in]  reg       Register address
+     *  @param[in]  value     New register contents
+     */
+    void write( const uint8_t reg, const uint8_t value );
+
+    /**
+     *  @param[in]  reg       Register address
+     *  @param[in]  data      New register contents
+     *  @param[in]  length    Bytes to write, up to MAX_REGISTER_WIDTH
+     */
+    void write( const uint8_t reg, const uint8_t *const data, const size_t length );
+
+    /**
+     *  Read-modify-write of the bits in mask, which only touches the bus for
+     *  the write and only if the bits actually change
+     *
+     *  @param[in]  reg       Register address
+     *  @param[in]  mask      Bits to update
+     *  @param[in]  value     New state of those bits
+     */
+    void update( const uint8_t reg, const uint8_t mask, const uint8_t value );
+
+    /**
+     *  Reads every configuration register once so later reads never miss
+     */
+    void prime();
+
+    /**
+     *  Forgets everything, e.g. after the radio has been power cycled
+     */
+    void invalidate();
+
+    /**
+     *  @return Stats
+     */
+    Stats getStats() const;
+
+  private:
+    struct Entry
+    {
+      bool valid;
+      uint8_t length;
+      std::array<uint8_t, MAX_REGISTER_WIDTH> data;
+    };
+
+    Bus &mBus;
+    Stats mStats;
+    std::array<Entry, NUM_REGISTERS> mEntries;
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Checks if a register only changes when it is written, which makes it
+   *  safe to shadow
+   *
+   *  @param[in]  reg       Register address
+   *  @return bool
+   */
+  bool isCacheable( const uint8_t reg );
+
+  /**
+   *  Width of a register at the given address width
+   *
+   *  @param[in]  reg           Register address
+   *  @param[in]  addressWidth  Bytes per pipe address, 3 to 5
+   *  @return size_t            Zero for addresses that aren't registers
+   */
+  size_t widthOf( const uint8_t reg, const size_t addressWidth );
+
+}    // namespace Sim::Registers
+
+#endif /* !RF24_SIM_REGISTERS_HPP */
@@ -0,0 +1,110 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_routing.cpp
+ *
+ *  Description:
+ *    Next hop table implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* RF24 Includes */
+#include <RF24Node/src/common/utility.hpp>
+
+/* Dev Includes */
+#include <sim_routing.hpp>
+
+namespace Sim::Routing
+{
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  RF24::LogicalAddress referenceNextHop( const RF24::LogicalAddress self, const RF24::LogicalAddress destination )
+  {
+    if ( !RF24::isAddressValid( self ) || !RF24::isAddressValid( destination ) )
+    {
+      return RF24::Network::RSVD_ADDR_INVALID;
+    }
+
+    if ( ( destination == self ) || ( RF24::isAddressRoot( destination ) && RF24::isAddressRoot( self ) ) )
+    {
+      return self;
+    }
+
+    if ( RF24::isDescendent( self, destination ) )
+    {
+      return RF24::getAddressAtLevel( destination, RF24::getLevel( self ) + 1 );
+    }
+
+    return RF24::getParent( self );
+  }
+
+  /*-------------------------------------------------------------------------------
+  NextHopTable Implementation
+  -------------------------------------------------------------------------------*/
+  NextHopTable::NextHopTable()
+  {
+    build( RF24::Network::RSVD_ADDR_INVALID );
+  }
+
+  NextHopTable::NextHopTable( const RF24::LogicalAddress self )
+  {
+    build( self );
+  }
+
+  bool NextHopTable::build( const RF24::LogicalAddress self )
+  {
+    const RF24::LogicalLevel level = RF24::getLevel( self );
+
+    mChildren.fill( RF24::Network::RSVD_ADDR_INVALID );
+
+    /*------------------------------------------------
+    An empty prefix with every entry invalid matches any
+    destination and sends it nowhere.
+    ------------------------------------------------*/
+    if ( !RF24::isAddressValid( self ) || ( level > RF24::NODE_LEVEL_MAX ) )
+    {
+      mPrefix     = 0;
+      mPrefixMask = 0;
+      mShift      = 0;
+      mParent     = RF24::Network::RSVD_ADDR_INVALID;
+      return false;
+    }
+
+    /*------------------------------------------------
+    Every spelling of the root collapses onto RootNode0
+    so its prefix is empty and matches everything.
+    ------------------------------------------------*/
+    mPrefix     = RF24::getAddressAtLevel( self, level );
+    mShift      = static_cast<uint16_t>( level * BITS_PER_LEVEL );
+    mPrefixMask = static_cast<RF24::LogicalAddress>( ( 1u << mShift ) - 1u );
+    mParent     = RF24::getParent( self );
+
+    mChildren[ 0 ] = mPrefix;
+
+    /*------------------------------------------------
+    Let getChild() decide which digit each bind site
+    maps to rather than assume the enum's ordering.
+    ------------------------------------------------*/
+    const auto first = static_cast<size_t>( RF24::Connection::BindSite::FIRST );
+    const auto last  = static_cast<size_t>( RF24::Connection::BindSite::LAST );
+
+    for ( size_t site = first; site <= last; site++ )
+    {
+      const RF24::LogicalAddress child = RF24::getChild( mPrefix, static_cast<RF24::Connection::BindSite>( site ) );
+
+      if ( RF24::isAddressValid( child ) )
+      {
+        mChildren[ ( child >> mShift ) & DIGIT_MASK ] = child;
+      }
+    }
+
+    return true;
+  }
+
+  RF24::LogicalAddress NextHopTable::self() const
+  {
+    return mChildren[ 0 ];
+  }
+
+}    // namespace Sim::Routing
@@ -0,0 +1,119 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_routing.hpp
+ *
+ *  Description:
+ *    Next hop lookup for frames passing through a router. The tree address
+ *    already spells out the path to every node, so everything a router needs
+ *    to forward a frame can be worked out once from its own address: the
+ *    prefix its descendants share, which digit selects the child, and where
+ *    everything else goes. Forwarding then costs a mask, a compare and an
+ *    eight entry table read instead of walking the address level by level.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_ROUTING_HPP
+#define RF24_SIM_ROUTING_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+
+namespace Sim::Routing
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t BITS_PER_LEVEL = 3; /**< Each level of the tree is one octal digit */
+  static constexpr size_t DIGITS         = 1u << BITS_PER_LEVEL;
+  static constexpr uint16_t DIGIT_MASK   = static_cast<uint16_t>( DIGITS - 1 );
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Answers the same question as referenceNextHop() for any valid destination.
+   *  Reserved and invalid destinations must be filtered out before the lookup,
+   *  just as they are before the reference is called.
+   */
+  class NextHopTable
+  {
+  public:
+    /**
+     *  Builds a table that routes nothing, every lookup gives RSVD_ADDR_INVALID
+     */
+    NextHopTable();
+
+    /**
+     *  @param[in]  self      Address of the router the table is built for
+     */
+    explicit NextHopTable( const RF24::LogicalAddress self );
+
+    /**
+     *  Rebuilds the table for a new address, e.g. once the node has joined
+     *
+     *  @param[in]  self      Address of the router, may be invalid
+     *  @return bool          True if the address was valid and the table is usable
+     */
+    bool build( const RF24::LogicalAddress self );
+
+    /**
+     *  Works out where to send a frame next. This is the forwarding hot path,
+     *  so it lives here where the compiler can inline it.
+     *
+     *  @param[in]  destination   Final destination of the frame
+     *  @return RF24::LogicalAddress  This node if the frame has arrived, one of its
+     *                                children, its parent, or RSVD_ADDR_INVALID if
+     *                                the frame can't be routed from here
+     */
+    inline RF24::LogicalAddress nextHop( const RF24::LogicalAddress destination ) const
+    {
+      /*------------------------------------------------
+      Only this node and its descendants share its digits.
+      The digit right after them names the child to use,
+      or is zero when the frame is for this node.
+      ------------------------------------------------*/
+      if ( ( destination & mPrefixMask ) != mPrefix )
+      {
+        return mParent;
+      }
+
+      return mChildren[ ( destination >> mShift ) & DIGIT_MASK ];
+    }
+
+    /**
+     *  @return RF24::LogicalAddress  Address the table was built for
+     */
+    RF24::LogicalAddress self() const;
+
+  private:
+    RF24::LogicalAddress mPrefix;     /**< This node's address, which every descendant starts with */
+    RF24::LogicalAddress mPrefixMask; /**< Bits making up the prefix */
+    RF24::LogicalAddress mParent;     /**< Everything that isn't a descendant goes here */
+    uint16_t mShift;                  /**< Position of the digit just below this node */
+    std::array<RF24::LogicalAddress, DIGITS> mChildren; /**< Indexed by that digit, zero means this node */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Routing decision as it's made today, by walking the address with the
+   *  common utility functions. Kept as the reference the table is checked
+   *  and benchmarked against.
+   *
+   *  @param[in]  self          Address of the router
+   *  @param[in]  destination   Final destination of the frame
+   *  @return RF24::LogicalAddress
+   */
+  RF24::LogicalAddress referenceNextHop( const RF24::LogicalAddress self, const RF24::LogicalAddress destination );
+
+}    // namespace Sim::Routing
+
+#endif /* !RF24_SIM_ROUTING_HPP */
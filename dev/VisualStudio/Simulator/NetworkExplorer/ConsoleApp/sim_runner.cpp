@@ -0,0 +1,1059 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_runner.cpp
+ *
+ *  Description:
+ *    Headless scenario runner implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+/* Chimera Includes */
+#include <Chimera/common>
+
+/* RF24 Includes */
+#include <RF24Node/src/common/utility.hpp>
+
+/* Dev Includes */
+#include <sim_clock.hpp>
+#include <sim_endpoint.hpp>
+#include <sim_priority.hpp>
+#include <sim_random.hpp>
+#include <sim_runner.hpp>
+#include <sim_transport.hpp>
+
+namespace Sim
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t ConnectTimeout  = 10000;
+  static constexpr size_t ConnectPollRate = 10;
+  static constexpr size_t ConnectRetry    = 500;
+  static constexpr size_t AsyncUpdateRate = 50;
+  static constexpr size_t SendBurst       = 32;      /**< Back to back messages queued per service call */
+  static constexpr size_t SendRetry       = 1;       /**< Delay (ms) before retrying a full queue or window */
+  static constexpr uint64_t WindowTimeout = 1000000; /**< Time (us) before a stalled window presumes a loss */
+  static constexpr size_t CompactWindow   = 128;     /**< In flight limit for single byte messages */
+  static constexpr size_t FragmentSlots   = 4;       /**< Messages each node can reassemble at once */
+  static constexpr size_t FragmentTimeout = 1000;    /**< Time (ms) a partial message may go without a new fragment */
+  static constexpr size_t ReliableMinRto  = 10;      /**< Lower bound (ms) on the transport's retransmit timeout */
+  static constexpr size_t ReliableMaxRto  = 2000;    /**< Upper bound (ms) on the transport's retransmit timeout */
+
+  /*-------------------------------------------------------------------------------
+  Private Data
+  -------------------------------------------------------------------------------*/
+  /*------------------------------------------------
+  Connection callbacks are plain function pointers, so
+  they find their way back through the active runner.
+  ------------------------------------------------*/
+  static std::vector<RF24::Connection::Result> *s_connectResults = nullptr;
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  static void onConnectComplete( RF24::Connection::Result result, RF24::Connection::BindSite )
+  {
+    const NodeId node = Executor::activeNode();
+
+    if ( s_connectResults && ( node != INVALID_NODE ) )
+    {
+      ( *s_connectResults )[ node ] = result;
+    }
+  }
+
+  static uint64_t percentile( const std::vector<uint64_t> &sorted, const double fraction )
+  {
+    if ( sorted.empty() )
+    {
+      return 0;
+    }
+
+    const size_t rank = static_cast<size_t>( fraction * static_cast<double>( sorted.size() - 1 ) + 0.5 );
+    return sorted[ std::min( rank, sorted.size() - 1 ) ];
+  }
+
+  /*-------------------------------------------------------------------------------
+  ScenarioRunner Implementation
+  -------------------------------------------------------------------------------*/
+  ScenarioRunner::ScenarioRunner( const Scenario::Description &desc ) :
+      mDesc( desc ), mConnected( 0 ), mFormedAtMs( 0 ), mLevels{}
+  {
+  }
+
+  ScenarioRunner::~ScenarioRunner()
+  {
+    if ( mExecutor )
+    {
+      mExecutor->stop();
+    }
+  }
+
+  ScenarioReport ScenarioRunner::run()
+  {
+    static std::vector<RF24::Connection::Result> connectResults;
+
+    ExecutorConfig execCfg;
+    execCfg.workers          = mDesc.workers;
+    execCfg.workStealing     = true;
+    execCfg.housekeepingRate = AsyncUpdateRate;
+
+    /*------------------------------------------------
+    A seed only fixes the simulator's random streams.
+    The clock stays in REAL_TIME, as the endpoints time
+    their work on the host clock, so thread scheduling
+    and therefore the results still vary between runs.
+    ------------------------------------------------*/
+    if ( mDesc.seeded )
+    {
+      Random::setSeed( mDesc.seed );
+    }
+
+    mExecutor = std::make_unique<Executor>( execCfg );
+    connectResults.assign( mDesc.nodes.size(), RF24::Connection::Result::CONNECT_PROC_UNKNOWN );
+    s_connectResults = &connectResults;
+
+    size_t maxMessage = 0;
+    for ( const Scenario::TrafficSpec &flow : mDesc.traffic )
+    {
+      maxMessage = std::max( maxMessage, flow.size );
+    }
+
+    /*------------------------------------------------
+    Create every node. The executor hands out ids in
+    order, so the id doubles as an index into mNodes.
+    ------------------------------------------------*/
+    for ( const Scenario::NodeSpec &spec : mDesc.nodes )
+    {
+      auto node            = std::make_unique<NodeState>();
+      node->spec           = spec;
+      node->parentIndex    = mDesc.nodes.size();
+      node->level          = std::min<RF24::LogicalLevel>( RF24::getLevel( spec.address ), RF24::NODE_LEVEL_5 );
+      node->stage          = Stage::BOOTING;
+      node->connectResult  = RF24::Connection::Result::CONNECT_PROC_UNKNOWN;
+      node->attempts       = 0;
+      node->firstAttemptUs = 0;
+      node->connectedUs    = 0;
+      node->compactInbound = nullptr;
+      node->compactEcho    = nullptr;
+
+      mLevels[ node->level ].nodes++;
+
+      for ( size_t x = 0; x < mDesc.nodes.size(); x++ )
+      {
+        if ( mDesc.nodes[ x ].address == spec.parent )
+        {
+          node->parentIndex = x;
+        }
+      }
+
+      node->device = RF24::Endpoint::createShared( spec.cfg );
+      node->device->configure( spec.cfg );
+      node->device->setName( spec.name );
+
+      /*------------------------------------------------
+      Streams tag every frame with a fragment header, so
+      once one node needs them every node has to use them
+      ------------------------------------------------*/
+      if ( maxMessage > Endpoint::MAX_PAYLOAD_SIZE )
+      {
+        Fragment::Config streamCfg;
+        streamCfg.address        = spec.address;
+        streamCfg.rxBuffer       = nullptr;
+        streamCfg.rxBufferSize   = FragmentSlots * maxMessage;
+        streamCfg.maxMessageSize = maxMessage;
+        streamCfg.timeoutMs      = FragmentTimeout;
+        streamCfg.streaming      = false;
+        streamCfg.compactHeaders = mDesc.compactHeaders;
+
+        node->stream = std::make_unique<Fragment::Stream>( node->device, streamCfg );
+      }
+      else if ( mDesc.transport.reliable )
+      {
+        Transport::Config transportCfg;
+        transportCfg.address      = spec.address;
+        transportCfg.window       = mDesc.transport.window;
+        transportCfg.initialRtoMs = mDesc.transport.initialRtoMs;
+        transportCfg.minRtoMs     = ReliableMinRto;
+        transportCfg.maxRtoMs     = ReliableMaxRto;
+        transportCfg.maxRetries   = mDesc.transport.maxRetries;
+
+        node->reliable = std::make_unique<Transport::Reliable>( node->device, transportCfg );
+      }
+      else if ( mDesc.scheduler.enabled )
+      {
+        node->scheduler = std::make_unique<Priority::Scheduler>( node->device, mDesc.scheduler.cfg );
+      }
+      else if ( mDesc.coalesce.enabled )
+      {
+        node->packer = std::make_unique<Coalesce::Packer>( node->device, mDesc.coalesce.cfg );
+      }
+
+      mExecutor->addNode( node->device, [ this ]( const NodeId id, RF24::Endpoint::Interface_sPtr &device ) {
+        service( id, device );
+      } );
+
+      mNodes.push_back( std::move( node ) );
+    }
+
+    /*------------------------------------------------
+    Attach each traffic flow to its source node
+    ------------------------------------------------*/
+    for ( size_t x = 0; x < mDesc.traffic.size(); x++ )
+    {
+      auto flow           = std::make_unique<Flow>();
+      flow->spec          = mDesc.traffic[ x ];
+      flow->index         = x;
+      flow->sent          = 0;
+      flow->nextSendMs    = 0;
+      flow->compact       = ( flow->spec.size < PROBE_HEADER_SIZE );
+      flow->duplicates    = 0;
+      flow->bytes         = 0;
+      flow->lastSendUs    = 0;
+      flow->lastArrivalUs = 0;
+
+      NodeState *source      = nullptr;
+      NodeState *destination = nullptr;
+
+      for ( auto &node : mNodes )
+      {
+        if ( node->spec.address == flow->spec.source )
+        {
+          node->outbound.push_back( flow.get() );
+          source = node.get();
+        }
+
+        if ( node->spec.address == flow->spec.destination )
+        {
+          destination = node.get();
+        }
+      }
+
+      /*------------------------------------------------
+      A message smaller than the probe header has no room
+      to say which flow it belongs to, so the receiving
+      node must be able to work that out on its own.
+      ------------------------------------------------*/
+      if ( flow->compact )
+      {
+        const bool inboundFree = !destination->compactInbound && !destination->compactEcho;
+        const bool echoFree    = !flow->spec.echo || ( !source->compactInbound && !source->compactEcho );
+
+        if ( inboundFree && echoFree )
+        {
+          destination->compactInbound = flow.get();
+          source->compactEcho         = flow->spec.echo ? flow.get() : source->compactEcho;
+
+          /*------------------------------------------------
+          A one byte sequence wraps every 256 messages, so
+          never let enough be in flight to make it ambiguous
+          ------------------------------------------------*/
+          if ( flow->spec.size == 1 )
+          {
+            flow->spec.window = flow->spec.window ? std::min( flow->spec.window, CompactWindow ) : CompactWindow;
+          }
+        }
+        else
+        {
+          std::cerr << "traffic flow " << x << " shares a node with another flow under " << PROBE_HEADER_SIZE
+                    << " bytes, padding it to the probe header" << std::endl;
+          flow->compact = false;
+        }
+      }
+
+      mFlows.push_back( std::move( flow ) );
+    }
+
+    /*------------------------------------------------
+    Let the simulation play out, then gather results
+    ------------------------------------------------*/
+    const size_t startMs = Clock::millis();
+    mExecutor->start();
+    Clock::delayMilliseconds( mDesc.durationMs );
+    mExecutor->stop();
+    s_connectResults = nullptr;
+
+    ScenarioReport report;
+    report.name            = mDesc.name;
+    report.nodes           = mNodes.size();
+    report.connected       = mConnected;
+    report.formationMs     = formed() ? ( mFormedAtMs - startMs ) : 0;
+    report.trafficWindowMs = formed() ? ( startMs + mDesc.durationMs - mFormedAtMs ) : 0;
+    report.seed            = Random::getSeed();
+    report.fragmented      = false;
+    report.fragments       = {};
+
+    for ( const auto &node : mNodes )
+    {
+      if ( !node->stream )
+      {
+        continue;
+      }
+
+      const Fragment::Stats stats = node->stream->getStats();
+      report.fragmented           = true;
+      report.fragments.messagesSent += stats.messagesSent;
+      report.fragments.fragmentsSent += stats.fragmentsSent;
+      report.fragments.headerBytes += stats.headerBytes;
+      report.fragments.messagesReceived += stats.messagesReceived;
+      report.fragments.fragmentsReceived += stats.fragmentsReceived;
+      report.fragments.duplicates += stats.duplicates;
+      report.fragments.timeouts += stats.timeouts;
+      report.fragments.overflows += stats.overflows;
+      report.fragments.rejected += stats.rejected;
+    }
+
+    report.reliable  = false;
+    report.transport = {};
+
+    for ( const auto &node : mNodes )
+    {
+      if ( !node->reliable )
+      {
+        continue;
+      }
+
+      const Transport::Stats stats = node->reliable->getStats();
+      report.reliable              = true;
+      report.transport.messagesSent += stats.messagesSent;
+      report.transport.messagesAcked += stats.messagesAcked;
+      report.transport.retransmits += stats.retransmits;
+      report.transport.fastRetransmits += stats.fastRetransmits;
+      report.transport.abandoned += stats.abandoned;
+      report.transport.delivered += stats.delivered;
+      report.transport.duplicates += stats.duplicates;
+      report.transport.acksSent += stats.acksSent;
+      report.transport.rejected += stats.rejected;
+    }
+
+    report.prioritized = false;
+    report.priority    = {};
+
+    for ( const auto &node : mNodes )
+    {
+      if ( !node->scheduler )
+      {
+        continue;
+      }
+
+      const Priority::Stats stats = node->scheduler->getStats();
+      report.prioritized          = true;
+
+      for ( size_t x = 0; x < Priority::NUM_LEVELS; x++ )
+      {
+        Priority::LevelStats &total = report.priority.levels[ x ];
+        total.queued += stats.levels[ x ].queued;
+        total.sent += stats.levels[ x ].sent;
+        total.rejected += stats.levels[ x ].rejected;
+        total.peakDepth = std::max( total.peakDepth, stats.levels[ x ].peakDepth );
+        total.maxWaitUs = std::max( total.maxWaitUs, stats.levels[ x ].maxWaitUs );
+      }
+    }
+
+    report.coalesced  = false;
+    report.coalescing = {};
+
+    for ( const auto &node : mNodes )
+    {
+      if ( !node->packer )
+      {
+        continue;
+      }
+
+      const Coalesce::Stats stats = node->packer->getStats();
+      report.coalesced            = true;
+      report.coalescing.messagesSent += stats.messagesSent;
+      report.coalescing.framesSent += stats.framesSent;
+      report.coalescing.framesFilled += stats.framesFilled;
+      report.coalescing.framesExpired += stats.framesExpired;
+      report.coalescing.messagesReceived += stats.messagesReceived;
+      report.coalescing.framesReceived += stats.framesReceived;
+      report.coalescing.refused += stats.refused;
+      report.coalescing.rejected += stats.rejected;
+    }
+
+    /*------------------------------------------------
+    Connection setup, broken down by depth in the tree
+    ------------------------------------------------*/
+    for ( size_t level = 0; level < mLevels.size(); level++ )
+    {
+      if ( !mLevels[ level ].nodes )
+      {
+        continue;
+      }
+
+      LevelReport result;
+      result.level       = static_cast<RF24::LogicalLevel>( level );
+      result.nodes       = mLevels[ level ].nodes;
+      result.connected   = mLevels[ level ].connected;
+      result.completedMs = ( result.connected == result.nodes ) ? ( mLevels[ level ].completedMs - startMs ) : 0;
+      result.attempts    = 0;
+
+      std::vector<uint64_t> latencies;
+      for ( const auto &node : mNodes )
+      {
+        if ( node->level != level )
+        {
+          continue;
+        }
+
+        result.attempts += node->attempts;
+
+        if ( node->attempts && ( node->stage == Stage::RUNNING ) )
+        {
+          latencies.push_back( node->connectedUs - node->firstAttemptUs );
+        }
+      }
+
+      std::sort( latencies.begin(), latencies.end() );
+      result.p50ConnectUs = percentile( latencies, 0.50 );
+      result.p99ConnectUs = percentile( latencies, 0.99 );
+      result.maxConnectUs = latencies.empty() ? 0 : latencies.back();
+
+      report.levels.push_back( result );
+    }
+
+    for ( auto &flow : mFlows )
+    {
+      std::lock_guard<std::mutex> lock( flow->lock );
+      std::sort( flow->latencies.begin(), flow->latencies.end() );
+
+      FlowReport result;
+      result.source      = flow->spec.source;
+      result.destination = flow->spec.destination;
+      result.priority    = flow->spec.priority;
+      result.sent        = flow->sent;
+      result.delivered   = flow->latencies.size();
+      result.duplicates  = flow->duplicates;
+      result.bytes       = flow->bytes;
+      result.activeUs    = flow->latencies.empty() ? 0 : ( flow->lastArrivalUs - flow->sendTimes.front() );
+      result.p50Us       = percentile( flow->latencies, 0.50 );
+      result.p90Us       = percentile( flow->latencies, 0.90 );
+      result.p99Us       = percentile( flow->latencies, 0.99 );
+      result.p999Us      = percentile( flow->latencies, 0.999 );
+      result.maxUs       = flow->latencies.empty() ? 0 : flow->latencies.back();
+
+      std::sort( flow->roundTrips.begin(), flow->roundTrips.end() );
+      result.echoed    = flow->roundTrips.size();
+      result.rttP50Us  = percentile( flow->roundTrips, 0.50 );
+      result.rttP99Us  = percentile( flow->roundTrips, 0.99 );
+      result.rttP999Us = percentile( flow->roundTrips, 0.999 );
+      result.rttMaxUs  = flow->roundTrips.empty() ? 0 : flow->roundTrips.back();
+
+      report.flows.push_back( result );
+    }
+
+    return report;
+  }
+
+  void ScenarioRunner::print( const ScenarioReport &report, std::ostream &stream )
+  {
+    char line[ 256 ];
+    const double windowSec = static_cast<double>( report.trafficWindowMs ) / 1000.0;
+
+    stream << "Scenario: " << report.name << "\n";
+
+    snprintf( line, sizeof( line ), "Seed 0x%llX\n", static_cast<unsigned long long>( report.seed ) );
+    stream << line;
+
+    snprintf( line, sizeof( line ), "Nodes connected: %zu/%zu, network formed in %zu ms\n", report.connected, report.nodes,
+              report.formationMs );
+    stream << line;
+
+    for ( const LevelReport &level : report.levels )
+    {
+      if ( level.connected == level.nodes )
+      {
+        snprintf( line, sizeof( line ), "  Level %u: %zu/%zu joined by %zu ms, %zu attempts\n", level.level, level.connected,
+                  level.nodes, level.completedMs, level.attempts );
+      }
+      else
+      {
+        snprintf( line, sizeof( line ), "  Level %u: %zu/%zu joined, incomplete, %zu attempts\n", level.level, level.connected,
+                  level.nodes, level.attempts );
+      }
+      stream << line;
+
+      if ( level.attempts )
+      {
+        snprintf( line, sizeof( line ), "      connect us: p50 %llu, p99 %llu, max %llu\n",
+                  static_cast<unsigned long long>( level.p50ConnectUs ), static_cast<unsigned long long>( level.p99ConnectUs ),
+                  static_cast<unsigned long long>( level.maxConnectUs ) );
+        stream << line;
+      }
+    }
+
+    for ( const FlowReport &flow : report.flows )
+    {
+      const double ratio = flow.sent ? ( 100.0 * static_cast<double>( flow.delivered ) / static_cast<double>( flow.sent ) ) : 0.0;
+      const double msgs  = ( windowSec > 0.0 ) ? ( static_cast<double>( flow.delivered ) / windowSec ) : 0.0;
+      const double bps   = ( windowSec > 0.0 ) ? ( static_cast<double>( flow.bytes ) / windowSec ) : 0.0;
+
+      if ( report.prioritized )
+      {
+        snprintf( line, sizeof( line ),
+                  "  [%04o] -> [%04o] (%s): sent %zu, delivered %zu (%.1f%%), dup %zu, %.1f msg/s, %.1f B/s\n", flow.source,
+                  flow.destination, Priority::toString( flow.priority ), flow.sent, flow.delivered, ratio, flow.duplicates,
+                  msgs, bps );
+      }
+      else
+      {
+        snprintf( line, sizeof( line ), "  [%04o] -> [%04o]: sent %zu, delivered %zu (%.1f%%), dup %zu, %.1f msg/s, %.1f B/s\n",
+                  flow.source, flow.destination, flow.sent, flow.delivered, ratio, flow.duplicates, msgs, bps );
+      }
+      stream << line;
+
+      snprintf( line, sizeof( line ), "      latency us: p50 %llu, p90 %llu, p99 %llu, p99.9 %llu, max %llu\n",
+                static_cast<unsigned long long>( flow.p50Us ), static_cast<unsigned long long>( flow.p90Us ),
+                static_cast<unsigned long long>( flow.p99Us ), static_cast<unsigned long long>( flow.p999Us ),
+                static_cast<unsigned long long>( flow.maxUs ) );
+      stream << line;
+
+      if ( flow.echoed )
+      {
+        snprintf( line, sizeof( line ), "      round trip us: p50 %llu, p99 %llu, p99.9 %llu, max %llu (%zu echoed)\n",
+                  static_cast<unsigned long long>( flow.rttP50Us ), static_cast<unsigned long long>( flow.rttP99Us ),
+                  static_cast<unsigned long long>( flow.rttP999Us ), static_cast<unsigned long long>( flow.rttMaxUs ),
+                  flow.echoed );
+        stream << line;
+      }
+    }
+
+    if ( report.fragmented )
+    {
+      const Fragment::Stats &frag = report.fragments;
+      snprintf( line, sizeof( line ),
+                "  Fragments: %zu messages as %zu frames (%zu header bytes), %zu reassembled from %zu, dup %zu, timed out %zu, "
+                "no slot %zu, rejected %zu\n",
+                frag.messagesSent, frag.fragmentsSent, frag.headerBytes, frag.messagesReceived, frag.fragmentsReceived,
+                frag.duplicates, frag.timeouts, frag.overflows, frag.rejected );
+      stream << line;
+    }
+
+    if ( report.reliable )
+    {
+      const Transport::Stats &xport = report.transport;
+      snprintf( line, sizeof( line ),
+                "  Transport: %zu sent, %zu acked, %zu retransmitted (%zu fast), %zu abandoned, %zu delivered, dup %zu, "
+                "%zu acks\n",
+                xport.messagesSent, xport.messagesAcked, xport.retransmits, xport.fastRetransmits, xport.abandoned,
+                xport.delivered, xport.duplicates, xport.acksSent );
+      stream << line;
+    }
+
+    if ( report.prioritized )
+    {
+      for ( size_t x = 0; x < Priority::NUM_LEVELS; x++ )
+      {
+        const Priority::LevelStats &level = report.priority.levels[ x ];
+        if ( !level.queued && !level.rejected )
+        {
+          continue;
+        }
+
+        snprintf( line, sizeof( line ), "  Priority %s: %zu queued, %zu sent, %zu refused, peak depth %zu, max wait %llu us\n",
+                  Priority::toString( static_cast<Priority::Level>( x ) ), level.queued, level.sent, level.rejected,
+                  level.peakDepth, static_cast<unsigned long long>( level.maxWaitUs ) );
+        stream << line;
+      }
+    }
+
+    if ( report.coalesced )
+    {
+      const Coalesce::Stats &pack = report.coalescing;
+      const double perFrame       = pack.framesSent ? ( static_cast<double>( pack.messagesSent ) / pack.framesSent ) : 0.0;
+      snprintf( line, sizeof( line ),
+                "  Coalescing: %zu messages in %zu frames (%.2f per frame, %zu closed early, %zu on hold time), "
+                "%zu unpacked from %zu, refused %zu, rejected %zu\n",
+                pack.messagesSent, pack.framesSent, perFrame, pack.framesFilled, pack.framesExpired, pack.messagesReceived,
+                pack.framesReceived, pack.refused, pack.rejected );
+      stream << line;
+    }
+  }
+
+  void ScenarioRunner::service( const NodeId id, RF24::Endpoint::Interface_sPtr &device )
+  {
+    NodeState &node = *mNodes[ id ];
+
+    switch ( node.stage )
+    {
+      /*------------------------------------------------
+      The tree connects from the root outwards: a node
+      only starts connecting once its parent has joined,
+      or once its whole parent level has when forming the
+      network level by level.
+      ------------------------------------------------*/
+      case Stage::BOOTING:
+        if ( node.spec.address == RF24::RootNode0 )
+        {
+          onConnected( node );
+        }
+        else if ( ( mDesc.formation == Scenario::Formation::BY_LEVEL ) ? levelFormed( node.level - 1 )
+                                                                        : ( mNodes[ node.parentIndex ]->stage == Stage::RUNNING ) )
+        {
+          if ( !node.attempts )
+          {
+            node.firstAttemptUs = Clock::micros();
+          }
+
+          node.attempts++;
+          ( *s_connectResults )[ id ] = RF24::Connection::Result::CONNECT_PROC_UNKNOWN;
+          device->connectAsync( onConnectComplete, ConnectTimeout );
+          node.stage = Stage::CONNECTING;
+          mExecutor->armTimer( id, ConnectPollRate );
+        }
+        else
+        {
+          mExecutor->armTimer( id, ConnectPollRate );
+        }
+        break;
+
+      case Stage::CONNECTING:
+        node.connectResult = ( *s_connectResults )[ id ];
+
+        if ( node.connectResult == RF24::Connection::Result::CONNECT_PROC_UNKNOWN )
+        {
+          mExecutor->armTimer( id, ConnectPollRate );
+        }
+        else if ( node.connectResult == RF24::Connection::Result::CONNECT_PROC_SUCCESS )
+        {
+          onConnected( node );
+        }
+        else
+        {
+          node.stage = Stage::BOOTING;
+          mExecutor->armTimer( id, ConnectRetry );
+        }
+        break;
+
+      case Stage::RUNNING:
+      default:
+      {
+        size_t moved = node.stream ? node.stream->process() : 0;
+        moved += node.reliable ? node.reliable->process() : 0;
+        moved += node.packer ? node.packer->process() : 0;
+
+        receiveTraffic( id, node );
+        sendTraffic( id, node );
+
+        /*------------------------------------------------
+        The scheduler goes last so anything urgent queued
+        just now beats whatever was already waiting.
+        ------------------------------------------------*/
+        const size_t scheduled = node.scheduler ? node.scheduler->process() : 0;
+        moved += scheduled;
+
+        /*------------------------------------------------
+        Frames that didn't fit in the endpoint's queue go
+        out as soon as the radio has made some room, and
+        the ones that did still need a pass to be sent.
+        A scheduler that only stopped at its burst limit
+        carries on with the next pass instead.
+        ------------------------------------------------*/
+        if ( ( node.stream && node.stream->pendingTx() ) || ( node.reliable && node.reliable->pendingTx() ) ||
+             ( node.scheduler && node.scheduler->pendingTx() && !scheduled ) || ( node.packer && node.packer->pendingTx() ) )
+        {
+          mExecutor->armTimer( id, SendRetry );
+        }
+        else if ( moved )
+        {
+          mExecutor->notify( id );
+        }
+
+        if ( node.reliable )
+        {
+          const uint64_t timeoutUs = node.reliable->nextTimeoutUs();
+          if ( timeoutUs != UINT64_MAX )
+          {
+            mExecutor->armTimer( id, std::max<size_t>( static_cast<size_t>( ( timeoutUs + 999 ) / 1000 ), 1 ) );
+          }
+        }
+
+        /*------------------------------------------------
+        Messages written just now start a new hold period,
+        so come back when the oldest one has to go out.
+        ------------------------------------------------*/
+        if ( node.packer )
+        {
+          const uint64_t holdUs = node.packer->nextTimeoutUs();
+          if ( holdUs == 0 )
+          {
+            mExecutor->notify( id );
+          }
+          else if ( holdUs != UINT64_MAX )
+          {
+            mExecutor->armTimer( id, static_cast<size_t>( ( holdUs + 999 ) / 1000 ) );
+          }
+        }
+        break;
+      }
+    }
+  }
+
+  void ScenarioRunner::onConnected( NodeState &node )
+  {
+    node.connectedUs = Clock::micros();
+    node.stage       = Stage::RUNNING;
+
+    std::lock_guard<std::mutex> lock( mFormationLock );
+    mConnected++;
+
+    LevelState &level = mLevels[ node.level ];
+    level.connected++;
+
+    if ( level.connected == level.nodes )
+    {
+      level.completedMs = Clock::millis();
+    }
+
+    if ( mConnected == mNodes.size() )
+    {
+      mFormedAtMs = Clock::millis();
+    }
+  }
+
+  void ScenarioRunner::sendTraffic( const NodeId id, NodeState &node )
+  {
+    /*------------------------------------------------
+    Traffic start times are relative to the moment the
+    whole network has formed, so results aren't skewed
+    by the connection process.
+    ------------------------------------------------*/
+    if ( node.outbound.empty() || !formed() )
+    {
+      return;
+    }
+
+    const size_t now  = Clock::millis();
+    size_t nextWakeup = SIZE_MAX;
+    bool queued       = false;
+    std::array<uint8_t, Fragment::MAX_MESSAGE_SIZE> payload;
+
+    for ( Flow *flow : node.outbound )
+    {
+      if ( !flow->nextSendMs )
+      {
+        flow->nextSendMs = mFormedAtMs + flow->spec.startMs;
+      }
+
+      /*------------------------------------------------
+      A periodic flow catches up on any periods it missed.
+      A back to back flow keeps going until its window is
+      full, the endpoint stops accepting messages or it
+      has used up its burst, then tries again shortly.
+      ------------------------------------------------*/
+      size_t burst = 0;
+      bool blocked = false;
+
+      while ( !( flow->spec.count && ( flow->sent >= flow->spec.count ) ) && ( now >= flow->nextSendMs ) )
+      {
+        const size_t size = flow->compact ? flow->spec.size : std::max( flow->spec.size, PROBE_HEADER_SIZE );
+        uint32_t sequence = 0;
+
+        {
+          std::lock_guard<std::mutex> lock( flow->lock );
+          const size_t completed = flow->spec.echo ? flow->roundTrips.size() : flow->latencies.size();
+          const bool windowFull  = flow->spec.window && ( ( flow->sent - std::min( completed, flow->sent ) ) >= flow->spec.window ) &&
+                                  ( ( Clock::micros() - flow->lastSendUs ) < WindowTimeout );
+
+          if ( ( burst >= SendBurst ) || windowFull )
+          {
+            blocked = true;
+            break;
+          }
+
+          sequence = static_cast<uint32_t>( flow->sendTimes.size() );
+          flow->sendTimes.push_back( Clock::micros() );
+          flow->received.push_back( false );
+          flow->echoed.push_back( false );
+        }
+
+        memset( payload.data(), 0, size );
+        if ( flow->compact )
+        {
+          memcpy( payload.data(), &sequence, std::min( size, sizeof( sequence ) ) );
+        }
+        else
+        {
+          payload[ 0 ] = PROBE_MAGIC;
+          payload[ 1 ] = static_cast<uint8_t>( flow->index );
+          memcpy( &payload[ 2 ], &sequence, sizeof( sequence ) );
+        }
+
+        if ( transmit( node, flow->spec.destination, payload.data(), size, flow->spec.priority ) )
+        {
+          flow->sent++;
+          flow->lastSendUs = Clock::micros();
+          queued           = true;
+          burst++;
+        }
+        else if ( !flow->spec.periodMs )
+        {
+          std::lock_guard<std::mutex> lock( flow->lock );
+          flow->sendTimes.pop_back();
+          flow->received.pop_back();
+          flow->echoed.pop_back();
+
+          blocked = true;
+          break;
+        }
+
+        flow->nextSendMs += flow->spec.periodMs;
+      }
+
+      if ( flow->spec.count && ( flow->sent >= flow->spec.count ) )
+      {
+        continue;
+      }
+
+      nextWakeup = std::min( nextWakeup, blocked ? ( now + SendRetry ) : flow->nextSendMs );
+    }
+
+    if ( nextWakeup != SIZE_MAX )
+    {
+      mExecutor->armTimer( id, ( nextWakeup > now ) ? ( nextWakeup - now ) : 0 );
+    }
+
+    /*------------------------------------------------
+    Queued messages only reach the radio on the next
+    processing pass, so ask for one right away instead
+    of leaving them until the housekeeping timer.
+    ------------------------------------------------*/
+    if ( queued )
+    {
+      mExecutor->notify( id );
+    }
+  }
+
+  void ScenarioRunner::receiveTraffic( const NodeId id, NodeState &node )
+  {
+    std::array<uint8_t, Fragment::MAX_MESSAGE_SIZE> payload;
+
+    while ( messageAvailable( node ) )
+    {
+      const size_t length = std::min( nextMessageLength( node ), payload.size() );
+      Flow *flow          = nullptr;
+      uint32_t sequence   = 0;
+      bool reply          = false;
+
+      if ( !readMessage( node, payload.data(), length ) ||
+           !decodeProbe( node, payload.data(), length, flow, sequence, reply ) )
+      {
+        continue;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock( flow->lock );
+        if ( sequence >= flow->sendTimes.size() )
+        {
+          continue;
+        }
+
+        if ( reply )
+        {
+          if ( !flow->echoed[ sequence ] )
+          {
+            flow->echoed[ sequence ] = true;
+            flow->roundTrips.push_back( Clock::micros() - flow->sendTimes[ sequence ] );
+          }
+          continue;
+        }
+
+        if ( flow->received[ sequence ] )
+        {
+          flow->duplicates++;
+          continue;
+        }
+
+        flow->received[ sequence ] = true;
+        flow->lastArrivalUs        = Clock::micros();
+        flow->latencies.push_back( flow->lastArrivalUs - flow->sendTimes[ sequence ] );
+        flow->bytes += length;
+      }
+
+      if ( flow->spec.echo )
+      {
+        if ( !flow->compact )
+        {
+          payload[ 0 ] = PROBE_ECHO_MAGIC;
+        }
+
+        if ( transmit( node, flow->spec.source, payload.data(), length, flow->spec.priority ) )
+        {
+          mExecutor->notify( id );
+        }
+      }
+    }
+  }
+
+  bool ScenarioRunner::transmit( NodeState &node, const RF24::LogicalAddress destination, const uint8_t *const data,
+                                 const size_t length, const Priority::Level priority )
+  {
+    if ( node.stream )
+    {
+      return node.stream->write( destination, data, length );
+    }
+    else if ( node.reliable )
+    {
+      return node.reliable->write( destination, data, length );
+    }
+    else if ( node.scheduler )
+    {
+      return node.scheduler->write( destination, data, length, priority );
+    }
+    else if ( node.packer )
+    {
+      return node.packer->write( destination, data, length );
+    }
+
+    return node.device->write( destination, data, length ) == Chimera::CommonStatusCodes::OK;
+  }
+
+  bool ScenarioRunner::messageAvailable( NodeState &node )
+  {
+    if ( node.stream )
+    {
+      return node.stream->available();
+    }
+    else if ( node.reliable )
+    {
+      return node.reliable->available();
+    }
+    else if ( node.packer )
+    {
+      return node.packer->available();
+    }
+
+    return node.device->packetAvailable();
+  }
+
+  size_t ScenarioRunner::nextMessageLength( NodeState &node )
+  {
+    if ( node.stream )
+    {
+      return node.stream->nextLength();
+    }
+    else if ( node.reliable )
+    {
+      return node.reliable->nextLength();
+    }
+    else if ( node.packer )
+    {
+      return node.packer->nextLength();
+    }
+
+    return node.device->nextPacketLength();
+  }
+
+  bool ScenarioRunner::readMessage( NodeState &node, uint8_t *const data, const size_t length )
+  {
+    if ( node.stream )
+    {
+      return node.stream->read( data, length, nullptr );
+    }
+    else if ( node.reliable )
+    {
+      return node.reliable->read( data, length, nullptr );
+    }
+    else if ( node.packer )
+    {
+      return node.packer->read( data, length );
+    }
+
+    return node.device->read( data, length ) == Chimera::CommonStatusCodes::OK;
+  }
+
+  bool ScenarioRunner::decodeProbe( NodeState &node, const uint8_t *payload, const size_t length, Flow *&flow, uint32_t &sequence,
+                                    bool &reply )
+  {
+    if ( length >= PROBE_HEADER_SIZE )
+    {
+      if ( ( ( payload[ 0 ] != PROBE_MAGIC ) && ( payload[ 0 ] != PROBE_ECHO_MAGIC ) ) || ( payload[ 1 ] >= mFlows.size() ) )
+      {
+        return false;
+      }
+
+      flow  = mFlows[ payload[ 1 ] ].get();
+      reply = ( payload[ 0 ] == PROBE_ECHO_MAGIC );
+      memcpy( &sequence, &payload[ 2 ], sizeof( sequence ) );
+      return true;
+    }
+
+    /*------------------------------------------------
+    Compact probes only carry the low bytes of their
+    sequence number. Messages never get far enough out
+    of order to wrap those bytes, so the newest message
+    sent with matching low bytes is the one that arrived.
+    ------------------------------------------------*/
+    reply = ( node.compactEcho != nullptr );
+    flow  = reply ? node.compactEcho : node.compactInbound;
+
+    if ( !flow || ( length != flow->spec.size ) )
+    {
+      return false;
+    }
+
+    uint32_t low       = 0;
+    const size_t width = std::min( length, sizeof( low ) );
+    memcpy( &low, payload, width );
+
+    std::lock_guard<std::mutex> lock( flow->lock );
+    if ( flow->sendTimes.empty() )
+    {
+      return false;
+    }
+
+    const uint64_t newest = flow->sendTimes.size() - 1;
+    const uint64_t mask   = ( width < sizeof( low ) ) ? ( ( 1ull << ( 8 * width ) ) - 1 ) : UINT32_MAX;
+    const uint64_t behind = ( newest - low ) & mask;
+
+    if ( behind > newest )
+    {
+      return false;
+    }
+
+    sequence = static_cast<uint32_t>( newest - behind );
+    return true;
+  }
+
+  bool ScenarioRunner::formed()
+  {
+    std::lock_guard<std::mutex> lock( mFormationLock );
+    return mConnected == mNodes.size();
+  }
+
+  bool ScenarioRunner::levelFormed( const RF24::LogicalLevel level )
+  {
+    std::lock_guard<std::mutex> lock( mFormationLock );
+    return mLevels[ level ].connected == mLevels[ level ].nodes;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  int runScenarioFile( const std::string &path )
+  {
+    Scenario::Description desc;
+    std::string error;
+
+    if ( !Scenario::load( path, desc, error ) )
+    {
+      std::cerr << path << ": " << error << std::endl;
+      return 2;
+    }
+
+    ScenarioRunner runner( desc );
+    const ScenarioReport report = runner.run();
+    ScenarioRunner::print( report, std::cout );
+
+    return ( report.connected == report.nodes ) ? 0 : 1;
+  }
+
+}    // namespace Sim
@@ -0,0 +1,228 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_runner.hpp
+ *
+ *  Description:
+ *    Headless execution of a scenario description. Builds every node in the
+ *    topology, connects the tree from the root outwards, drives the requested
+ *    traffic and reports throughput, delivery ratio and latency.
+ *
+ *    The runner sources no longer need windows.h, but the only build for them
+ *    is still ConsoleApp.vcxproj. A Linux build needs RF24Node and the Chimera
+ *    and uLog libraries it pulls in to build for Linux first, so none exists.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_RUNNER_HPP
+#define RF24_SIM_RUNNER_HPP
+
+/* STL Includes */
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+#include <RF24Node/endpoint>
+
+/* Dev Includes */
+#include <sim_coalesce.hpp>
+#include <sim_executor.hpp>
+#include <sim_fragment.hpp>
+#include <sim_priority.hpp>
+#include <sim_scenario.hpp>
+#include <sim_transport.hpp>
+
+namespace Sim
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint8_t PROBE_MAGIC        = 0xA5; /**< First byte of every traffic message */
+  static constexpr uint8_t PROBE_ECHO_MAGIC   = 0x5A; /**< First byte of a message returned by an echo flow */
+  static constexpr size_t PROBE_HEADER_SIZE   = 6;    /**< Magic, flow index and 32-bit sequence number */
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct FlowReport
+  {
+    RF24::LogicalAddress source;
+    RF24::LogicalAddress destination;
+    Priority::Level priority;
+    size_t sent;          /**< Messages accepted by the source endpoint */
+    size_t delivered;     /**< Unique messages read at the destination */
+    size_t duplicates;    /**< Messages read more than once */
+    size_t bytes;         /**< Payload bytes delivered */
+    uint64_t activeUs;    /**< Time from the first message sent until the last one arrived */
+    uint64_t p50Us;       /**< Latency percentiles in microseconds */
+    uint64_t p90Us;
+    uint64_t p99Us;
+    uint64_t p999Us;
+    uint64_t maxUs;
+    size_t echoed;        /**< Messages returned to the source, echo flows only */
+    uint64_t rttP50Us;    /**< Round trip percentiles in microseconds, echo flows only */
+    uint64_t rttP99Us;
+    uint64_t rttP999Us;
+    uint64_t rttMaxUs;
+  };
+
+  struct LevelReport
+  {
+    RF24::LogicalLevel level;
+    size_t nodes;             /**< Nodes at this depth of the tree */
+    size_t connected;         /**< Nodes that joined the network */
+    size_t attempts;          /**< connectAsync() calls made, including retries */
+    size_t completedMs;       /**< Time from start until the level fully joined, 0 if it never did */
+    uint64_t p50ConnectUs;    /**< Time from a node's first attempt until it joined */
+    uint64_t p99ConnectUs;
+    uint64_t maxConnectUs;
+  };
+
+  struct ScenarioReport
+  {
+    std::string name;
+    size_t nodes;               /**< Nodes in the topology */
+    size_t connected;           /**< Nodes that joined the network */
+    size_t formationMs;         /**< Time until every node joined, 0 if it never happened */
+    size_t trafficWindowMs;     /**< Time traffic was allowed to flow */
+    uint64_t seed;              /**< Seed of the simulator's random streams */
+    std::vector<LevelReport> levels;
+    std::vector<FlowReport> flows;
+    bool fragmented;            /**< Traffic went through Fragment::Stream */
+    Fragment::Stats fragments;  /**< Totals across every node, only when fragmented */
+    bool reliable;              /**< Traffic went through Transport::Reliable */
+    Transport::Stats transport; /**< Totals across every node, only when reliable */
+    bool prioritized;           /**< Traffic went through Priority::Scheduler */
+    Priority::Stats priority;   /**< Totals across every node, with the worst wait per level */
+    bool coalesced;             /**< Traffic went through Coalesce::Packer */
+    Coalesce::Stats coalescing; /**< Totals across every node, only when coalesced */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  class ScenarioRunner
+  {
+  public:
+    explicit ScenarioRunner( const Scenario::Description &desc );
+    ~ScenarioRunner();
+
+    /**
+     *  Runs the scenario for its configured duration of simulation time
+     *
+     *  @return ScenarioReport
+     */
+    ScenarioReport run();
+
+    /**
+     *  Pretty prints a report
+     *
+     *  @param[in]  report    Results of a run
+     *  @param[in]  stream    Where to print
+     *  @return void
+     */
+    static void print( const ScenarioReport &report, std::ostream &stream );
+
+  private:
+    enum class Stage
+    {
+      BOOTING,
+      CONNECTING,
+      RUNNING
+    };
+
+    struct Flow
+    {
+      Scenario::TrafficSpec spec;
+      size_t index;
+      size_t sent;
+      size_t nextSendMs;
+      bool compact;                     /**< Probe is smaller than the header and only carries the sequence */
+
+      std::mutex lock;                  /**< Guards everything below, sender and receiver differ */
+      std::vector<uint64_t> sendTimes;  /**< Transmit timestamp (us) indexed by sequence number */
+      std::vector<bool> received;
+      std::vector<uint64_t> latencies;
+      std::vector<bool> echoed;
+      std::vector<uint64_t> roundTrips;
+      size_t duplicates;
+      size_t bytes;
+      uint64_t lastSendUs;
+      uint64_t lastArrivalUs;
+    };
+
+    struct NodeState
+    {
+      Scenario::NodeSpec spec;
+      RF24::Endpoint::Interface_sPtr device;
+      Fragment::Stream_uPtr stream;      /**< Carries all traffic when any message exceeds a frame */
+      Transport::Reliable_uPtr reliable; /**< Carries all traffic when the scenario asks for it */
+      Priority::Scheduler_uPtr scheduler; /**< Orders outgoing traffic when the scenario asks for it */
+      Coalesce::Packer_uPtr packer;       /**< Packs small messages together when the scenario asks for it */
+      size_t parentIndex;
+      RF24::LogicalLevel level;
+      std::atomic<Stage> stage;   /**< Read by children serviced on other workers */
+      RF24::Connection::Result connectResult;
+      std::vector<Flow *> outbound;
+      Flow *compactInbound;       /**< Only compact flow addressed to this node */
+      Flow *compactEcho;          /**< Only compact echo flow sourced by this node */
+      size_t attempts;            /**< connectAsync() calls made */
+      uint64_t firstAttemptUs;    /**< Time of the first connectAsync() call */
+      uint64_t connectedUs;       /**< Time the node joined the network */
+    };
+
+    struct LevelState
+    {
+      size_t nodes;
+      size_t connected;
+      size_t completedMs;
+    };
+
+    const Scenario::Description mDesc;
+    std::unique_ptr<Executor> mExecutor;
+    std::vector<std::unique_ptr<NodeState>> mNodes;
+    std::vector<std::unique_ptr<Flow>> mFlows;
+
+    std::mutex mFormationLock;
+    size_t mConnected;
+    size_t mFormedAtMs;
+    std::array<LevelState, RF24::NODE_LEVEL_5 + 1> mLevels; /**< Guarded by mFormationLock */
+
+    void service( const NodeId id, RF24::Endpoint::Interface_sPtr &device );
+    void onConnected( NodeState &node );
+    void sendTraffic( const NodeId id, NodeState &node );
+    void receiveTraffic( const NodeId id, NodeState &node );
+    bool transmit( NodeState &node, const RF24::LogicalAddress destination, const uint8_t *const data, const size_t length,
+                   const Priority::Level priority );
+    bool messageAvailable( NodeState &node );
+    size_t nextMessageLength( NodeState &node );
+    bool readMessage( NodeState &node, uint8_t *const data, const size_t length );
+    bool decodeProbe( NodeState &node, const uint8_t *payload, const size_t length, Flow *&flow, uint32_t &sequence,
+                      bool &reply );
+    bool formed();
+    bool levelFormed( const RF24::LogicalLevel level );
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Loads, runs and reports on a scenario file
+   *
+   *  @param[in]  path      Scenario file to run
+   *  @return int           Process exit code, 0 if every node joined the network
+   */
+  int runScenarioFile( const std::string &path );
+
+}    // namespace Sim
+
+#endif /* !RF24_SIM_RUNNER_HPP */
@@ -0,0 +1,762 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_scenario.cpp
+ *
+ *  Description:
+ *    Scenario file parser
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+/* RF24 Includes */
+#include <RF24Node/src/common/utility.hpp>
+
+/* Dev Includes */
+#include <sim_fragment.hpp>
+#include <sim_priority.hpp>
+#include <sim_random.hpp>
+#include <sim_scenario.hpp>
+#include <sim_transport.hpp>
+
+namespace Sim::Scenario
+{
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  static bool parseNumber( const std::string &text, const int base, size_t &value )
+  {
+    try
+    {
+      size_t consumed = 0;
+      value           = std::stoul( text, &consumed, base );
+      return consumed == text.size();
+    }
+    catch ( ... )
+    {
+      return false;
+    }
+  }
+
+  static bool parseAddress( const std::string &text, RF24::LogicalAddress &address )
+  {
+    size_t value = 0;
+    if ( !parseNumber( text, 8, value ) || ( value > std::numeric_limits<RF24::LogicalAddress>::max() ) )
+    {
+      return false;
+    }
+
+    address = static_cast<RF24::LogicalAddress>( value );
+    return true;
+  }
+
+  static bool parseProbability( const std::string &text, double &value )
+  {
+    try
+    {
+      size_t consumed = 0;
+      value           = std::stod( text, &consumed );
+      return ( consumed == text.size() ) && ( value >= 0.0 ) && ( value <= 1.0 );
+    }
+    catch ( ... )
+    {
+      return false;
+    }
+  }
+
+  static bool parsePriority( const std::string &text, Sim::Priority::Level &level )
+  {
+    for ( size_t x = 0; x < Sim::Priority::NUM_LEVELS; x++ )
+    {
+      if ( text == Sim::Priority::toString( static_cast<Sim::Priority::Level>( x ) ) )
+      {
+        level = static_cast<Sim::Priority::Level>( x );
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  static std::string formatAddress( const RF24::LogicalAddress address )
+  {
+    char buffer[ 16 ];
+    snprintf( buffer, sizeof( buffer ), "%04o", address );
+    return buffer;
+  }
+
+  /**
+   *  Applies a single key=value override to a node configuration
+   *
+   *  @param[in]  option    The "key=value" text
+   *  @param[out] cfg       Configuration to modify
+   *  @param[out] parent    Set if the option overrides the parent address
+   *  @param[out] error     Description of the problem, if any
+   *  @return bool
+   */
+  static bool applyOption( const std::string &option, RF24::Endpoint::SystemInit &cfg, RF24::LogicalAddress *parent,
+                           std::string &error )
+  {
+    const size_t split = option.find( '=' );
+    if ( split == std::string::npos )
+    {
+      error = "expected key=value, got '" + option + "'";
+      return false;
+    }
+
+    const std::string key   = option.substr( 0, split );
+    const std::string value = option.substr( split + 1 );
+    size_t number           = 0;
+
+    if ( ( key == "parent" ) && parent )
+    {
+      if ( parseAddress( value, *parent ) )
+      {
+        return true;
+      }
+    }
+    else if ( key == "rxQueueSize" )
+    {
+      if ( parseNumber( value, 10, number ) )
+      {
+        cfg.network.rxQueueSize = number;
+        return true;
+      }
+    }
+    else if ( key == "txQueueSize" )
+    {
+      if ( parseNumber( value, 10, number ) )
+      {
+        cfg.network.txQueueSize = number;
+        return true;
+      }
+    }
+    else if ( key == "channel" )
+    {
+      if ( parseNumber( value, 10, number ) && ( number <= 125 ) )
+      {
+        cfg.physical.rfChannel = static_cast<uint8_t>( number );
+        return true;
+      }
+    }
+    else if ( key == "dataRate" )
+    {
+      if ( value == "250KBPS" )
+      {
+        cfg.physical.dataRate = RF24::Hardware::DataRate::DR_250KBPS;
+        return true;
+      }
+      else if ( value == "1MBPS" )
+      {
+        cfg.physical.dataRate = RF24::Hardware::DataRate::DR_1MBPS;
+        return true;
+      }
+      else if ( value == "2MBPS" )
+      {
+        cfg.physical.dataRate = RF24::Hardware::DataRate::DR_2MBPS;
+        return true;
+      }
+    }
+    else if ( key == "power" )
+    {
+      if ( value == "MIN" )
+      {
+        cfg.physical.powerAmplitude = RF24::Hardware::PowerAmplitude::PA_MIN;
+        return true;
+      }
+      else if ( value == "LOW" )
+      {
+        cfg.physical.powerAmplitude = RF24::Hardware::PowerAmplitude::PA_LOW;
+        return true;
+      }
+      else if ( value == "HIGH" )
+      {
+        cfg.physical.powerAmplitude = RF24::Hardware::PowerAmplitude::PA_HIGH;
+        return true;
+      }
+      else if ( value == "MAX" )
+      {
+        cfg.physical.powerAmplitude = RF24::Hardware::PowerAmplitude::PA_MAX;
+        return true;
+      }
+    }
+    else
+    {
+      error = "unknown option '" + key + "'";
+      return false;
+    }
+
+    error = "invalid value '" + value + "' for option '" + key + "'";
+    return false;
+  }
+
+  static NodeSpec *findNode( Description &desc, const RF24::LogicalAddress address )
+  {
+    auto iter = std::find_if( desc.nodes.begin(), desc.nodes.end(),
+                              [ address ]( const NodeSpec &node ) { return node.address == address; } );
+
+    return ( iter == desc.nodes.end() ) ? nullptr : &( *iter );
+  }
+
+  /**
+   *  Adds a node if it doesn't exist yet, otherwise returns the existing one so
+   *  later directives can override earlier ones.
+   */
+  static NodeSpec &addNode( Description &desc, const RF24::LogicalAddress address, const RF24::Endpoint::SystemInit &base )
+  {
+    if ( NodeSpec *existing = findNode( desc, address ) )
+    {
+      return *existing;
+    }
+
+    NodeSpec node;
+    node.address = address;
+    node.parent  = ( address == RF24::RootNode0 ) ? RF24::Network::RSVD_ADDR_INVALID : RF24::getParent( address );
+    node.name    = "Node-" + formatAddress( address );
+    node.cfg     = base;
+
+    desc.nodes.push_back( node );
+    return desc.nodes.back();
+  }
+
+  static bool validate( Description &desc, std::string &error )
+  {
+    if ( !findNode( desc, RF24::RootNode0 ) )
+    {
+      error = "scenario has no root node";
+      return false;
+    }
+
+    for ( NodeSpec &node : desc.nodes )
+    {
+      if ( ( node.address != RF24::RootNode0 ) && !findNode( desc, node.parent ) )
+      {
+        error = "node " + formatAddress( node.address ) + " has no parent " + formatAddress( node.parent ) + " in the scenario";
+        return false;
+      }
+
+      node.cfg.network.mode                = RF24::Network::Mode::NET_MODE_STATIC;
+      node.cfg.network.nodeStaticAddress   = node.address;
+      node.cfg.network.parentStaticAddress = node.parent;
+      node.cfg.physical.deviceName         = node.name;
+    }
+
+    for ( const TrafficSpec &flow : desc.traffic )
+    {
+      if ( !findNode( desc, flow.source ) || !findNode( desc, flow.destination ) )
+      {
+        error = "traffic " + formatAddress( flow.source ) + " -> " + formatAddress( flow.destination ) +
+                " references a node not in the scenario";
+        return false;
+      }
+
+      if ( flow.size == 0 )
+      {
+        error = "traffic needs a non-zero size";
+        return false;
+      }
+
+      if ( ( flow.periodMs == 0 ) && ( flow.count == 0 ) && ( flow.window == 0 ) )
+      {
+        error = "back to back traffic needs a count or a window";
+        return false;
+      }
+
+      if ( desc.transport.reliable && ( flow.size > Transport::MAX_MESSAGE_SIZE ) )
+      {
+        error = "the reliable transport carries at most " + std::to_string( Transport::MAX_MESSAGE_SIZE ) + " bytes per message";
+        return false;
+      }
+
+      if ( desc.scheduler.enabled && ( desc.transport.reliable || ( flow.size > Priority::FRAME_SIZE ) ) )
+      {
+        error = "the priority scheduler only carries single frame messages without a transport";
+        return false;
+      }
+
+      if ( desc.coalesce.enabled &&
+           ( desc.transport.reliable || desc.scheduler.enabled || ( flow.size > Sim::Coalesce::MAX_MESSAGE_SIZE ) ) )
+      {
+        error = "coalescing carries at most " + std::to_string( Sim::Coalesce::MAX_MESSAGE_SIZE ) +
+                " bytes per message, without a transport or scheduler";
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  RF24::Endpoint::SystemInit defaultConfig()
+  {
+    RF24::Endpoint::SystemInit cfg;
+
+    cfg.network.mode                = RF24::Network::Mode::NET_MODE_STATIC;
+    cfg.network.nodeStaticAddress   = RF24::Network::RSVD_ADDR_INVALID;
+    cfg.network.parentStaticAddress = RF24::Network::RSVD_ADDR_INVALID;
+    cfg.network.rxQueueBuffer       = nullptr;
+    cfg.network.rxQueueSize         = 5 * RF24::Hardware::PACKET_WIDTH;
+    cfg.network.txQueueBuffer       = nullptr;
+    cfg.network.txQueueSize         = 5 * RF24::Hardware::PACKET_WIDTH;
+
+    cfg.physical.dataRate       = RF24::Hardware::DataRate::DR_1MBPS;
+    cfg.physical.powerAmplitude = RF24::Hardware::PowerAmplitude::PA_HIGH;
+    cfg.physical.rfChannel      = 96;
+
+    return cfg;
+  }
+
+  bool parse( std::istream &stream, Description &desc, std::string &error )
+  {
+    RF24::Endpoint::SystemInit defaults = defaultConfig();
+    std::string line;
+    size_t lineNumber = 0;
+
+    desc.name       = "unnamed";
+    desc.durationMs = 10000;
+    desc.workers    = 4;
+    desc.nodes.clear();
+    desc.traffic.clear();
+    desc.seeded         = false;
+    desc.seed           = 0;
+    desc.formation      = Formation::BY_PARENT;
+    desc.transport      = { false, 8, 200, 8 };
+    desc.scheduler      = { false, Sim::Priority::defaultConfig() };
+    desc.coalesce       = { false, Sim::Coalesce::defaultConfig() };
+    desc.compactHeaders = false;
+
+    while ( std::getline( stream, line ) )
+    {
+      lineNumber++;
+
+      /*------------------------------------------------
+      Strip comments and split into whitespace tokens
+      ------------------------------------------------*/
+      const size_t comment = line.find( '#' );
+      if ( comment != std::string::npos )
+      {
+        line.erase( comment );
+      }
+
+      std::istringstream tokenizer( line );
+      std::vector<std::string> tokens;
+      std::string token;
+
+      while ( tokenizer >> token )
+      {
+        tokens.push_back( token );
+      }
+
+      if ( tokens.empty() )
+      {
+        continue;
+      }
+
+      const std::string prefix    = "line " + std::to_string( lineNumber ) + ": ";
+      const std::string &command = tokens[ 0 ];
+      std::string detail;
+      size_t number = 0;
+
+      /*------------------------------------------------
+      Handle each directive
+      ------------------------------------------------*/
+      if ( command == "name" )
+      {
+        desc.name = line.substr( line.find( "name" ) + 4 );
+        desc.name.erase( 0, desc.name.find_first_not_of( " \t" ) );
+      }
+      else if ( ( command == "duration" ) || ( command == "workers" ) )
+      {
+        if ( ( tokens.size() != 2 ) || !parseNumber( tokens[ 1 ], 10, number ) )
+        {
+          error = prefix + "expected '" + command + " <number>'";
+          return false;
+        }
+
+        ( command == "duration" ) ? ( desc.durationMs = number ) : ( desc.workers = number );
+      }
+      else if ( command == "defaults" )
+      {
+        for ( size_t x = 1; x < tokens.size(); x++ )
+        {
+          if ( !applyOption( tokens[ x ], defaults, nullptr, detail ) )
+          {
+            error = prefix + detail;
+            return false;
+          }
+        }
+      }
+      else if ( command == "node" )
+      {
+        RF24::LogicalAddress address = 0;
+        if ( ( tokens.size() < 2 ) || !parseAddress( tokens[ 1 ], address ) || !RF24::isAddressValid( address ) )
+        {
+          error = prefix + "expected 'node <octal address>'";
+          return false;
+        }
+
+        NodeSpec &node = addNode( desc, address, defaults );
+        for ( size_t x = 2; x < tokens.size(); x++ )
+        {
+          if ( !applyOption( tokens[ x ], node.cfg, &node.parent, detail ) )
+          {
+            error = prefix + detail;
+            return false;
+          }
+        }
+      }
+      else if ( command == "tree" )
+      {
+        size_t breadth = 0;
+        size_t depth   = 0;
+        double prune   = 0.0;
+        RF24::Endpoint::SystemInit treeCfg = defaults;
+
+        for ( size_t x = 1; x < tokens.size(); x++ )
+        {
+          if ( tokens[ x ].rfind( "breadth=", 0 ) == 0 )
+          {
+            parseNumber( tokens[ x ].substr( 8 ), 10, breadth );
+          }
+          else if ( tokens[ x ].rfind( "depth=", 0 ) == 0 )
+          {
+            parseNumber( tokens[ x ].substr( 6 ), 10, depth );
+          }
+          else if ( tokens[ x ].rfind( "prune=", 0 ) == 0 )
+          {
+            if ( !parseProbability( tokens[ x ].substr( 6 ), prune ) )
+            {
+              error = prefix + "invalid tree option '" + tokens[ x ] + "'";
+              return false;
+            }
+          }
+          else if ( !applyOption( tokens[ x ], treeCfg, nullptr, detail ) )
+          {
+            error = prefix + detail;
+            return false;
+          }
+        }
+
+        if ( ( breadth < 1 ) || ( breadth > 5 ) || ( depth < 1 ) || ( depth > RF24::NODE_LEVEL_5 ) )
+        {
+          error = prefix + "expected 'tree breadth=<1-5> depth=<1-5> [prune=<0-1>]'";
+          return false;
+        }
+
+        /*------------------------------------------------
+        Grow the tree one level at a time from the root. A
+        pruned child never joins the next level, so its whole
+        branch disappears with it.
+        ------------------------------------------------*/
+        const uint64_t seed = desc.seeded ? desc.seed : Random::getSeed();
+        std::mt19937_64 rng( Random::deriveSeed( seed, Random::STREAM_TOPOLOGY ) );
+
+        std::vector<RF24::LogicalAddress> level = { RF24::RootNode0 };
+        addNode( desc, RF24::RootNode0, treeCfg );
+
+        for ( size_t currentDepth = 0; currentDepth < depth; currentDepth++ )
+        {
+          std::vector<RF24::LogicalAddress> nextLevel;
+
+          for ( const RF24::LogicalAddress parent : level )
+          {
+            for ( size_t child = 0; child < breadth; child++ )
+            {
+              const auto site    = static_cast<RF24::Connection::BindSite>( static_cast<size_t>( RF24::Connection::BindSite::CHILD_1 ) + child );
+              const auto address = RF24::getChild( parent, site );
+
+              if ( ( prune > 0.0 ) && ( std::generate_canonical<double, 32>( rng ) < prune ) )
+              {
+                continue;
+              }
+
+              if ( address != RF24::Network::RSVD_ADDR_INVALID )
+              {
+                addNode( desc, address, treeCfg );
+                nextLevel.push_back( address );
+              }
+            }
+          }
+
+          level = nextLevel;
+        }
+      }
+      else if ( command == "traffic" )
+      {
+        /*------------------------------------------------
+        traffic <src> -> <dst> every <n> ms size <n> [start <n>] [count <n>] [window <n>]
+                [priority <level>] [echo]
+        ------------------------------------------------*/
+        TrafficSpec flow = { 0, 0, 0, 0, 0, 0, 0, false, Sim::Priority::Level::NORMAL };
+        bool valid       = ( tokens.size() >= 9 ) && ( tokens[ 2 ] == "->" ) && ( tokens[ 4 ] == "every" ) &&
+                     ( tokens[ 6 ] == "ms" ) && ( tokens[ 7 ] == "size" );
+
+        valid = valid && parseAddress( tokens[ 1 ], flow.source ) && parseAddress( tokens[ 3 ], flow.destination );
+        valid = valid && parseNumber( tokens[ 5 ], 10, flow.periodMs ) && parseNumber( tokens[ 8 ], 10, flow.size );
+
+        for ( size_t x = 9; valid && ( x < tokens.size() ); x++ )
+        {
+          if ( tokens[ x ] == "echo" )
+          {
+            flow.echo = true;
+          }
+          else if ( x + 1 >= tokens.size() )
+          {
+            valid = false;
+          }
+          else if ( tokens[ x ] == "start" )
+          {
+            valid = parseNumber( tokens[ ++x ], 10, flow.startMs );
+          }
+          else if ( tokens[ x ] == "count" )
+          {
+            valid = parseNumber( tokens[ ++x ], 10, flow.count );
+          }
+          else if ( tokens[ x ] == "window" )
+          {
+            valid = parseNumber( tokens[ ++x ], 10, flow.window );
+          }
+          else if ( tokens[ x ] == "priority" )
+          {
+            valid = parsePriority( tokens[ ++x ], flow.priority );
+          }
+          else
+          {
+            valid = false;
+          }
+        }
+
+        if ( !valid )
+        {
+          error = prefix + "expected 'traffic <src> -> <dst> every <n> ms size <n> [start <n>] [count <n>] [window <n>] "
+                           "[priority <alarm|control|normal|bulk>] [echo]'";
+          return false;
+        }
+
+        if ( flow.size > Fragment::MAX_MESSAGE_SIZE )
+        {
+          error = prefix + "traffic size exceeds the maximum fragmented message size";
+          return false;
+        }
+
+        desc.traffic.push_back( flow );
+      }
+      else if ( ( command == "channel" ) || ( command == "link" ) || ( command == "capture" ) )
+      {
+        /*------------------------------------------------
+        RF24::Endpoint transmits over its own loopback
+        sockets, not through Sim::Channel, so these would
+        silently change nothing
+        ------------------------------------------------*/
+        error = prefix + "'" + command + "' is not supported, simulated endpoints don't transmit through Sim::Channel";
+        return false;
+      }
+      else if ( command == "formation" )
+      {
+        if ( ( tokens.size() == 2 ) && ( tokens[ 1 ] == "parent" ) )
+        {
+          desc.formation = Formation::BY_PARENT;
+        }
+        else if ( ( tokens.size() == 2 ) && ( tokens[ 1 ] == "level" ) )
+        {
+          desc.formation = Formation::BY_LEVEL;
+        }
+        else
+        {
+          error = prefix + "expected 'formation <parent|level>'";
+          return false;
+        }
+      }
+      else if ( command == "transport" )
+      {
+        bool valid = ( tokens.size() >= 2 ) && ( ( tokens[ 1 ] == "none" ) || ( tokens[ 1 ] == "reliable" ) );
+        desc.transport.reliable = valid && ( tokens[ 1 ] == "reliable" );
+
+        for ( size_t x = 2; valid && ( x < tokens.size() ); x++ )
+        {
+          const size_t split    = tokens[ x ].find( '=' );
+          const std::string key = tokens[ x ].substr( 0, split );
+          size_t value          = 0;
+
+          valid = ( split != std::string::npos ) && parseNumber( tokens[ x ].substr( split + 1 ), 10, value );
+
+          if ( valid && ( key == "window" ) )
+          {
+            valid                 = ( value >= 1 ) && ( value <= Transport::MAX_WINDOW );
+            desc.transport.window = value;
+          }
+          else if ( valid && ( key == "rto" ) )
+          {
+            valid                       = ( value > 0 );
+            desc.transport.initialRtoMs = value;
+          }
+          else if ( valid && ( key == "retries" ) )
+          {
+            desc.transport.maxRetries = value;
+          }
+          else
+          {
+            valid = false;
+          }
+        }
+
+        if ( !valid )
+        {
+          error = prefix + "expected 'transport <none|reliable> [window=<1-32>] [rto=<ms>] [retries=<n>]'";
+          return false;
+        }
+      }
+      else if ( command == "scheduler" )
+      {
+        Sim::Priority::Config &cfg = desc.scheduler.cfg;
+        bool valid                 = ( tokens.size() >= 2 );
+
+        if ( valid && ( tokens[ 1 ] == "fifo" ) )
+        {
+          desc.scheduler.enabled = false;
+        }
+        else if ( valid && ( ( tokens[ 1 ] == "strict" ) || ( tokens[ 1 ] == "weighted" ) ) )
+        {
+          desc.scheduler.enabled = true;
+          cfg.policy = ( tokens[ 1 ] == "strict" ) ? Sim::Priority::Policy::STRICT : Sim::Priority::Policy::WEIGHTED;
+        }
+        else
+        {
+          valid = false;
+        }
+
+        for ( size_t x = 2; valid && ( x < tokens.size() ); x++ )
+        {
+          const size_t split      = tokens[ x ].find( '=' );
+          const std::string key   = tokens[ x ].substr( 0, split );
+          const std::string value = ( split != std::string::npos ) ? tokens[ x ].substr( split + 1 ) : "";
+
+          if ( key == "burst" )
+          {
+            valid = parseNumber( value, 10, cfg.burst );
+          }
+          else if ( key == "slots" )
+          {
+            valid = parseNumber( value, 10, number ) && ( number > 0 );
+            cfg.slots.fill( number );
+          }
+          else if ( key == "weights" )
+          {
+            /*------------------------------------------------
+            One weight per level below alarm, which ignores it
+            ------------------------------------------------*/
+            std::stringstream list( value );
+            std::string item;
+
+            for ( size_t level = 1; valid && ( level < Sim::Priority::NUM_LEVELS ); level++ )
+            {
+              valid = std::getline( list, item, ',' ) && parseNumber( item, 10, number ) && ( number > 0 );
+              cfg.weights[ level ] = number;
+            }
+
+            valid = valid && !std::getline( list, item, ',' );
+          }
+          else
+          {
+            valid = false;
+          }
+        }
+
+        if ( !valid )
+        {
+          error = prefix + "expected 'scheduler <fifo|strict|weighted> [burst=<n>] [slots=<n>] "
+                           "[weights=<control>,<normal>,<bulk>]'";
+          return false;
+        }
+      }
+      else if ( command == "coalesce" )
+      {
+        Sim::Coalesce::Config &cfg = desc.coalesce.cfg;
+        bool valid                 = ( tokens.size() >= 2 ) && ( ( tokens[ 1 ] == "off" ) || ( tokens[ 1 ] == "on" ) );
+        desc.coalesce.enabled      = valid && ( tokens[ 1 ] == "on" );
+
+        for ( size_t x = 2; valid && ( x < tokens.size() ); x++ )
+        {
+          const size_t split    = tokens[ x ].find( '=' );
+          const std::string key = tokens[ x ].substr( 0, split );
+
+          valid = ( split != std::string::npos ) && parseNumber( tokens[ x ].substr( split + 1 ), 10, number );
+
+          if ( valid && ( key == "hold" ) )
+          {
+            cfg.holdTimeMs = number;
+          }
+          else if ( valid && ( key == "open" ) )
+          {
+            valid       = ( number > 0 );
+            cfg.maxOpen = number;
+          }
+          else if ( valid && ( key == "pending" ) )
+          {
+            valid          = ( number > 0 );
+            cfg.maxPending = number;
+          }
+          else
+          {
+            valid = false;
+          }
+        }
+
+        if ( !valid )
+        {
+          error = prefix + "expected 'coalesce <off|on> [hold=<ms>] [open=<n>] [pending=<n>]'";
+          return false;
+        }
+      }
+      else if ( command == "headers" )
+      {
+        if ( ( tokens.size() != 2 ) || ( ( tokens[ 1 ] != "full" ) && ( tokens[ 1 ] != "compact" ) ) )
+        {
+          error = prefix + "expected 'headers <full|compact>'";
+          return false;
+        }
+
+        desc.compactHeaders = ( tokens[ 1 ] == "compact" );
+      }
+      else if ( command == "seed" )
+      {
+        if ( ( tokens.size() != 2 ) || !parseNumber( tokens[ 1 ], 0, number ) )
+        {
+          error = prefix + "expected 'seed <number>'";
+          return false;
+        }
+
+        desc.seeded = true;
+        desc.seed   = number;
+      }
+      else
+      {
+        error = prefix + "unknown directive '" + command + "'";
+        return false;
+      }
+    }
+
+    return validate( desc, error );
+  }
+
+  bool load( const std::string &path, Description &desc, std::string &error )
+  {
+    std::ifstream file( path );
+    if ( !file.is_open() )
+    {
+      error = "unable to open " + path;
+      return false;
+    }
+
+    return parse( file, desc, error );
+  }
+
+}    // namespace Sim::Scenario
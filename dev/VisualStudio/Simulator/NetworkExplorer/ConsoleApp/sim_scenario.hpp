@@ -0,0 +1,188 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_scenario.hpp
+ *
+ *  Description:
+ *    Declarative description of a simulated network: the topology, per node
+ *    configuration overrides and the traffic to drive through it. Scenarios
+ *    are plain text files, one directive per line. Anything after a '#' is a
+ *    comment.
+ *
+ *      name      <text>
+ *      duration  <ms>
+ *      workers   <count>
+ *
+ *      defaults  [key=value ...]
+ *      node      <octal address> [parent=<octal>] [key=value ...]
+ *        Supported keys: rxQueueSize, txQueueSize, channel, dataRate (250KBPS,
+ *        1MBPS, 2MBPS) and power (MIN, LOW, HIGH, MAX).
+ *
+ *      tree      breadth=<1-5> depth=<1-5> [prune=<0-1>] [key=value ...]
+ *        Pruning drops each generated branch with the given probability, drawn
+ *        from the scenario's seed when it is set before the tree directive.
+ *
+ *      traffic   <octal src> -> <octal dst> every <period> ms size <bytes> [start <ms>] [count <n>] [window <n>]
+ *                [priority <alarm|control|normal|bulk>] [echo]
+ *        A period of 0 sends as fast as the window and the endpoint's queue
+ *        allow. Echo has the destination return every message for round trip
+ *        timing. Sizes larger than one frame, up to Fragment::MAX_MESSAGE_SIZE,
+ *        are fragmented, which switches every node over to Fragment::Stream.
+ *
+ *      seed      <number>
+ *        Seeds the simulator's random streams, see Sim::Random. The clock stays
+ *        in real time, so thread scheduling still varies from run to run.
+ *
+ *      formation <parent|level>
+ *        Order in which nodes connect, see Formation.
+ *
+ *      transport <none|reliable> [window=<1-32>] [rto=<ms>] [retries=<n>]
+ *        Reliable carries all traffic through Transport::Reliable, with the
+ *        given window, initial retransmit timeout and retry limit, and caps
+ *        messages at Transport::MAX_MESSAGE_SIZE.
+ *
+ *      scheduler <fifo|strict|weighted> [burst=<n>] [slots=<n>] [weights=<control>,<normal>,<bulk>]
+ *        Anything but fifo, the default, queues each node's traffic by priority
+ *        in a Priority::Scheduler, and can't be combined with fragmentation or a
+ *        reliable transport. Under fifo, priorities are accepted but have no
+ *        effect.
+ *
+ *      coalesce  <off|on> [hold=<ms>] [open=<n>] [pending=<n>]
+ *        On packs each node's messages to the same destination into shared
+ *        frames through a Coalesce::Packer, holding them for at most the given
+ *        time. Can't be combined with the layers above either, and caps
+ *        messages at Coalesce::MAX_MESSAGE_SIZE.
+ *
+ *      headers   <full|compact>
+ *        Compact headers leave more room for data in each fragment, see
+ *        Fragment::Stream, and only matter once messages are being fragmented.
+ *
+ *    RF24::Endpoint still transmits over its own loopback sockets rather than
+ *    through Sim::Channel, so there are no channel, link or capture directives;
+ *    the parser rejects them instead of ignoring them.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_SCENARIO_HPP
+#define RF24_SIM_SCENARIO_HPP
+
+/* STL Includes */
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+#include <RF24Node/endpoint>
+
+/* Dev Includes */
+#include <sim_coalesce.hpp>
+#include <sim_priority.hpp>
+
+namespace Sim::Scenario
+{
+  /*-------------------------------------------------------------------------------
+  Enumerations
+  -------------------------------------------------------------------------------*/
+  enum class Formation : uint8_t
+  {
+    BY_PARENT, /**< A node connects as soon as its own parent has joined */
+    BY_LEVEL   /**< A level only starts connecting once the whole level above has joined */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct NodeSpec
+  {
+    std::string name;                /**< Human readable device name */
+    RF24::LogicalAddress address;    /**< Address of the node */
+    RF24::LogicalAddress parent;     /**< Address of the node's parent, RSVD_ADDR_INVALID for the root */
+    RF24::Endpoint::SystemInit cfg;  /**< Fully resolved endpoint configuration */
+  };
+
+  struct TrafficSpec
+  {
+    RF24::LogicalAddress source;      /**< Node generating the messages */
+    RF24::LogicalAddress destination; /**< Node the messages are addressed to */
+    size_t periodMs;                  /**< Time between messages */
+    size_t size;                      /**< Payload bytes per message */
+    size_t startMs;                   /**< Earliest time the flow may begin */
+    size_t count;                     /**< Number of messages to send, 0 for unlimited */
+    size_t window;                    /**< Messages allowed in flight at once, 0 for unlimited */
+    bool echo;                        /**< Destination sends each message back to the source */
+    Sim::Priority::Level priority;    /**< Class the messages are queued in, both ways for echo flows */
+  };
+
+  struct TransportSpec
+  {
+    bool reliable;                    /**< End-to-end acknowledged delivery through Transport::Reliable */
+    size_t window;                    /**< Messages in flight to each peer */
+    size_t initialRtoMs;              /**< Retransmit timeout until a round trip has been measured */
+    size_t maxRetries;                /**< Retransmissions before a message is abandoned, 0 for no limit */
+  };
+
+  struct SchedulerSpec
+  {
+    bool enabled;                     /**< Traffic is queued by priority instead of straight into the endpoint */
+    Sim::Priority::Config cfg;
+  };
+
+  struct CoalesceSpec
+  {
+    bool enabled;                     /**< Small messages share frames through Coalesce::Packer */
+    Sim::Coalesce::Config cfg;
+  };
+
+  struct Description
+  {
+    std::string name;
+    size_t durationMs;
+    size_t workers;
+    std::vector<NodeSpec> nodes;
+    std::vector<TrafficSpec> traffic;
+    bool seeded;             /**< A seed directive was given */
+    uint64_t seed;           /**< Seed for Sim::Random when seeded */
+    Formation formation;     /**< Order in which nodes connect to the network */
+    TransportSpec transport; /**< How traffic flows are carried end to end */
+    SchedulerSpec scheduler; /**< How each node orders its outgoing traffic */
+    CoalesceSpec coalesce;   /**< Whether each node packs its messages together */
+    bool compactHeaders;     /**< Fragments are sent with the compact header */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Builds the configuration every node starts from before overrides
+   *
+   *  @return RF24::Endpoint::SystemInit
+   */
+  RF24::Endpoint::SystemInit defaultConfig();
+
+  /**
+   *  Parses a scenario from a stream
+   *
+   *  @param[in]  stream    Text to parse
+   *  @param[out] desc      The resulting scenario
+   *  @param[out] error     Description of the first problem found, if any
+   *  @return bool          True if the scenario parsed and validated
+   */
+  bool parse( std::istream &stream, Description &desc, std::string &error );
+
+  /**
+   *  Parses a scenario from a file
+   *
+   *  @param[in]  path      File to load
+   *  @param[out] desc      The resulting scenario
+   *  @param[out] error     Description of the first problem found, if any
+   *  @return bool          True if the scenario parsed and validated
+   */
+  bool load( const std::string &path, Description &desc, std::string &error );
+
+}    // namespace Sim::Scenario
+
+#endif /* !RF24_SIM_SCENARIO_HPP */
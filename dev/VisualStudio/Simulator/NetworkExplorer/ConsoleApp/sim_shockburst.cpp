@@ -0,0 +1,647 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_shockburst.cpp
+ *
+ *  Description:
+ *    Enhanced ShockBurst model implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <cstring>
+
+/* Dev Includes */
+#include <sim_clock.hpp>
+#include <sim_shockburst.hpp>
+
+namespace Sim::ShockBurst
+{
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Stand-in for the on-air CRC, only used to tell a retransmission apart
+   *  from a new frame that happens to reuse the same PID.
+   */
+  static uint32_t payloadCrc( const Medium::Frame &frame )
+  {
+    uint32_t hash = 2166136261u;
+
+    for ( size_t x = 0; x < frame.length; x++ )
+    {
+      hash = ( hash ^ frame.payload[ x ] ) * 16777619u;
+    }
+
+    return hash;
+  }
+
+  /**
+   *  Time the host spends clocking a payload into the TX FIFO
+   */
+  static uint64_t uploadTimeUs( const size_t length, const uint32_t spiClockHz )
+  {
+    if ( !spiClockHz )
+    {
+      return 0;
+    }
+
+    const uint64_t bits = ( SPI_COMMAND_SIZE + length ) * 8u;
+    return ( ( bits * 1000000u ) + spiClockHz - 1 ) / spiClockHz;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Transceiver Implementation
+  -------------------------------------------------------------------------------*/
+  Transceiver_sPtr Transceiver::createShared( const Config &cfg )
+  {
+    return Transceiver_sPtr( new Transceiver( cfg ) );
+  }
+
+  Transceiver::Transceiver( const Config &cfg ) :
+      mConfig( cfg ), mStatus{}, mStats{}, mNextPid( 0 ), mTxAttempts( 0 ), mTxGeneration( 0 ), mSpiIdleUs( 0 )
+  {
+    mConfig.retryDelay = std::min<uint8_t>( mConfig.retryDelay, 15 );
+    mConfig.retryCount = std::min<uint8_t>( mConfig.retryCount, MAX_RETRANSMITS );
+
+    mPipeOpen.fill( false );
+    mPipeAddress.fill( 0 );
+    mHeld.fill( HeldFrame{} );
+  }
+
+  Transceiver::~Transceiver()
+  {
+    for ( size_t pipe = 0; pipe < mPipeOpen.size(); pipe++ )
+    {
+      if ( mPipeOpen[ pipe ] )
+      {
+        Channel::detachReceiver( mPipeAddress[ pipe ] );
+      }
+    }
+  }
+
+  void Transceiver::openReadingPipe( const RF24::Hardware::PipeNumber pipe, const Medium::Address address )
+  {
+    if ( pipe >= RF24::Hardware::MAX_NUM_PIPES )
+    {
+      return;
+    }
+
+    closeReadingPipe( pipe );
+
+    {
+      std::lock_guard<std::mutex> lock( mLock );
+      mPipeOpen[ pipe ]    = true;
+      mPipeAddress[ pipe ] = address;
+      mPipeRing[ pipe ]    = Medium::openPipe( address );
+    }
+
+    /*------------------------------------------------
+    Frames can still be in the air after the endpoint is
+    gone, so the receiver only holds a weak reference.
+    ------------------------------------------------*/
+    std::weak_ptr<Transceiver> weakSelf = shared_from_this();
+
+    Channel::attachReceiver( address, [ weakSelf, pipe ]( const Medium::Frame &frame ) {
+      auto self = weakSelf.lock();
+      return self ? self->onFrame( pipe, frame ) : Channel::Outcome::DROPPED;
+    } );
+  }
+
+  void Transceiver::closeReadingPipe( const RF24::Hardware::PipeNumber pipe )
+  {
+    Medium::Address address = 0;
+
+    {
+      std::lock_guard<std::mutex> lock( mLock );
+      if ( ( pipe >= RF24::Hardware::MAX_NUM_PIPES ) || !mPipeOpen[ pipe ] )
+      {
+        return;
+      }
+
+      mPipeOpen[ pipe ]   = false;
+      mHeld[ pipe ].valid = false;
+      mPipeRing[ pipe ].reset();
+      address = mPipeAddress[ pipe ];
+    }
+
+    Channel::detachReceiver( address );
+  }
+
+  bool Transceiver::transmit( const Medium::Address destination, const void *const data, const size_t length, const bool noAck )
+  {
+    if ( !data || ( length > Medium::FRAME_WIDTH ) )
+    {
+      return false;
+    }
+
+    bool sendNow = false;
+
+    {
+      std::lock_guard<std::mutex> lock( mLock );
+
+      if ( mStatus.maxRetries || txFifoFull() || !mPipeOpen[ RF24::Hardware::PIPE_NUM_0 ] )
+      {
+        return false;
+      }
+
+      if ( loadTxFrame( destination, static_cast<const uint8_t *>( data ), length, noAck ) )
+      {
+        sendNow = startHead( false );
+      }
+    }
+
+    if ( sendNow )
+    {
+      sendAttempt();
+    }
+
+    return true;
+  }
+
+  ForwardResult Transceiver::forward( const RF24::Hardware::PipeNumber pipe, const ForwardDecision &decide, Medium::Frame &local )
+  {
+    bool sendNow = false;
+
+    {
+      std::lock_guard<std::mutex> lock( mLock );
+
+      if ( ( pipe >= RF24::Hardware::MAX_NUM_PIPES ) || !mPipeOpen[ pipe ] || !decide )
+      {
+        return ForwardResult::EMPTY;
+      }
+
+      /*------------------------------------------------
+      Decide where the frame goes before looking at the
+      transmitter. A frame held from an earlier call was
+      already decided on and keeps its place in line.
+      ------------------------------------------------*/
+      HeldFrame &held = mHeld[ pipe ];
+
+      if ( !held.valid )
+      {
+        if ( !mPipeRing[ pipe ]->pop( held.frame ) )
+        {
+          return ForwardResult::EMPTY;
+        }
+
+        held.nextHop = 0;
+        if ( !decide( held.frame, held.nextHop ) )
+        {
+          local = held.frame;
+          return ForwardResult::LOCAL;
+        }
+
+        held.valid = true;
+      }
+
+      if ( mStatus.maxRetries || txFifoFull() || !mPipeOpen[ RF24::Hardware::PIPE_NUM_0 ] )
+      {
+        return ForwardResult::BUSY;
+      }
+
+      const Medium::Frame &frame = held.frame;
+      if ( loadTxFrame( held.nextHop, frame.payload.data(), frame.length, ( frame.flags & Medium::FRAME_FLAG_NO_ACK ) != 0 ) )
+      {
+        sendNow = startHead( false );
+      }
+
+      held.valid = false;
+      mStats.framesForwarded++;
+    }
+
+    if ( sendNow )
+    {
+      sendAttempt();
+    }
+
+    return ForwardResult::FORWARDED;
+  }
+
+  bool Transceiver::writeAckPayload( const RF24::Hardware::PipeNumber pipe, const void *const data, const size_t length )
+  {
+    if ( ( pipe >= RF24::Hardware::MAX_NUM_PIPES ) || !data || ( length > Medium::FRAME_WIDTH ) )
+    {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock( mLock );
+
+    if ( txFifoFull() )
+    {
+      return false;
+    }
+
+    AckEntry entry{};
+    entry.pipe         = pipe;
+    entry.frame.length = static_cast<uint8_t>( length );
+    memcpy( entry.frame.payload.data(), data, length );
+
+    mAckPayloads.push_back( entry );
+    mStatus.txFull = txFifoFull();
+    return true;
+  }
+
+  Status Transceiver::getStatus()
+  {
+    std::lock_guard<std::mutex> lock( mLock );
+    return mStatus;
+  }
+
+  void Transceiver::clearStatus()
+  {
+    std::lock_guard<std::mutex> lock( mLock );
+    mStatus.txDataSent = false;
+
+    if ( !mStatus.maxRetries )
+    {
+      return;
+    }
+
+    mStatus.maxRetries = false;
+    mTxFifo.pop_front();
+    mStatus.txFull = txFifoFull();
+
+    if ( !mTxFifo.empty() )
+    {
+      startHead( true );
+    }
+  }
+
+  bool Transceiver::retryTransmit()
+  {
+    std::lock_guard<std::mutex> lock( mLock );
+
+    if ( !mStatus.maxRetries || mTxFifo.empty() )
+    {
+      return false;
+    }
+
+    /*------------------------------------------------
+    Same payload and PID, so if only the ACKs were lost
+    the receiver drops the copy and acknowledges it.
+    ------------------------------------------------*/
+    mStatus.maxRetries = false;
+    mStats.framesReused++;
+    startHead( true );
+    return true;
+  }
+
+  size_t Transceiver::flushTx()
+  {
+    std::lock_guard<std::mutex> lock( mLock );
+
+    const size_t dropped = mTxFifo.size() + mAckPayloads.size();
+
+    mTxFifo.clear();
+    mAckPayloads.clear();
+    mTxGeneration++;
+    mStatus.txBusy     = false;
+    mStatus.txFull     = false;
+    mStatus.maxRetries = false;
+    mStats.framesFlushed += dropped;
+
+    return dropped;
+  }
+
+  RetryStats Transceiver::getStats()
+  {
+    std::lock_guard<std::mutex> lock( mLock );
+    return mStats;
+  }
+
+  void Transceiver::setIrqHook( std::function<void()> hook )
+  {
+    std::lock_guard<std::mutex> lock( mLock );
+    mIrqHook = std::move( hook );
+  }
+
+  size_t Transceiver::txDepth() const
+  {
+    return mConfig.streamTx ? TX_FIFO_DEPTH : 1;
+  }
+
+  bool Transceiver::txFifoFull() const
+  {
+    /*------------------------------------------------
+    Expects mLock to be held. Queued ACK payloads take
+    up slots even when only one frame is sent at a time.
+    ------------------------------------------------*/
+    return ( mTxFifo.size() >= txDepth() ) || ( ( mTxFifo.size() + mAckPayloads.size() ) >= TX_FIFO_DEPTH );
+  }
+
+  bool Transceiver::loadTxFrame( const Medium::Address destination, const uint8_t *const data, const size_t length,
+                                 const bool noAck )
+  {
+    /*------------------------------------------------
+    Expects mLock to be held. The PID only advances for
+    new payloads, never for retransmissions of the one
+    already in flight.
+    ------------------------------------------------*/
+    mNextPid = ( mNextPid + 1 ) & 0x03;
+
+    TxEntry entry{};
+    entry.frame.source  = mPipeAddress[ RF24::Hardware::PIPE_NUM_0 ];
+    entry.frame.channel = mConfig.channel;
+    entry.frame.length  = static_cast<uint8_t>( length );
+    entry.frame.pid     = mNextPid;
+    entry.frame.flags   = noAck ? Medium::FRAME_FLAG_NO_ACK : 0;
+    entry.destination   = destination;
+    memcpy( entry.frame.payload.data(), data, length );
+
+    /*------------------------------------------------
+    Uploads share one SPI bus, so each starts once the
+    previous one is done. In streaming mode that happens
+    while earlier frames are on the air.
+    ------------------------------------------------*/
+    mSpiIdleUs    = std::max( mSpiIdleUs, Clock::micros() ) + uploadTimeUs( length, mConfig.spiClockHz );
+    entry.readyUs = mSpiIdleUs;
+
+    mTxFifo.push_back( entry );
+    mStatus.txFull = txFifoFull();
+
+    if ( mTxFifo.size() > 1 )
+    {
+      return false;
+    }
+
+    mStatus.txDataSent = false;
+    return true;
+  }
+
+  bool Transceiver::startHead( const bool deferred )
+  {
+    /*------------------------------------------------
+    Expects mLock to be held. Returns true when the head
+    can go out right away and the caller will send it
+    once the lock is released. Otherwise the first
+    attempt waits on the clock for the upload to finish.
+    ------------------------------------------------*/
+    mTxAttempts    = 0;
+    mStatus.txBusy = true;
+
+    const uint64_t now   = Clock::micros();
+    const uint64_t ready = mTxFifo.front().readyUs;
+
+    if ( !deferred && ( ready <= now ) )
+    {
+      return true;
+    }
+
+    std::weak_ptr<Transceiver> weakSelf = shared_from_this();
+    const uint64_t generation           = mTxGeneration;
+
+    Clock::schedule( ( ready > now ) ? ( ready - now ) : 0, [ weakSelf, generation ]() {
+      if ( auto self = weakSelf.lock() )
+      {
+        self->onUploadDone( generation );
+      }
+    } );
+
+    return false;
+  }
+
+  void Transceiver::onUploadDone( const uint64_t generation )
+  {
+    {
+      std::lock_guard<std::mutex> lock( mLock );
+
+      if ( ( generation != mTxGeneration ) || !mStatus.txBusy )
+      {
+        return;
+      }
+    }
+
+    sendAttempt();
+  }
+
+  void Transceiver::sendAttempt()
+  {
+    Medium::Frame frame;
+    Medium::Address destination;
+    uint64_t generation = 0;
+    bool expectAck      = false;
+
+    {
+      std::lock_guard<std::mutex> lock( mLock );
+
+      if ( mTxFifo.empty() )
+      {
+        return;
+      }
+
+      mTxAttempts++;
+      mStats.attempts++;
+
+      frame       = mTxFifo.front().frame;
+      destination = mTxFifo.front().destination;
+
+      if ( mTxAttempts > 1 )
+      {
+        frame.flags |= Medium::FRAME_FLAG_RETRY;
+      }
+
+      generation  = mTxGeneration;
+      expectAck   = mConfig.autoAck && !( frame.flags & Medium::FRAME_FLAG_NO_ACK );
+    }
+
+    const uint64_t txEnd = Channel::transmit( frame, destination, mConfig.dataRate );
+    const uint64_t now   = Clock::micros();
+    const uint64_t delay = ( txEnd > now ) ? ( txEnd - now ) : 0;
+    const uint64_t wait  = expectAck ? retryDelayUs( mConfig.retryDelay ) : 0;
+
+    /*------------------------------------------------
+    Without an ACK to wait on, TX_DS asserts as soon as
+    the frame has left the antenna. Otherwise the radio
+    listens for up to ARD before trying again.
+    ------------------------------------------------*/
+    std::weak_ptr<Transceiver> weakSelf = shared_from_this();
+
+    Clock::schedule( delay + wait, [ weakSelf, generation ]() {
+      if ( auto self = weakSelf.lock() )
+      {
+        self->onAckTimeout( generation );
+      }
+    } );
+  }
+
+  void Transceiver::onAckTimeout( const uint64_t generation )
+  {
+    {
+      std::lock_guard<std::mutex> lock( mLock );
+
+      if ( ( generation != mTxGeneration ) || !mStatus.txBusy )
+      {
+        return;
+      }
+
+      if ( !mConfig.autoAck || ( mTxFifo.front().frame.flags & Medium::FRAME_FLAG_NO_ACK ) )
+      {
+        completeTransmit( true );
+        return;
+      }
+
+      if ( mTxAttempts > mConfig.retryCount )
+      {
+        completeTransmit( false );
+        return;
+      }
+    }
+
+    sendAttempt();
+  }
+
+  void Transceiver::completeTransmit( const bool acknowledged )
+  {
+    /*------------------------------------------------
+    Expects mLock to be held. The IRQ hook is deferred
+    onto the clock so it never runs under the lock. A
+    frame that hit MAX_RT stays at the head of the FIFO
+    until the owner decides to drop or resend it.
+    ------------------------------------------------*/
+    mTxGeneration++;
+    mStatus.txBusy = false;
+
+    if ( acknowledged )
+    {
+      mStatus.txDataSent = true;
+      mStats.framesSent++;
+      mStats.retransmitHistogram[ std::min( mTxAttempts - 1, MAX_RETRANSMITS ) ]++;
+
+      mTxFifo.pop_front();
+      mStatus.txFull = txFifoFull();
+
+      if ( !mTxFifo.empty() )
+      {
+        startHead( true );
+      }
+    }
+    else
+    {
+      mStatus.maxRetries = true;
+      mStats.maxRetryEvents++;
+    }
+
+    if ( mIrqHook )
+    {
+      Clock::schedule( 0, mIrqHook );
+    }
+  }
+
+  Channel::Outcome Transceiver::onFrame( const size_t pipe, const Medium::Frame &frame )
+  {
+    if ( frame.flags & Medium::FRAME_FLAG_ACK )
+    {
+      return onAck( frame );
+    }
+
+    Medium::Frame ack{};
+    bool sendAck = false;
+
+    {
+      std::lock_guard<std::mutex> lock( mLock );
+
+      if ( !mPipeOpen[ pipe ] )
+      {
+        return Channel::Outcome::DROPPED;
+      }
+
+      /*------------------------------------------------
+      A matching PID and CRC means the transmitter never
+      saw our ACK and sent the same frame again. Drop the
+      copy, but acknowledge it so the sender moves on.
+      ------------------------------------------------*/
+      const uint32_t crc = payloadCrc( frame );
+      auto history       = mRxHistory.find( frame.source );
+
+      if ( ( history != mRxHistory.end() ) && ( history->second.pid == frame.pid ) && ( history->second.crc == crc ) )
+      {
+        mStats.duplicatesDropped++;
+      }
+      else if ( !mPipeRing[ pipe ]->push( frame ) )
+      {
+        /* RX FIFO full: the real radio neither stores nor ACKs the frame */
+        mStats.rxOverflows++;
+        return Channel::Outcome::DROPPED;
+      }
+      else
+      {
+        mRxHistory[ frame.source ] = { frame.pid, crc };
+      }
+
+      /*------------------------------------------------
+      Build the ACK, attaching a queued payload if any
+      ------------------------------------------------*/
+      if ( mConfig.autoAck && !( frame.flags & Medium::FRAME_FLAG_NO_ACK ) )
+      {
+        sendAck = true;
+
+        auto queued = std::find_if( mAckPayloads.begin(), mAckPayloads.end(),
+                                    [ pipe ]( const AckEntry &entry ) { return entry.pipe == pipe; } );
+
+        if ( queued != mAckPayloads.end() )
+        {
+          ack = queued->frame;
+          mAckPayloads.erase( queued );
+          mStatus.txFull = txFifoFull();
+          mStats.ackPayloadsSent++;
+        }
+
+        ack.source  = mPipeAddress[ pipe ];
+        ack.channel = frame.channel;
+        ack.pid     = frame.pid;
+        ack.flags   = Medium::FRAME_FLAG_ACK;
+        mStats.acksSent++;
+      }
+    }
+
+    /*------------------------------------------------
+    The ACK goes back to the transmitter's pipe 0, which
+    is also the source address of its frames.
+    ------------------------------------------------*/
+    if ( sendAck )
+    {
+      Channel::transmit( ack, frame.source, mConfig.dataRate );
+    }
+
+    return Channel::Outcome::DELIVERED;
+  }
+
+  Channel::Outcome Transceiver::onAck( const Medium::Frame &frame )
+  {
+    std::lock_guard<std::mutex> lock( mLock );
+
+    /*------------------------------------------------
+    Late ACKs for a frame that already completed, or ACKs
+    from the wrong node, are ignored by the radio.
+    ------------------------------------------------*/
+    if ( !mStatus.txBusy || mTxFifo.empty() || ( frame.pid != mTxFifo.front().frame.pid ) ||
+         ( frame.source != mTxFifo.front().destination ) )
+    {
+      return Channel::Outcome::DELIVERED;
+    }
+
+    Channel::Outcome outcome = Channel::Outcome::DELIVERED;
+
+    if ( frame.length )
+    {
+      Medium::Frame payload = frame;
+      payload.flags         = 0;
+
+      if ( mPipeRing[ RF24::Hardware::PIPE_NUM_0 ] && mPipeRing[ RF24::Hardware::PIPE_NUM_0 ]->push( payload ) )
+      {
+        mStats.ackPayloadsReceived++;
+      }
+      else
+      {
+        mStats.rxOverflows++;
+        outcome = Channel::Outcome::DROPPED;
+      }
+    }
+
+    completeTransmit( true );
+    return outcome;
+  }
+
+}    // namespace Sim::ShockBurst
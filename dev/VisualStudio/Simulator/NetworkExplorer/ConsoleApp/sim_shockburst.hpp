@@ -0,0 +1,309 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_shockburst.hpp
+ *
+ *  Description:
+ *    Model of the nRF24L01 Enhanced ShockBurst engine: packet identity,
+ *    automatic acknowledgements (optionally carrying a payload), automatic
+ *    retransmission governed by the ARD/ARC settings and the MAX_RT condition.
+ *    Frames travel over the simulated RF channel, so retry behavior reacts to
+ *    airtime, loss and collisions the same way the real radio would. In
+ *    streaming mode the 3-deep TX FIFO is modeled as well, so payloads can be
+ *    uploaded while earlier ones are still on the air.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_SHOCKBURST_HPP
+#define RF24_SIM_SHOCKBURST_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+
+/* Dev Includes */
+#include <sim_channel.hpp>
+#include <sim_medium.hpp>
+
+namespace Sim::ShockBurst
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t MAX_RETRANSMITS   = 15;  /**< Largest value the ARC field can hold */
+  static constexpr uint64_t ARD_STEP_US     = 250; /**< Auto retransmit delay resolution */
+  static constexpr size_t TX_FIFO_DEPTH     = 3;   /**< Depth of the hardware TX FIFO, shared by TX and ACK payloads */
+  static constexpr size_t SPI_COMMAND_SIZE  = 1;   /**< W_TX_PAYLOAD byte ahead of every upload */
+
+  /*-------------------------------------------------------------------------------
+  Enumerations
+  -------------------------------------------------------------------------------*/
+  enum class ForwardResult : uint8_t
+  {
+    EMPTY,     /**< Nothing was waiting on the pipe */
+    BUSY,      /**< The frame needs forwarding but the transmitter is occupied, it is held for the next call */
+    FORWARDED, /**< The frame went straight back out to its next hop */
+    LOCAL      /**< The frame is for this node and was copied out */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct Config
+  {
+    uint8_t channel;                   /**< RF channel to operate on */
+    RF24::Hardware::DataRate dataRate; /**< Air data rate */
+    uint8_t retryDelay;                /**< SETUP_RETR.ARD, waits (retryDelay + 1) * 250us for an ACK */
+    uint8_t retryCount;                /**< SETUP_RETR.ARC, number of retransmits before MAX_RT */
+    bool autoAck;                      /**< EN_AA, applied to every pipe */
+    bool streamTx;                     /**< Keeps up to TX_FIFO_DEPTH frames queued instead of one at a time */
+    uint32_t spiClockHz;               /**< Host SPI clock, times payload uploads. Zero makes them instant. */
+  };
+
+  struct Status
+  {
+    bool txDataSent; /**< TX_DS: the last frame was acknowledged (or sent, if no ACK was requested) */
+    bool maxRetries; /**< MAX_RT: retransmits ran out. Blocks further TX until cleared. */
+    bool txBusy;     /**< A frame is still being sent or waiting on its ACK */
+    bool txFull;     /**< FIFO_STATUS.TX_FULL: transmit() will refuse another frame */
+  };
+
+  struct RetryStats
+  {
+    size_t framesSent;          /**< Frames that completed with TX_DS */
+    size_t maxRetryEvents;      /**< Frames that completed with MAX_RT */
+    size_t attempts;            /**< Every transmission, including retransmits */
+    size_t acksSent;            /**< ACKs this endpoint replied with */
+    size_t ackPayloadsSent;
+    size_t ackPayloadsReceived;
+    size_t duplicatesDropped;   /**< Retransmits filtered out by the PID/CRC check */
+    size_t rxOverflows;         /**< Frames refused (and not ACK'd) because the RX pipe was full */
+    size_t framesForwarded;     /**< Frames forward() loaded for their next hop */
+    size_t framesReused;        /**< Frames sent again by retryTransmit() after MAX_RT */
+    size_t framesFlushed;       /**< Queued frames and ACK payloads dropped by flushTx() */
+    std::array<size_t, MAX_RETRANSMITS + 1> retransmitHistogram; /**< Acknowledged frames by retransmits needed */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  class Transceiver;
+  using Transceiver_sPtr = std::shared_ptr<Transceiver>;
+
+  /**
+   *  Routing decision for a received frame. May rewrite the frame's payload
+   *  in place, e.g. to update a network header, and fills in where to send it.
+   *  Returns false to keep the frame for the local node instead. Runs with
+   *  the transceiver locked, so it must not call back into the transceiver.
+   */
+  using ForwardDecision = std::function<bool( Medium::Frame &frame, Medium::Address &nextHop )>;
+
+  class Transceiver : public std::enable_shared_from_this<Transceiver>
+  {
+  public:
+    /**
+     *  Creates a transceiver. Shared ownership lets in-flight frames outlive
+     *  the endpoint that sent them without dangling.
+     *
+     *  @param[in]  cfg       Radio settings
+     *  @return Transceiver_sPtr
+     */
+    static Transceiver_sPtr createShared( const Config &cfg );
+    ~Transceiver();
+
+    /**
+     *  Starts listening on a pipe. Pipe 0 doubles as the transceiver's own
+     *  address: it is the source of every frame sent and where ACKs return to.
+     *
+     *  @param[in]  pipe      Which pipe to open
+     *  @param[in]  address   Physical address of the pipe
+     *  @return void
+     */
+    void openReadingPipe( const RF24::Hardware::PipeNumber pipe, const Medium::Address address );
+
+    /**
+     *  Stops listening on a pipe
+     *
+     *  @param[in]  pipe      Which pipe to close
+     *  @return void
+     */
+    void closeReadingPipe( const RF24::Hardware::PipeNumber pipe );
+
+    /**
+     *  Sends a frame, retrying automatically until it is acknowledged or the
+     *  retransmit count runs out. Completion is reported through getStatus().
+     *  In streaming mode the frame joins the TX FIFO behind any others and is
+     *  sent as soon as they complete, so the caller can keep the FIFO topped
+     *  up on every TX_DS instead of waiting for the radio to go idle.
+     *
+     *  @param[in]  destination Physical address of the receiving pipe
+     *  @param[in]  data        Payload to send
+     *  @param[in]  length      Payload bytes, at most FRAME_WIDTH
+     *  @param[in]  noAck       Sets the NO_ACK bit so the receiver won't reply
+     *  @return bool            False if the TX FIFO is full, MAX_RT is pending or pipe 0 isn't open
+     */
+    bool transmit( const Medium::Address destination, const void *const data, const size_t length, const bool noAck = false );
+
+    /**
+     *  Relay path for routing nodes. Takes the oldest frame on a pipe and lets
+     *  the decision rewrite it. Frames for this node are copied out right
+     *  away, whatever the state of the transmitter. A frame bound elsewhere is
+     *  loaded into the TX FIFO and sent like transmit() would, keeping its
+     *  NO_ACK bit, without ever reaching the caller. If the TX FIFO is full it
+     *  is held, already rewritten, and goes out on a later call before any
+     *  newer frame on that pipe is looked at.
+     *
+     *  @param[in]  pipe        Pipe to take the frame from
+     *  @param[in]  decide      Rewrites the frame and picks its next hop
+     *  @param[out] local       Receives the frame if it's for this node
+     *  @return ForwardResult
+     */
+    ForwardResult forward( const RF24::Hardware::PipeNumber pipe, const ForwardDecision &decide, Medium::Frame &local );
+
+    /**
+     *  Queues a payload to ride along with the next ACK sent from a pipe.
+     *  Like on the real radio, ACK payloads for every pipe sit in the same
+     *  TX FIFO as frames waiting to be sent, and each one takes a slot.
+     *
+     *  @param[in]  pipe      Pipe the ACK will be sent from
+     *  @param[in]  data      Payload to attach
+     *  @param[in]  length    Payload bytes, at most FRAME_WIDTH
+     *  @return bool          False if the TX FIFO is full
+     */
+    bool writeAckPayload( const RF24::Hardware::PipeNumber pipe, const void *const data, const size_t length );
+
+    /**
+     *  Reads the interrupt flags
+     *
+     *  @return Status
+     */
+    Status getStatus();
+
+    /**
+     *  Clears TX_DS and MAX_RT. A frame that hit MAX_RT is discarded and any
+     *  frames queued behind it go out next.
+     *
+     *  @return void
+     */
+    void clearStatus();
+
+    /**
+     *  Clears MAX_RT and sends the frame that hit it again with a fresh
+     *  retransmit count, the equivalent of pulsing CE with the payload still
+     *  at the head of the FIFO. Frames queued behind it keep waiting.
+     *
+     *  @return bool          False if MAX_RT wasn't pending
+     */
+    bool retryTransmit();
+
+    /**
+     *  Drops every frame in the TX FIFO, including one in flight and any
+     *  queued ACK payloads, and clears MAX_RT. Mirrors the FLUSH_TX command.
+     *
+     *  @return size_t        Payloads dropped
+     */
+    size_t flushTx();
+
+    /**
+     *  Gets the retry statistics accumulated since creation
+     *
+     *  @return RetryStats
+     */
+    RetryStats getStats();
+
+    /**
+     *  Registers a callback fired whenever TX_DS or MAX_RT gets set, the
+     *  equivalent of the IRQ line. Typically used to wake the owning node.
+     *
+     *  @param[in]  hook      Callback to invoke, or an empty function to disable
+     *  @return void
+     */
+    void setIrqHook( std::function<void()> hook );
+
+  private:
+    explicit Transceiver( const Config &cfg );
+
+    struct RxHistory
+    {
+      uint8_t pid;
+      uint32_t crc;
+    };
+
+    struct TxEntry
+    {
+      Medium::Frame frame;
+      Medium::Address destination;
+      uint64_t readyUs; /**< When the payload upload finishes */
+    };
+
+    struct AckEntry
+    {
+      RF24::Hardware::PipeNumber pipe;
+      Medium::Frame frame;
+    };
+
+    struct HeldFrame
+    {
+      bool valid;
+      Medium::Frame frame;
+      Medium::Address nextHop;
+    };
+
+    std::mutex mLock;
+    Config mConfig;
+    Status mStatus;
+    RetryStats mStats;
+    std::function<void()> mIrqHook;
+
+    std::array<bool, RF24::Hardware::MAX_NUM_PIPES> mPipeOpen;
+    std::array<Medium::Address, RF24::Hardware::MAX_NUM_PIPES> mPipeAddress;
+    std::array<Medium::Pipe, RF24::Hardware::MAX_NUM_PIPES> mPipeRing;
+    std::deque<AckEntry> mAckPayloads; /**< Takes TX FIFO slots alongside mTxFifo */
+    std::array<HeldFrame, RF24::Hardware::MAX_NUM_PIPES> mHeld; /**< Frames forward() couldn't load yet, per pipe */
+    std::unordered_map<Medium::Address, RxHistory> mRxHistory; /**< Last frame seen from each transmitter */
+
+    std::deque<TxEntry> mTxFifo; /**< Head is the frame in flight */
+    uint8_t mNextPid;
+    size_t mTxAttempts;
+    uint64_t mTxGeneration; /**< Bumped whenever the frame in flight completes, invalidating stale timeouts */
+    uint64_t mSpiIdleUs;    /**< When the last queued upload finishes */
+
+    size_t txDepth() const;
+    bool txFifoFull() const;
+    bool loadTxFrame( const Medium::Address destination, const uint8_t *const data, const size_t length, const bool noAck );
+    bool startHead( const bool deferred );
+    void onUploadDone( const uint64_t generation );
+    void sendAttempt();
+    void onAckTimeout( const uint64_t generation );
+    void completeTransmit( const bool acknowledged );
+    Channel::Outcome onFrame( const size_t pipe, const Medium::Frame &frame );
+    Channel::Outcome onAck( const Medium::Frame &frame );
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Converts the ARD register field into the delay it represents
+   *
+   *  @param[in]  retryDelay  SETUP_RETR.ARD value, 0-15
+   *  @return uint64_t        Delay in microseconds
+   */
+  constexpr uint64_t retryDelayUs( const uint8_t retryDelay )
+  {
+    return ( static_cast<uint64_t>( retryDelay ) + 1 ) * ARD_STEP_US;
+  }
+
+}    // namespace Sim::ShockBurst
+
+#endif /* !RF24_SIM_SHOCKBURST_HPP */
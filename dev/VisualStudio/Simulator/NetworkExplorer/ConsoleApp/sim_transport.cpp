@@ -0,0 +1,530 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_transport.cpp
+ *
+ *  Description:
+ *    Reliable end-to-end transport implementation
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <cstring>
+
+/* Chimera Includes */
+#include <Chimera/common>
+
+/* Dev Includes */
+#include <sim_clock.hpp>
+#include <sim_transport.hpp>
+
+namespace Sim::Transport
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint8_t TYPE_DATA           = 0x01;
+  static constexpr uint8_t TYPE_ACK            = 0x02;
+  static constexpr size_t FAST_RETRANSMIT_SACKS = 3;    /**< Later messages the peer must hold before a gap is resent early */
+  static constexpr uint64_t RTO_GRANULARITY    = 1000; /**< Smallest variance term (us) added to the smoothed RTT */
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Signed distance between two sequence numbers. The window is far smaller
+   *  than half the sequence space, so this is never ambiguous.
+   */
+  static int distance( const uint8_t to, const uint8_t from )
+  {
+    return static_cast<int8_t>( static_cast<uint8_t>( to - from ) );
+  }
+
+  static void writeHeader( uint8_t *const frame, const uint8_t type, const RF24::LogicalAddress source )
+  {
+    frame[ 0 ] = TRANSPORT_MAGIC;
+    frame[ 1 ] = type;
+    frame[ 2 ] = static_cast<uint8_t>( source & 0xFF );
+    frame[ 3 ] = static_cast<uint8_t>( source >> 8 );
+  }
+
+  /*-------------------------------------------------------------------------------
+  Reliable Implementation
+  -------------------------------------------------------------------------------*/
+  Reliable::Reliable( RF24::Endpoint::Interface_sPtr device, const Config &cfg ) : mDevice( device ), mConfig( cfg ), mStats{}
+  {
+    mConfig.window       = std::min( std::max<size_t>( mConfig.window, 1 ), MAX_WINDOW );
+    mConfig.maxRtoMs     = std::max( mConfig.maxRtoMs, mConfig.minRtoMs );
+    mConfig.initialRtoMs = std::min( std::max( mConfig.initialRtoMs, mConfig.minRtoMs ), mConfig.maxRtoMs );
+  }
+
+  bool Reliable::write( const RF24::LogicalAddress destination, const void *data, const size_t length )
+  {
+    if ( !data || !length || ( length > MAX_MESSAGE_SIZE ) )
+    {
+      return false;
+    }
+
+    /*------------------------------------------------
+    The window is measured in sequence numbers rather
+    than messages outstanding. Selectively acked ones
+    leave gaps, and the receiver can only hold so many
+    messages past the one it's waiting on.
+    ------------------------------------------------*/
+    Peer &peer = getPeer( destination );
+    if ( !peer.window.empty() &&
+         ( static_cast<uint8_t>( peer.nextSequence - peer.window.front().sequence ) >= mConfig.window ) )
+    {
+      return false;
+    }
+
+    Outbound entry;
+    entry.sequence          = peer.nextSequence++;
+    entry.sent              = false;
+    entry.fastRetransmitted = false;
+    entry.retries           = 0;
+    entry.sentUs            = 0;
+    entry.length            = DATA_HEADER_SIZE + length;
+
+    writeHeader( entry.frame.data(), TYPE_DATA, mConfig.address );
+    entry.frame[ 4 ] = entry.sequence;
+    memcpy( &entry.frame[ DATA_HEADER_SIZE ], data, length );
+
+    peer.window.push_back( entry );
+    mStats.messagesSent++;
+
+    /*------------------------------------------------
+    Keep first transmissions in order. If an earlier
+    message is still waiting on the endpoint, this one
+    waits behind it.
+    ------------------------------------------------*/
+    if ( ( peer.window.size() == 1 ) || peer.window[ peer.window.size() - 2 ].sent )
+    {
+      transmit( destination, peer, peer.window.back() );
+    }
+
+    return true;
+  }
+
+  size_t Reliable::process()
+  {
+    size_t moved = 0;
+
+    while ( mDevice->packetAvailable() )
+    {
+      const size_t length = std::min( mDevice->nextPacketLength(), mFrame.size() );
+
+      if ( mDevice->read( mFrame.data(), length ) != Chimera::CommonStatusCodes::OK )
+      {
+        continue;
+      }
+
+      if ( ( length < DATA_HEADER_SIZE ) || ( mFrame[ 0 ] != TRANSPORT_MAGIC ) )
+      {
+        mStats.rejected++;
+        continue;
+      }
+
+      const RF24::LogicalAddress source = static_cast<RF24::LogicalAddress>( mFrame[ 2 ] | ( mFrame[ 3 ] << 8 ) );
+
+      if ( ( mFrame[ 1 ] == TYPE_DATA ) && ( length > DATA_HEADER_SIZE ) )
+      {
+        moved += onData( source, mFrame.data(), length );
+      }
+      else if ( ( mFrame[ 1 ] == TYPE_ACK ) && ( length >= ACK_SIZE ) )
+      {
+        moved += onAck( source, mFrame.data(), length );
+      }
+      else
+      {
+        mStats.rejected++;
+      }
+    }
+
+    /*------------------------------------------------
+    Send anything the endpoint couldn't take earlier,
+    then resend whatever has gone unacknowledged for
+    longer than the retransmit timeout.
+    ------------------------------------------------*/
+    const uint64_t now = Clock::micros();
+
+    for ( auto &item : mPeers )
+    {
+      Peer &peer     = item.second;
+      bool backedOff = false;
+
+      for ( auto entry = peer.window.begin(); entry != peer.window.end(); )
+      {
+        if ( !entry->sent )
+        {
+          if ( !transmit( item.first, peer, *entry ) )
+          {
+            break;
+          }
+
+          moved++;
+        }
+        else if ( ( now - entry->sentUs ) >= peer.rtoUs )
+        {
+          if ( mConfig.maxRetries && ( entry->retries >= mConfig.maxRetries ) )
+          {
+            mStats.abandoned++;
+            entry = peer.window.erase( entry );
+            continue;
+          }
+
+          if ( !transmit( item.first, peer, *entry ) )
+          {
+            break;
+          }
+
+          entry->retries++;
+          mStats.retransmits++;
+          moved++;
+
+          /*------------------------------------------------
+          Back off once per pass, not once per message, or a
+          full window timing out together would send the
+          timeout straight to its limit.
+          ------------------------------------------------*/
+          if ( !backedOff )
+          {
+            peer.rtoUs = std::min( peer.rtoUs * 2, static_cast<uint64_t>( mConfig.maxRtoMs ) * 1000 );
+            backedOff  = true;
+          }
+        }
+
+        ++entry;
+      }
+    }
+
+    return moved;
+  }
+
+  bool Reliable::available() const
+  {
+    return !mDelivered.empty();
+  }
+
+  size_t Reliable::nextLength() const
+  {
+    return mDelivered.empty() ? 0 : mDelivered.front().length;
+  }
+
+  bool Reliable::read( void *const data, const size_t length, RF24::LogicalAddress *const source )
+  {
+    if ( mDelivered.empty() || !data || ( length < mDelivered.front().length ) )
+    {
+      return false;
+    }
+
+    const Message &message = mDelivered.front();
+    memcpy( data, message.data.data(), message.length );
+
+    if ( source )
+    {
+      *source = message.source;
+    }
+
+    mDelivered.pop_front();
+    mStats.delivered++;
+    return true;
+  }
+
+  bool Reliable::pendingTx() const
+  {
+    for ( const auto &item : mPeers )
+    {
+      for ( const Outbound &entry : item.second.window )
+      {
+        if ( !entry.sent )
+        {
+          return true;
+        }
+      }
+    }
+
+    return false;
+  }
+
+  uint64_t Reliable::nextTimeoutUs() const
+  {
+    const uint64_t now = Clock::micros();
+    uint64_t earliest  = UINT64_MAX;
+
+    for ( const auto &item : mPeers )
+    {
+      for ( const Outbound &entry : item.second.window )
+      {
+        if ( entry.sent )
+        {
+          const uint64_t deadline = entry.sentUs + item.second.rtoUs;
+          earliest                = std::min( earliest, ( deadline > now ) ? ( deadline - now ) : 0 );
+        }
+      }
+    }
+
+    return earliest;
+  }
+
+  uint64_t Reliable::smoothedRttUs( const RF24::LogicalAddress peer ) const
+  {
+    const auto item = mPeers.find( peer );
+    return ( item == mPeers.end() ) ? 0 : item->second.srttUs;
+  }
+
+  Stats Reliable::getStats() const
+  {
+    return mStats;
+  }
+
+  Reliable::Peer &Reliable::getPeer( const RF24::LogicalAddress address )
+  {
+    auto result = mPeers.try_emplace( address );
+    Peer &peer  = result.first->second;
+
+    if ( result.second )
+    {
+      peer.nextSequence = 0;
+      peer.srttUs       = 0;
+      peer.rttVarUs     = 0;
+      peer.rtoUs        = static_cast<uint64_t>( mConfig.initialRtoMs ) * 1000;
+      peer.synced       = false;
+      peer.expected     = 0;
+
+      for ( Inbound &slot : peer.reorder )
+      {
+        slot.valid = false;
+      }
+    }
+
+    return peer;
+  }
+
+  bool Reliable::transmit( const RF24::LogicalAddress destination, Peer &peer, Outbound &entry )
+  {
+    /*------------------------------------------------
+    Tell the receiver the oldest message still being
+    tried, so it stops waiting on any given up on.
+    ------------------------------------------------*/
+    entry.frame[ 5 ] = peer.window.front().sequence;
+
+    if ( mDevice->write( destination, entry.frame.data(), entry.length ) != Chimera::CommonStatusCodes::OK )
+    {
+      return false;
+    }
+
+    entry.sent   = true;
+    entry.sentUs = Clock::micros();
+    return true;
+  }
+
+  size_t Reliable::onData( const RF24::LogicalAddress source, const uint8_t *const frame, const size_t length )
+  {
+    Peer &peer             = getPeer( source );
+    const uint8_t sequence = frame[ 4 ];
+    const uint8_t base     = frame[ 5 ];
+
+    if ( !peer.synced )
+    {
+      peer.synced   = true;
+      peer.expected = base;
+    }
+
+    /*------------------------------------------------
+    The sender abandoned everything before its base, so
+    deliver what did arrive and skip over the rest.
+    ------------------------------------------------*/
+    while ( distance( base, peer.expected ) > 0 )
+    {
+      Inbound &slot = peer.reorder[ peer.expected % MAX_WINDOW ];
+
+      if ( slot.valid )
+      {
+        mDelivered.push_back( Message{ source, slot.length, {} } );
+        memcpy( mDelivered.back().data.data(), slot.data.data(), slot.length );
+        slot.valid = false;
+      }
+
+      peer.expected++;
+    }
+
+    const int offset = distance( sequence, peer.expected );
+    Inbound &slot    = peer.reorder[ sequence % MAX_WINDOW ];
+
+    if ( ( offset < 0 ) || ( ( offset < static_cast<int>( MAX_WINDOW ) ) && slot.valid ) )
+    {
+      mStats.duplicates++;
+    }
+    else if ( offset < static_cast<int>( MAX_WINDOW ) )
+    {
+      slot.valid  = true;
+      slot.length = length - DATA_HEADER_SIZE;
+      memcpy( slot.data.data(), frame + DATA_HEADER_SIZE, slot.length );
+
+      deliver( source, peer );
+    }
+    else
+    {
+      mStats.rejected++;
+    }
+
+    /*------------------------------------------------
+    Always acknowledge, even duplicates. The first ack
+    may have been the thing that got lost.
+    ------------------------------------------------*/
+    return sendAck( source, peer ) ? 1 : 0;
+  }
+
+  size_t Reliable::onAck( const RF24::LogicalAddress source, const uint8_t *const frame, const size_t length )
+  {
+    ( void )length;
+
+    Peer &peer               = getPeer( source );
+    const uint8_t cumulative = frame[ 4 ];
+    const uint32_t sacks     = static_cast<uint32_t>( frame[ 5 ] ) | ( static_cast<uint32_t>( frame[ 6 ] ) << 8 ) |
+                           ( static_cast<uint32_t>( frame[ 7 ] ) << 16 ) | ( static_cast<uint32_t>( frame[ 8 ] ) << 24 );
+    const uint64_t now = Clock::micros();
+
+    /*------------------------------------------------
+    Retire everything before the cumulative ack as well
+    as everything the peer is holding past the gap. Only
+    messages sent exactly once give an unambiguous RTT.
+    ------------------------------------------------*/
+    size_t retired = 0;
+
+    for ( auto entry = peer.window.begin(); entry != peer.window.end(); )
+    {
+      const int offset = distance( entry->sequence, cumulative );
+      const bool acked = ( offset < 0 ) || ( ( offset > 0 ) && ( offset <= 32 ) && ( ( sacks >> ( offset - 1 ) ) & 1u ) );
+
+      if ( !acked || !entry->sent )
+      {
+        ++entry;
+        continue;
+      }
+
+      if ( !entry->retries )
+      {
+        sampleRtt( peer, now - entry->sentUs );
+      }
+
+      mStats.messagesAcked++;
+      retired++;
+      entry = peer.window.erase( entry );
+    }
+
+    /*------------------------------------------------
+    Any progress means the path is working again. Drop
+    the backoff instead of waiting for a clean sample,
+    which a lossy route may not produce for a long time.
+    ------------------------------------------------*/
+    if ( retired && peer.srttUs )
+    {
+      resetRto( peer );
+    }
+
+    /*------------------------------------------------
+    Several later messages made it but the one the peer
+    is waiting on didn't, so it's almost certainly lost.
+    Resend it now rather than wait out the timer.
+    ------------------------------------------------*/
+    size_t held = 0;
+    for ( uint32_t bits = sacks; bits; bits &= ( bits - 1 ) )
+    {
+      held++;
+    }
+
+    if ( !peer.window.empty() && ( held >= FAST_RETRANSMIT_SACKS ) )
+    {
+      Outbound &gap = peer.window.front();
+
+      if ( gap.sent && !gap.fastRetransmitted && ( gap.sequence == cumulative ) && transmit( source, peer, gap ) )
+      {
+        gap.fastRetransmitted = true;
+        gap.retries++;
+        mStats.fastRetransmits++;
+        return 1;
+      }
+    }
+
+    return 0;
+  }
+
+  bool Reliable::sendAck( const RF24::LogicalAddress destination, Peer &peer )
+  {
+    std::array<uint8_t, ACK_SIZE> ack;
+    uint32_t sacks = 0;
+
+    for ( uint8_t bit = 0; bit < 32; bit++ )
+    {
+      if ( peer.reorder[ static_cast<uint8_t>( peer.expected + 1 + bit ) % MAX_WINDOW ].valid )
+      {
+        sacks |= ( 1u << bit );
+      }
+    }
+
+    writeHeader( ack.data(), TYPE_ACK, mConfig.address );
+    ack[ 4 ] = peer.expected;
+    ack[ 5 ] = static_cast<uint8_t>( sacks );
+    ack[ 6 ] = static_cast<uint8_t>( sacks >> 8 );
+    ack[ 7 ] = static_cast<uint8_t>( sacks >> 16 );
+    ack[ 8 ] = static_cast<uint8_t>( sacks >> 24 );
+
+    if ( mDevice->write( destination, ack.data(), ack.size() ) != Chimera::CommonStatusCodes::OK )
+    {
+      return false;
+    }
+
+    mStats.acksSent++;
+    return true;
+  }
+
+  void Reliable::deliver( const RF24::LogicalAddress source, Peer &peer )
+  {
+    while ( true )
+    {
+      Inbound &slot = peer.reorder[ peer.expected % MAX_WINDOW ];
+      if ( !slot.valid )
+      {
+        break;
+      }
+
+      mDelivered.push_back( Message{ source, slot.length, {} } );
+      memcpy( mDelivered.back().data.data(), slot.data.data(), slot.length );
+
+      slot.valid = false;
+      peer.expected++;
+    }
+  }
+
+  void Reliable::sampleRtt( Peer &peer, const uint64_t sampleUs )
+  {
+    /*------------------------------------------------
+    Standard smoothed estimator: gains of 1/8 for the
+    mean and 1/4 for the variation.
+    ------------------------------------------------*/
+    if ( !peer.srttUs )
+    {
+      peer.srttUs   = std::max<uint64_t>( sampleUs, 1 );
+      peer.rttVarUs = sampleUs / 2;
+    }
+    else
+    {
+      const uint64_t error = ( peer.srttUs > sampleUs ) ? ( peer.srttUs - sampleUs ) : ( sampleUs - peer.srttUs );
+      peer.rttVarUs        = ( ( 3 * peer.rttVarUs ) + error ) / 4;
+      peer.srttUs          = std::max<uint64_t>( ( ( 7 * peer.srttUs ) + sampleUs ) / 8, 1 );
+    }
+
+    resetRto( peer );
+  }
+
+  void Reliable::resetRto( Peer &peer )
+  {
+    const uint64_t rto = peer.srttUs + std::max( RTO_GRANULARITY, 4 * peer.rttVarUs );
+    peer.rtoUs         = std::min( std::max( rto, static_cast<uint64_t>( mConfig.minRtoMs ) * 1000 ),
+                           static_cast<uint64_t>( mConfig.maxRtoMs ) * 1000 );
+  }
+
+}    // namespace Sim::Transport
@@ -0,0 +1,226 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_transport.hpp
+ *
+ *  Description:
+ *    Optional reliable end-to-end transport on top of Endpoint::write(). The
+ *    radio only acknowledges a frame across a single hop, so a message that
+ *    dies in a relay is never reported. This keeps a window of sequenced
+ *    messages in flight to each peer, which the peer confirms with a
+ *    cumulative plus selective acknowledgement. Anything unconfirmed is
+ *    resent on a timer that tracks the measured round trip time, and
+ *    duplicates are suppressed before delivery.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_TRANSPORT_HPP
+#define RF24_SIM_TRANSPORT_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+#include <RF24Node/endpoint>
+
+/* Dev Includes */
+#include <sim_endpoint.hpp>
+
+namespace Sim::Transport
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint8_t TRANSPORT_MAGIC  = 0xE1; /**< First byte of every transport frame */
+  static constexpr size_t DATA_HEADER_SIZE  = 6;    /**< Magic, type, source, sequence and send base */
+  static constexpr size_t ACK_SIZE          = 9;    /**< Magic, type, source, cumulative ack and SACK bitmap */
+  static constexpr size_t FRAME_SIZE        = Endpoint::MAX_PAYLOAD_SIZE; /**< Bytes of a frame left after the network header */
+  static constexpr size_t MAX_MESSAGE_SIZE  = FRAME_SIZE - DATA_HEADER_SIZE;
+  static constexpr size_t MAX_WINDOW        = 32;   /**< Limited by the width of the SACK bitmap */
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct Config
+  {
+    RF24::LogicalAddress address; /**< Address of the endpoint the transport is attached to */
+    size_t window;                /**< Messages allowed in flight to each peer, up to MAX_WINDOW */
+    size_t initialRtoMs;          /**< Retransmit timeout used until the first round trip is measured */
+    size_t minRtoMs;
+    size_t maxRtoMs;
+    size_t maxRetries;            /**< Retransmissions before a message is abandoned, 0 to never give up */
+  };
+
+  struct Stats
+  {
+    size_t messagesSent;      /**< Messages accepted by write() */
+    size_t messagesAcked;     /**< Messages confirmed by their destination */
+    size_t retransmits;       /**< Timer driven resends */
+    size_t fastRetransmits;   /**< Resends of a gap the peer reported through its SACK bitmap */
+    size_t abandoned;         /**< Messages given up on after maxRetries */
+    size_t delivered;         /**< Messages handed to the application, in order */
+    size_t duplicates;        /**< Copies of already received messages that were suppressed */
+    size_t acksSent;
+    size_t rejected;          /**< Frames that weren't valid transport frames */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Not thread safe. Every call must come from whichever thread is servicing
+   *  the endpoint, and the endpoint's RX data must only be read through here.
+   *  Messages from each peer are delivered in the order they were written.
+   */
+  class Reliable
+  {
+  public:
+    /**
+     *  @param[in]  device    Configured endpoint to send and receive through
+     *  @param[in]  cfg       Transport settings
+     */
+    Reliable( RF24::Endpoint::Interface_sPtr device, const Config &cfg );
+
+    Reliable( const Reliable & ) = delete;
+    Reliable &operator=( const Reliable & ) = delete;
+
+    /**
+     *  Sequences a message and sends it if the endpoint has room. Otherwise it
+     *  goes out from process() once the endpoint catches up.
+     *
+     *  @param[in]  destination   Node to deliver the message to
+     *  @param[in]  data          Message to send
+     *  @param[in]  length        Bytes in the message, up to MAX_MESSAGE_SIZE
+     *  @return bool              True if accepted, false if the window to the destination is full
+     */
+    bool write( const RF24::LogicalAddress destination, const void *data, const size_t length );
+
+    /**
+     *  Handles received data and acknowledgements, then sends anything new
+     *  or overdue. Call it after every Endpoint::doAsyncProcessing().
+     *
+     *  @return size_t        Frames handed to the endpoint
+     */
+    size_t process();
+
+    /**
+     *  @return bool          True if an in order message is waiting to be read
+     */
+    bool available() const;
+
+    /**
+     *  @return size_t        Length of the next message, zero if none is waiting
+     */
+    size_t nextLength() const;
+
+    /**
+     *  Copies out the next in order message
+     *
+     *  @param[out] data      Where to copy the message
+     *  @param[in]  length    Size of the buffer, must hold nextLength() bytes
+     *  @param[out] source    Sender of the message, may be nullptr
+     *  @return bool          True if a message was read
+     */
+    bool read( void *const data, const size_t length, RF24::LogicalAddress *const source );
+
+    /**
+     *  Checks if any messages are waiting for room on the endpoint
+     *
+     *  @return bool
+     */
+    bool pendingTx() const;
+
+    /**
+     *  Time until the earliest retransmit timer expires
+     *
+     *  @return uint64_t      Microseconds, UINT64_MAX if nothing is in flight
+     */
+    uint64_t nextTimeoutUs() const;
+
+    /**
+     *  Smoothed round trip time to a peer
+     *
+     *  @param[in]  peer      Node to query
+     *  @return uint64_t      Microseconds, zero until the first sample
+     */
+    uint64_t smoothedRttUs( const RF24::LogicalAddress peer ) const;
+
+    /**
+     *  @return Stats
+     */
+    Stats getStats() const;
+
+  private:
+    struct Outbound
+    {
+      uint8_t sequence;
+      bool sent;
+      bool fastRetransmitted;
+      size_t retries;
+      uint64_t sentUs;
+      size_t length;
+      std::array<uint8_t, FRAME_SIZE> frame;
+    };
+
+    struct Inbound
+    {
+      bool valid;
+      size_t length;
+      std::array<uint8_t, MAX_MESSAGE_SIZE> data;
+    };
+
+    struct Peer
+    {
+      /*------------------------------------------------
+      Sending side
+      ------------------------------------------------*/
+      uint8_t nextSequence;
+      std::deque<Outbound> window;          /**< Unacknowledged messages, oldest first */
+      uint64_t srttUs;
+      uint64_t rttVarUs;
+      uint64_t rtoUs;
+
+      /*------------------------------------------------
+      Receiving side
+      ------------------------------------------------*/
+      bool synced;                          /**< Expected sequence has been learned from the peer */
+      uint8_t expected;                     /**< Next sequence to deliver */
+      std::array<Inbound, MAX_WINDOW> reorder; /**< Out of order messages, indexed by sequence */
+    };
+
+    struct Message
+    {
+      RF24::LogicalAddress source;
+      size_t length;
+      std::array<uint8_t, MAX_MESSAGE_SIZE> data;
+    };
+
+    RF24::Endpoint::Interface_sPtr mDevice;
+    Config mConfig;
+    Stats mStats;
+    std::map<RF24::LogicalAddress, Peer> mPeers;
+    std::deque<Message> mDelivered;
+    std::array<uint8_t, FRAME_SIZE> mFrame;
+
+    Peer &getPeer( const RF24::LogicalAddress address );
+    bool transmit( const RF24::LogicalAddress destination, Peer &peer, Outbound &entry );
+    size_t onData( const RF24::LogicalAddress source, const uint8_t *const frame, const size_t length );
+    size_t onAck( const RF24::LogicalAddress source, const uint8_t *const frame, const size_t length );
+    bool sendAck( const RF24::LogicalAddress destination, Peer &peer );
+    void deliver( const RF24::LogicalAddress source, Peer &peer );
+    void sampleRtt( Peer &peer, const uint64_t sampleUs );
+    void resetRto( Peer &peer );
+  };
+
+  using Reliable_uPtr = std::unique_ptr<Reliable>;
+
+}    // namespace Sim::Transport
+
+#endif /* !RF24_SIM_TRANSPORT_HPP */
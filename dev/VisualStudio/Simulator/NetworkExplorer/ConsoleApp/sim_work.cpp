@@ -0,0 +1,26 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_work.cpp
+ *
+ *  Description:
+ *    Event driven node thread wakeups
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* Dev Includes */
+#include <sim_work.hpp>
+
+namespace Sim
+{
+  void WorkSignal::notify()
+  {
+    mSignal.notify();
+  }
+
+  bool WorkSignal::waitForWork( const size_t timeoutMs )
+  {
+    return mSignal.wait( static_cast<uint64_t>( timeoutMs ) * 1000 );
+  }
+
+}    // namespace Sim
@@ -0,0 +1,69 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_work.hpp
+ *
+ *  Description:
+ *    Event driven wakeups for node threads that own their endpoint. Instead of
+ *    sleeping a fixed interval between processing passes, a thread blocks in
+ *    waitForWork() until the application queues data to send or the
+ *    endpoint's own housekeeping comes due.
+ *
+ *    Frame arrivals can't wake the thread. RF24::Endpoint carries its frames
+ *    over loopback sockets inside the RF24Node stack and never touches the
+ *    Sim::Medium pipes, so received data is still only picked up when the
+ *    housekeeping timeout expires.
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef RF24_SIM_WORK_HPP
+#define RF24_SIM_WORK_HPP
+
+/* STL Includes */
+#include <cstddef>
+#include <memory>
+
+/* Dev Includes */
+#include <sim_clock.hpp>
+
+namespace Sim
+{
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  class WorkSignal
+  {
+  public:
+    WorkSignal()  = default;
+    ~WorkSignal() = default;
+
+    WorkSignal( const WorkSignal & ) = delete;
+    WorkSignal &operator=( const WorkSignal & ) = delete;
+
+    /**
+     *  Flags work that didn't come from the radio, such as a write() that
+     *  queued TX data. Safe to call from any thread.
+     *
+     *  @return void
+     */
+    void notify();
+
+    /**
+     *  Blocks until there is something to process or the timeout passes in
+     *  simulation time. Work flagged while nobody was waiting is not lost.
+     *
+     *  @param[in]  timeoutMs Longest time to wait, normally the endpoint's housekeeping period
+     *  @return bool          True if woken by work, false on timeout
+     */
+    bool waitForWork( const size_t timeoutMs );
+
+  private:
+    Clock::Signal mSignal;
+  };
+
+  using WorkSignal_sPtr = std::shared_ptr<WorkSignal>;
+
+}    // namespace Sim
+
+#endif /* !RF24_SIM_WORK_HPP */
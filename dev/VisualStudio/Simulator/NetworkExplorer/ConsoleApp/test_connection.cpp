@@ -13,27 +13,40 @@
 #include <uLog/ulog.hpp>
 #include <uLog/sinks/sink_cout.hpp>
 
+/* Dev Includes */
+#include <sim_clock.hpp>
+#include <sim_work.hpp>
+
 using NetResult = RF24::Connection::Result;
 using NetId     = RF24::Connection::BindSite;
 
-static constexpr size_t AsyncUpdateRate  = 50;
-static constexpr size_t ThreadUpdateRate = 15;
+static constexpr size_t AsyncUpdateRate = 50;
 
-static void MasterNodeThread();
-static void SlaveNode001Thread();
+static void MasterNodeThread( Sim::WorkSignal_sPtr work );
+static void SlaveNode001Thread( Sim::WorkSignal_sPtr work );
 
 void RunConnectionTests()
 {
-  auto masterThread = std::thread( MasterNodeThread );
-  auto slaveThread  = std::thread( SlaveNode001Thread );
+  std::thread masterThread;
+  std::thread slaveThread;
+
+  {
+    Sim::Clock::HoldScope hold;
+
+    auto masterWork = std::make_shared<Sim::WorkSignal>();
+    auto slaveWork  = std::make_shared<Sim::WorkSignal>();
+
+    masterThread = Sim::Clock::createThread( MasterNodeThread, masterWork );
+    slaveThread  = Sim::Clock::createThread( SlaveNode001Thread, slaveWork );
+  }
 
   while ( true )
   {
-    Chimera::delayMilliseconds( 100 );
+    Sim::Clock::delayMilliseconds( 100 );
   }
 }
 
-static void MasterNodeThread()
+static void MasterNodeThread( Sim::WorkSignal_sPtr work )
 {
   uLog::SinkHandle masterSink = std::make_shared<uLog::CoutSink>();
   masterSink->setLogLevel( uLog::Level::LVL_DEBUG );
@@ -64,31 +77,28 @@ static void MasterNodeThread()
   /*------------------------------------------------
   Main processing loop for the slave node
   ------------------------------------------------*/
-  const size_t start_time       = Chimera::millis();
-  size_t asyncUpdateProcessTime = start_time;
-  size_t testCodeProcessTime    = start_time;
+  size_t testCodeProcessTime = Sim::Clock::millis();
 
   while ( true )
   {
     /*------------------------------------------------
     Handle the incoming RF data
     ------------------------------------------------*/
-    if ( ( Chimera::millis() - asyncUpdateProcessTime ) > AsyncUpdateRate )
-    {
-      master->doAsyncProcessing();
-      asyncUpdateProcessTime = Chimera::millis();
-    }
+    master->doAsyncProcessing();
 
     /*------------------------------------------------
     Process any test code used for development
     ------------------------------------------------*/
-    if ( ( Chimera::millis() - testCodeProcessTime ) > 1000 )
+    if ( ( Sim::Clock::millis() - testCodeProcessTime ) > 1000 )
     {
       ;
     }
 
-
-    Chimera::delayMilliseconds( ThreadUpdateRate );
+    /*------------------------------------------------
+    Sleep until the housekeeping and test code come
+    due again
+    ------------------------------------------------*/
+    work->waitForWork( AsyncUpdateRate );
   }
 }
 
@@ -96,7 +106,7 @@ static void MasterNodeThread()
 /*------------------------------------------------
 Node 001
 ------------------------------------------------*/
-static void SlaveNode001Thread()
+static void SlaveNode001Thread( Sim::WorkSignal_sPtr work )
 {
   uLog::SinkHandle slaveSink = std::make_shared<uLog::CoutSink>();
   slaveSink->setLogLevel( uLog::Level::LVL_DEBUG );
@@ -128,7 +138,7 @@ static void SlaveNode001Thread()
  /*------------------------------------------------
   Connect to the configured parent node
   ------------------------------------------------*/
-  Chimera::delayMilliseconds( 100 );
+  Sim::Clock::delayMilliseconds( 100 );
 
   if ( slave->connectBlocking( 10000 ) != Chimera::CommonStatusCodes::OK )
   {
@@ -138,9 +148,7 @@ static void SlaveNode001Thread()
   /*------------------------------------------------
   Main processing loop for the slave node
   ------------------------------------------------*/
-  const size_t start_time       = Chimera::millis();
-  size_t asyncUpdateProcessTime = start_time;
-  size_t testCodeProcessTime    = start_time;
+  size_t testCodeProcessTime = Sim::Clock::millis();
 
   std::string_view hello_world = "hello world!";
 
@@ -149,16 +157,12 @@ static void SlaveNode001Thread()
     /*------------------------------------------------
     Handle the incoming RF data
     ------------------------------------------------*/
-    if ( ( Chimera::millis() - asyncUpdateProcessTime ) > AsyncUpdateRate )
-    {
-      slave->doAsyncProcessing();
-      asyncUpdateProcessTime = Chimera::millis();
-    }
+    slave->doAsyncProcessing();
 
     /*------------------------------------------------
     Process any test code used for development
     ------------------------------------------------*/
-    if ( ( Chimera::millis() - testCodeProcessTime ) > 5000 )
+    if ( ( Sim::Clock::millis() - testCodeProcessTime ) > 5000 )
     {
       if ( slave->isConnected( RF24::Connection::BindSite::PARENT ) )
       {
@@ -169,10 +173,13 @@ static void SlaveNode001Thread()
         slave->connectBlocking( 10000 );
       }
 
-      testCodeProcessTime = Chimera::millis();
+      testCodeProcessTime = Sim::Clock::millis();
     }
 
-
-    Chimera::delayMilliseconds( ThreadUpdateRate );
+    /*------------------------------------------------
+    Sleep until the housekeeping and test code come
+    due again
+    ------------------------------------------------*/
+    work->waitForWork( AsyncUpdateRate );
   }
 }
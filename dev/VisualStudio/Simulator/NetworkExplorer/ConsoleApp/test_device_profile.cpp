@@ -0,0 +1,179 @@
+/* STL Includes */
+#include <cstdio>
+#include <memory>
+
+/* Dev Includes */
+#include <sim_device.hpp>
+#include <sim_registers.hpp>
+
+using namespace Sim::Registers;
+
+static constexpr size_t NumCycles        = 100;
+static constexpr size_t PollIntervalUs   = 10;
+static constexpr uint8_t TestChannel     = 96;
+static constexpr uint8_t TxAddress[ 5 ]  = { 0xB3, 0xB4, 0xB5, 0xB6, 0x01 };
+
+/*------------------------------------------------
+Register access the way the driver does it, either
+straight over the bus or through the shadow
+------------------------------------------------*/
+class RegisterAccess
+{
+public:
+  RegisterAccess( Sim::Device::Emulator &device, const bool shadowed ) : mBus( device ), mShadow( nullptr )
+  {
+    if ( shadowed )
+    {
+      mShadow = std::make_unique<Shadow>( mBus );
+    }
+  }
+
+  uint8_t read( const uint8_t reg )
+  {
+    if ( mShadow )
+    {
+      return mShadow->read( reg );
+    }
+
+    uint8_t value = 0;
+    mBus.readRegister( reg, &value, 1 );
+    return value;
+  }
+
+  void write( const uint8_t reg, const uint8_t *const data, const size_t length )
+  {
+    if ( mShadow )
+    {
+      mShadow->write( reg, data, length );
+    }
+    else
+    {
+      mBus.writeRegister( reg, data, length );
+    }
+  }
+
+  void write( const uint8_t reg, const uint8_t value )
+  {
+    write( reg, &value, 1 );
+  }
+
+  void update( const uint8_t reg, const uint8_t mask, const uint8_t value )
+  {
+    write( reg, static_cast<uint8_t>( ( read( reg ) & ~mask ) | ( value & mask ) ) );
+  }
+
+private:
+  Sim::Device::RegisterBus mBus;
+  std::unique_ptr<Shadow> mShadow;
+};
+
+static void RunProfile( const bool shadowed );
+static void Command( Sim::Device::Emulator &device, const uint8_t cmd );
+
+/*------------------------------------------------
+Runs the register traffic of a node switching between
+listening and sending against the emulated radio and
+prints what each driver operation costs on the SPI bus.
+Once with every access going to the radio, once with
+the configuration registers shadowed.
+------------------------------------------------*/
+void RunDeviceProfile()
+{
+  RunProfile( false );
+  RunProfile( true );
+}
+
+static void RunProfile( const bool shadowed )
+{
+  Sim::Device::Emulator device( Sim::Device::defaultConfig() );
+  RegisterAccess regs( device, shadowed );
+
+  /*------------------------------------------------
+  Bring the radio up the same way every time
+  ------------------------------------------------*/
+  device.beginOperation( "initialize" );
+  regs.write( REG_CONFIG, CONFIG_EN_CRC | CONFIG_CRCO );
+  regs.write( REG_SETUP_RETR, 0x15 );
+  regs.write( REG_RF_SETUP, 0x06 );
+  regs.write( REG_RF_CH, TestChannel );
+  regs.write( REG_FEATURE, FEATURE_EN_DPL | FEATURE_EN_ACK_PAY );
+  regs.write( REG_DYNPD, 0x3F );
+  regs.write( REG_EN_RXADDR, 0x03 );
+  regs.write( REG_STATUS, STATUS_IRQ_FLAGS );
+  Command( device, CMD_FLUSH_RX );
+  Command( device, CMD_FLUSH_TX );
+  regs.update( REG_CONFIG, CONFIG_PWR_UP, CONFIG_PWR_UP );
+  device.advance( Sim::Device::POWER_UP_US );
+  device.endOperation();
+
+  for ( size_t cycle = 0; cycle < NumCycles; cycle++ )
+  {
+    /*------------------------------------------------
+    Leave RX and point pipe 0 at the destination so the
+    ACK comes back to it
+    ------------------------------------------------*/
+    device.beginOperation( "stopListening" );
+    device.setCE( false );
+    regs.update( REG_CONFIG, CONFIG_PRIM_RX, 0 );
+    regs.write( REG_TX_ADDR, TxAddress, sizeof( TxAddress ) );
+    regs.write( REG_RX_ADDR_P0, TxAddress, sizeof( TxAddress ) );
+    regs.update( REG_EN_RXADDR, 0x01, 0x01 );
+    device.endOperation();
+
+    /*------------------------------------------------
+    Send one full frame and poll for the result
+    ------------------------------------------------*/
+    device.beginOperation( "write" );
+    uint8_t payload[ 1 + Sim::Device::MAX_PAYLOAD_WIDTH ] = { CMD_W_TX_PAYLOAD };
+    payload[ 1 ] = static_cast<uint8_t>( cycle );
+    device.transfer( payload, payload, sizeof( payload ) );
+
+    device.setCE( true );
+    device.advance( PollIntervalUs );
+    device.setCE( false );
+
+    uint8_t status = 0;
+    do
+    {
+      device.advance( PollIntervalUs );
+      status = regs.read( REG_STATUS );
+    } while ( !( status & ( STATUS_TX_DS | STATUS_MAX_RT ) ) );
+
+    regs.write( REG_STATUS, STATUS_TX_DS | STATUS_MAX_RT );
+    device.endOperation();
+
+    /*------------------------------------------------
+    Back to listening on the node's own pipes
+    ------------------------------------------------*/
+    device.beginOperation( "startListening" );
+    regs.update( REG_CONFIG, CONFIG_PRIM_RX, CONFIG_PRIM_RX );
+    regs.write( REG_STATUS, STATUS_IRQ_FLAGS );
+    regs.update( REG_EN_RXADDR, 0x01, 0 );
+    regs.read( REG_FEATURE );
+    device.setCE( true );
+    device.advance( Sim::Device::SETTLE_US );
+    device.endOperation();
+  }
+
+  printf( "%s register access\n", shadowed ? "Shadowed" : "Direct" );
+  printf( "  operation        calls  transactions/call  bytes/call  bus_us/call\n" );
+
+  for ( const auto &entry : device.getProfile() )
+  {
+    const auto &stats  = entry.second;
+    const double calls = static_cast<double>( stats.calls );
+
+    printf( "  %-15s  %5zu  %17.1f  %10.1f  %11.2f\n", entry.first.c_str(), stats.calls, stats.bus.transactions / calls,
+            stats.bus.bytes / calls, ( stats.bus.busTimeNs / 1000.0 ) / calls );
+  }
+
+  const auto totals = device.getTotals();
+  printf( "  total: %zu transactions, %zu bytes, %.1f us of bus time, %.1f ms elapsed\n\n", totals.transactions, totals.bytes,
+          totals.busTimeNs / 1000.0, device.micros() / 1000.0 );
+}
+
+static void Command( Sim::Device::Emulator &device, const uint8_t cmd )
+{
+  uint8_t buffer = cmd;
+  device.transfer( &buffer, &buffer, 1 );
+}
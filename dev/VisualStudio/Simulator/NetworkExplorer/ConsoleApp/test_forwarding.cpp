@@ -0,0 +1,380 @@
+/* STL Includes */
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+#include <RF24Node/src/common/conversion.hpp>
+
+/* Dev Includes */
+#include <sim_channel.hpp>
+#include <sim_clock.hpp>
+#include <sim_medium.hpp>
+#include <sim_shockburst.hpp>
+
+static constexpr size_t NumFrames        = 1000;
+static constexpr size_t FrameBytes       = 16;
+static constexpr size_t LocalEvery       = 4;
+static constexpr size_t PollRateUs       = 100;
+static constexpr uint8_t TestChannel     = 96;
+static constexpr uint8_t TagLocal        = 0xA5;
+static constexpr uint8_t TagForward      = 0x5A;
+static constexpr RF24::LogicalAddress Receiver    = RF24::RootNode0;
+static constexpr RF24::LogicalAddress Relay       = 01;
+static constexpr RF24::LogicalAddress Sender      = 011;
+static constexpr RF24::LogicalAddress Unreachable = 05;
+
+struct Chain
+{
+  Sim::ShockBurst::Transceiver_sPtr sender;
+  Sim::ShockBurst::Transceiver_sPtr relay;
+  Sim::ShockBurst::Transceiver_sPtr receiver;
+  Sim::Medium::Address relayAddress;
+  Sim::Medium::Address receiverAddress;
+};
+
+struct CaseResult
+{
+  bool localWhileBusy;
+  bool heldWhileBusy;
+  bool forwardedOnce;
+  bool emptyAfter;
+};
+
+struct RelayResult
+{
+  size_t local;
+  size_t forwarded;
+  size_t busy;
+  size_t lost;
+};
+
+static Chain BuildChain();
+static Sim::ShockBurst::ForwardDecision RelayDecision( const Sim::Medium::Address nextHop );
+static bool SendAndWait( Sim::ShockBurst::Transceiver_sPtr radio, Sim::Clock::Signal &irq, const Sim::Medium::Address destination,
+                         const uint8_t tag, const uint16_t sequence );
+static void CaseThread( Chain *chain, CaseResult *result );
+static void SenderThread( Sim::ShockBurst::Transceiver_sPtr radio, const Sim::Medium::Address destination,
+                          std::atomic<bool> *done, size_t *dropped );
+static void RelayThread( Sim::ShockBurst::Transceiver_sPtr radio, const Sim::Medium::Address nextHop, std::atomic<bool> *senderDone,
+                         std::atomic<bool> *relayDone, RelayResult *result );
+static void DrainThread( const Sim::Medium::Address address, std::atomic<bool> *done, size_t *received, size_t *rewritten );
+
+/*------------------------------------------------
+Runs Transceiver::forward() on the middle node of a
+three node chain. First walks through the local, busy
+and forwarded cases one frame at a time, then streams
+mixed traffic through the relay and checks every frame
+ended up where it was addressed.
+------------------------------------------------*/
+void RunForwardingTests()
+{
+  Sim::Channel::reset();
+  Sim::Channel::Config channelCfg = Sim::Channel::defaultConfig();
+  channelCfg.enabled              = true;
+  channelCfg.contention           = Sim::Channel::Contention::SERIALIZE;
+  channelCfg.jitterUs             = 0;
+  Sim::Channel::configure( channelCfg );
+
+  /*------------------------------------------------
+  Single frames while the relay's transmitter is tied
+  up retrying a frame nobody will acknowledge
+  ------------------------------------------------*/
+  {
+    Chain chain       = BuildChain();
+    CaseResult result = { false, false, false, false };
+
+    std::vector<std::thread> threads;
+    {
+      Sim::Clock::HoldScope hold;
+      threads.push_back( Sim::Clock::createThread( CaseThread, &chain, &result ) );
+    }
+
+    for ( auto &thread : threads )
+    {
+      thread.join();
+    }
+
+    printf( "local frame while TX busy:    %s\n", result.localWhileBusy ? "PASS" : "FAIL" );
+    printf( "forward frame while TX busy:  %s\n", result.heldWhileBusy ? "PASS" : "FAIL" );
+    printf( "held frame forwarded once:    %s\n", result.forwardedOnce ? "PASS" : "FAIL" );
+    printf( "pipe empty afterwards:        %s\n", result.emptyAfter ? "PASS" : "FAIL" );
+  }
+
+  /*------------------------------------------------
+  Mixed traffic, with the relay sending one frame at a
+  time so it regularly has to hold one back
+  ------------------------------------------------*/
+  {
+    Chain chain = BuildChain();
+
+    std::atomic<bool> senderDone( false );
+    std::atomic<bool> relayDone( false );
+    size_t dropped   = 0;
+    size_t received  = 0;
+    size_t rewritten = 0;
+    RelayResult relay{ 0, 0, 0, 0 };
+    std::vector<std::thread> threads;
+
+    {
+      Sim::Clock::HoldScope hold;
+      threads.push_back( Sim::Clock::createThread( SenderThread, chain.sender, chain.relayAddress, &senderDone, &dropped ) );
+      threads.push_back( Sim::Clock::createThread( RelayThread, chain.relay, chain.receiverAddress, &senderDone, &relayDone, &relay ) );
+      threads.push_back( Sim::Clock::createThread( DrainThread, chain.receiverAddress, &relayDone, &received, &rewritten ) );
+    }
+
+    for ( auto &thread : threads )
+    {
+      thread.join();
+    }
+
+    const size_t expectLocal = NumFrames / LocalEvery;
+    const bool pass = !dropped && !relay.lost && ( relay.local == expectLocal ) && ( relay.forwarded == ( NumFrames - expectLocal ) ) &&
+                      ( received == relay.forwarded ) && ( rewritten == received ) && relay.busy;
+
+    printf( "frames  local  forwarded  busy  received  rewritten  dropped  result\n" );
+    printf( "%6zu  %5zu  %9zu  %4zu  %8zu  %9zu  %7zu  %s\n", NumFrames, relay.local, relay.forwarded, relay.busy, received,
+            rewritten, dropped + relay.lost, pass ? "PASS" : "FAIL" );
+  }
+}
+
+static Chain BuildChain()
+{
+  Sim::ShockBurst::Config radioCfg;
+  radioCfg.channel    = TestChannel;
+  radioCfg.dataRate   = RF24::Hardware::DataRate::DR_1MBPS;
+  radioCfg.retryDelay = 15;
+  radioCfg.retryCount = 15;
+  radioCfg.autoAck    = true;
+  radioCfg.streamTx   = false;
+  radioCfg.spiClockHz = 0;
+
+  Chain chain;
+  chain.relayAddress    = RF24::Physical::Conversion::getPhysicalAddress( Relay, RF24::Hardware::PIPE_NUM_1 );
+  chain.receiverAddress = RF24::Physical::Conversion::getPhysicalAddress( Receiver, RF24::Hardware::PIPE_NUM_1 );
+
+  chain.receiver = Sim::ShockBurst::Transceiver::createShared( radioCfg );
+  chain.receiver->openReadingPipe( RF24::Hardware::PIPE_NUM_1, chain.receiverAddress );
+
+  chain.relay = Sim::ShockBurst::Transceiver::createShared( radioCfg );
+  chain.relay->openReadingPipe( RF24::Hardware::PIPE_NUM_0,
+                                RF24::Physical::Conversion::getPhysicalAddress( Relay, RF24::Hardware::PIPE_NUM_0 ) );
+  chain.relay->openReadingPipe( RF24::Hardware::PIPE_NUM_1, chain.relayAddress );
+
+  chain.sender = Sim::ShockBurst::Transceiver::createShared( radioCfg );
+  chain.sender->openReadingPipe( RF24::Hardware::PIPE_NUM_0,
+                                 RF24::Physical::Conversion::getPhysicalAddress( Sender, RF24::Hardware::PIPE_NUM_0 ) );
+
+  return chain;
+}
+
+static Sim::ShockBurst::ForwardDecision RelayDecision( const Sim::Medium::Address nextHop )
+{
+  /*------------------------------------------------
+  Byte 1 counts the hops a frame has taken, so the far
+  end can tell the relay rewrote it exactly once
+  ------------------------------------------------*/
+  return [ nextHop ]( Sim::Medium::Frame &frame, Sim::Medium::Address &destination ) {
+    if ( frame.payload[ 0 ] != TagForward )
+    {
+      return false;
+    }
+
+    frame.payload[ 1 ]++;
+    destination = nextHop;
+    return true;
+  };
+}
+
+static bool SendAndWait( Sim::ShockBurst::Transceiver_sPtr radio, Sim::Clock::Signal &irq, const Sim::Medium::Address destination,
+                         const uint8_t tag, const uint16_t sequence )
+{
+  uint8_t payload[ FrameBytes ] = { tag, 0, static_cast<uint8_t>( sequence >> 8 ), static_cast<uint8_t>( sequence ) };
+
+  if ( !radio->transmit( destination, payload, sizeof( payload ) ) )
+  {
+    return false;
+  }
+
+  while ( radio->getStatus().txBusy )
+  {
+    irq.wait( Sim::Clock::WAIT_FOREVER );
+  }
+
+  const bool sent = radio->getStatus().txDataSent;
+  radio->clearStatus();
+  return sent;
+}
+
+static void CaseThread( Chain *chain, CaseResult *result )
+{
+  auto senderIrq = std::make_shared<Sim::Clock::Signal>();
+  auto relayIrq  = std::make_shared<Sim::Clock::Signal>();
+  chain->sender->setIrqHook( [ senderIrq ]() { senderIrq->notify(); } );
+  chain->relay->setIrqHook( [ relayIrq ]() { relayIrq->notify(); } );
+
+  const auto decide = RelayDecision( chain->receiverAddress );
+  Sim::Medium::Frame local;
+
+  /*------------------------------------------------
+  Keep the relay busy for its full retry budget
+  ------------------------------------------------*/
+  const uint8_t filler[ FrameBytes ] = { 0 };
+  chain->relay->transmit( RF24::Physical::Conversion::getPhysicalAddress( Unreachable, RF24::Hardware::PIPE_NUM_1 ), filler,
+                          sizeof( filler ) );
+
+  /*------------------------------------------------
+  A frame for the relay itself must come out even
+  though its TX FIFO is full
+  ------------------------------------------------*/
+  SendAndWait( chain->sender, *senderIrq, chain->relayAddress, TagLocal, 1 );
+  result->localWhileBusy = ( chain->relay->forward( RF24::Hardware::PIPE_NUM_1, decide, local ) ==
+                             Sim::ShockBurst::ForwardResult::LOCAL ) &&
+                           ( local.payload[ 0 ] == TagLocal ) && chain->relay->getStatus().txFull;
+
+  /*------------------------------------------------
+  A frame to pass on has to wait, and asking again
+  must not decide on it a second time
+  ------------------------------------------------*/
+  SendAndWait( chain->sender, *senderIrq, chain->relayAddress, TagForward, 2 );
+  result->heldWhileBusy =
+      ( chain->relay->forward( RF24::Hardware::PIPE_NUM_1, decide, local ) == Sim::ShockBurst::ForwardResult::BUSY ) &&
+      ( chain->relay->forward( RF24::Hardware::PIPE_NUM_1, decide, local ) == Sim::ShockBurst::ForwardResult::BUSY );
+
+  while ( !chain->relay->getStatus().maxRetries )
+  {
+    relayIrq->wait( Sim::Clock::WAIT_FOREVER );
+  }
+
+  chain->relay->clearStatus();
+
+  /*------------------------------------------------
+  Once the filler is given up on, the held frame goes
+  out and reaches the receiver rewritten exactly once
+  ------------------------------------------------*/
+  const bool forwarded =
+      ( chain->relay->forward( RF24::Hardware::PIPE_NUM_1, decide, local ) == Sim::ShockBurst::ForwardResult::FORWARDED );
+
+  while ( chain->relay->getStatus().txBusy )
+  {
+    relayIrq->wait( Sim::Clock::WAIT_FOREVER );
+  }
+
+  Sim::Medium::Frame arrived;
+  Sim::Medium::Pipe pipe = Sim::Medium::openPipe( chain->receiverAddress );
+
+  result->forwardedOnce = forwarded && chain->relay->getStatus().txDataSent && pipe->pop( arrived ) &&
+                          ( arrived.payload[ 0 ] == TagForward ) && ( arrived.payload[ 1 ] == 1 ) && ( arrived.payload[ 3 ] == 2 ) &&
+                          pipe->empty();
+  result->emptyAfter =
+      ( chain->relay->forward( RF24::Hardware::PIPE_NUM_1, decide, local ) == Sim::ShockBurst::ForwardResult::EMPTY );
+
+  chain->relay->clearStatus();
+  chain->sender->setIrqHook( nullptr );
+  chain->relay->setIrqHook( nullptr );
+}
+
+static void SenderThread( Sim::ShockBurst::Transceiver_sPtr radio, const Sim::Medium::Address destination,
+                          std::atomic<bool> *done, size_t *dropped )
+{
+  auto irq = std::make_shared<Sim::Clock::Signal>();
+  radio->setIrqHook( [ irq ]() { irq->notify(); } );
+
+  for ( size_t x = 0; x < NumFrames; x++ )
+  {
+    const uint8_t tag = ( ( x % LocalEvery ) == 0 ) ? TagLocal : TagForward;
+
+    if ( !SendAndWait( radio, *irq, destination, tag, static_cast<uint16_t>( x ) ) )
+    {
+      ( *dropped )++;
+    }
+  }
+
+  radio->setIrqHook( nullptr );
+  done->store( true );
+}
+
+static void RelayThread( Sim::ShockBurst::Transceiver_sPtr radio, const Sim::Medium::Address nextHop, std::atomic<bool> *senderDone,
+                         std::atomic<bool> *relayDone, RelayResult *result )
+{
+  auto irq = std::make_shared<Sim::Clock::Signal>();
+  radio->setIrqHook( [ irq ]() { irq->notify(); } );
+
+  const auto decide = RelayDecision( nextHop );
+  Sim::Medium::Frame local;
+
+  while ( true )
+  {
+    const bool finished = senderDone->load();
+    const auto outcome  = radio->forward( RF24::Hardware::PIPE_NUM_1, decide, local );
+    const auto status   = radio->getStatus();
+
+    if ( status.maxRetries )
+    {
+      radio->clearStatus();
+      result->lost++;
+    }
+    else if ( status.txDataSent )
+    {
+      radio->clearStatus();
+    }
+
+    switch ( outcome )
+    {
+      case Sim::ShockBurst::ForwardResult::LOCAL:
+        result->local++;
+        break;
+
+      case Sim::ShockBurst::ForwardResult::FORWARDED:
+        result->forwarded++;
+        break;
+
+      case Sim::ShockBurst::ForwardResult::BUSY:
+        result->busy++;
+        irq->wait( PollRateUs );
+        break;
+
+      default:
+        if ( finished && !status.txBusy )
+        {
+          radio->setIrqHook( nullptr );
+          relayDone->store( true );
+          return;
+        }
+
+        Sim::Clock::delayMicroseconds( PollRateUs );
+        break;
+    }
+  }
+}
+
+static void DrainThread( const Sim::Medium::Address address, std::atomic<bool> *done, size_t *received, size_t *rewritten )
+{
+  Sim::Medium::Pipe pipe = Sim::Medium::openPipe( address );
+  Sim::Medium::Frame frame;
+
+  while ( true )
+  {
+    const bool finished = done->load();
+
+    while ( pipe->pop( frame ) )
+    {
+      ( *received )++;
+
+      if ( ( frame.payload[ 0 ] == TagForward ) && ( frame.payload[ 1 ] == 1 ) )
+      {
+        ( *rewritten )++;
+      }
+    }
+
+    if ( finished )
+    {
+      break;
+    }
+
+    Sim::Clock::delayMicroseconds( PollRateUs );
+  }
+}
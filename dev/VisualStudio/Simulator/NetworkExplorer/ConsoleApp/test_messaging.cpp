@@ -1,3 +1,7 @@
+/* STL Includes */
+#include <cstdint>
+#include <vector>
+
 /* Chimera Includes */
 #include <Chimera/common>
 
@@ -13,15 +17,18 @@
 #include <uLog/ulog.hpp>
 #include <uLog/sinks/sink_cout.hpp>
 
-/* Windows Includes */
-#include <windows.h>
-#include <processthreadsapi.h>
+/* Dev Includes */
+#include <sim_clock.hpp>
+#include <sim_platform.hpp>
+#include <sim_random.hpp>
+#include <sim_work.hpp>
 
-static constexpr size_t BootDelay        = 500;
-static constexpr size_t ConnectTimeout   = 10000;
-static constexpr size_t AsyncUpdateRate  = 50;
-static constexpr size_t ThreadUpdateRate = 15;
-static constexpr size_t SayHelloRate     = 5000;
+static constexpr size_t BootDelay       = 500;
+static constexpr size_t BootStagger     = 25;
+static constexpr size_t ConnectTimeout  = 10000;
+static constexpr size_t AsyncUpdateRate = 50;
+static constexpr size_t SayHelloRate    = 5000;
+static constexpr size_t MaxReadsPerPass = 5;    /**< Packets handled before a thread waits again, the RX queue holds 5 */
 
 struct MessageType
 {
@@ -32,9 +39,11 @@ struct MessageType
 struct EndpointInitializer
 {
   RF24::Endpoint::Interface_sPtr device;
+  Sim::WorkSignal_sPtr work;
   bool initialized;
 
   void ( *idleThreadFunction )( EndpointInitializer * );
+  size_t bootDelay;
 
   std::string deviceName;
   RF24::LogicalAddress deviceAddress;
@@ -44,6 +53,7 @@ struct EndpointInitializer
 static std::vector<EndpointInitializer> SystemNodes;
 static std::vector<std::thread> SystemThreads;
 
+static bool ReadMessage( RF24::Endpoint::Interface_sPtr &device, MessageType &msg );
 static void RootNodeThread( EndpointInitializer *init );
 static void ChildNodeThread_001( EndpointInitializer *init );
 static void ChildNodeThread_002( EndpointInitializer *init );
@@ -169,12 +179,28 @@ void RunMessagingTests()
   SystemNodes.push_back( childNode_02113 );
   SystemNodes.push_back( childNode_042113 );
 
+  /*------------------------------------------------
+  Bring the nodes up one after another in an order
+  picked by the simulation seed, rather than all at
+  once in whatever order the threads happen to run.
+  ------------------------------------------------*/
+  const auto bootOrder = Sim::Random::permutation( SystemNodes.size(), Sim::Random::STREAM_BOOT_ORDER );
+  for ( size_t x = 0; x < bootOrder.size(); x++ )
+  {
+    SystemNodes[ bootOrder[ x ] ].bootDelay = BootDelay + ( x * BootStagger );
+  }
+
   /*------------------------------------------------
   Start all the threads
   ------------------------------------------------*/
-  for ( auto& item : SystemNodes )
   {
-    SystemThreads.push_back( std::thread( item.idleThreadFunction, &item ) );
+    Sim::Clock::HoldScope hold;
+
+    for ( auto& item : SystemNodes )
+    {
+      item.work = std::make_shared<Sim::WorkSignal>();
+      SystemThreads.push_back( Sim::Clock::createThread( item.idleThreadFunction, &item ) );
+    }
   }
  
   /*------------------------------------------------
@@ -182,13 +208,32 @@ void RunMessagingTests()
   ------------------------------------------------*/
   while ( true )
   {
-    Chimera::delayMilliseconds( 100 );
+    Sim::Clock::delayMilliseconds( 100 );
+  }
+}
+
+/*------------------------------------------------
+Takes the next packet off the endpoint. Anything that
+isn't a MessageType is read out and thrown away so it
+can't sit at the head of the queue forever.
+------------------------------------------------*/
+static bool ReadMessage( RF24::Endpoint::Interface_sPtr &device, MessageType &msg )
+{
+  const size_t packetSize = device->nextPacketLength();
+
+  if ( packetSize == sizeof( MessageType ) )
+  {
+    return device->read( &msg, sizeof( MessageType ) ) == Chimera::CommonStatusCodes::OK;
   }
+
+  std::vector<uint8_t> discard( packetSize );
+  device->read( discard.data(), discard.size() );
+  return false;
 }
 
 static void RootNodeThread( EndpointInitializer *init )
 {
-  SetThreadDescription( GetCurrentThread(), L"RootNodeThread" );
+  Sim::Platform::setThreadName( "RootNodeThread" );
 
   /*------------------------------------------------
   Initialize the device logger
@@ -231,31 +276,26 @@ static void RootNodeThread( EndpointInitializer *init )
   /*------------------------------------------------
   Device Processing Thread
   ------------------------------------------------*/
-  Chimera::delayMilliseconds( BootDelay );
-  size_t current_time = Chimera::millis();
-  size_t hello_time = Chimera::millis();
+  Sim::Clock::delayMilliseconds( init->bootDelay );
+  size_t hello_time = Sim::Clock::millis();
 
   size_t test_rate = 5000;
 
   while ( true )
   {
-    if ( ( Chimera::millis() - current_time ) > AsyncUpdateRate )
-    {
-      init->device->doAsyncProcessing();
-      current_time = Chimera::millis();
-    }
+    init->device->doAsyncProcessing();
 
     /*------------------------------------------------
     Make several transmissions down to some nodes lower
     in the tree. This tests whether or not data can cross
     none, single, and multi-node jumps.
     ------------------------------------------------*/
-    if ( ( Chimera::millis() - hello_time ) > test_rate )
+    if ( ( Sim::Clock::millis() - hello_time ) > test_rate )
     {
       msg.crc = 0;
       msg.node = 0;
 
-      logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Sending CRC: %d, Node: %d\n", Chimera::millis(), msg.crc, msg.node );
+      logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Sending CRC: %d, Node: %d\n", Sim::Clock::millis(), msg.crc, msg.node );
 
       //init->device->write( 001, &msg, sizeof( MessageType ) );
       //init->device->write( 002, &msg, sizeof( MessageType ) );
@@ -265,9 +305,10 @@ static void RootNodeThread( EndpointInitializer *init )
       //init->device->write( 0113, &msg, sizeof( MessageType ) );
       //init->device->write( 02113, &msg, sizeof( MessageType ) );
       init->device->write( 042113, &msg, sizeof( MessageType ) );
+      init->work->notify();
 
       test_rate = 100000;
-      hello_time = Chimera::millis();
+      hello_time = Sim::Clock::millis();
     }
 
     /*------------------------------------------------
@@ -275,19 +316,22 @@ static void RootNodeThread( EndpointInitializer *init )
     send back modified CRC data, which allows exercising
     the data path flowing back up the tree
     ------------------------------------------------*/
-    if ( init->device->packetAvailable() )
+    for ( size_t x = 0; ( x < MaxReadsPerPass ) && init->device->packetAvailable(); x++ )
     {
-      size_t packetSize = init->device->nextPacketLength();
-
-      if ( packetSize == sizeof( MessageType ) )
+      if ( !ReadMessage( init->device, rxData ) )
       {
-        init->device->read( &rxData, sizeof( MessageType ) );
-        logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Chimera::millis(),
-                       init->deviceAddress, rxData.crc, rxData.node );
+        continue;
       }
+
+      logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Sim::Clock::millis(),
+                     init->deviceAddress, rxData.crc, rxData.node );
     }
 
-    Chimera::delayMilliseconds( ThreadUpdateRate );
+    /*------------------------------------------------
+    Sleep until data gets queued or the endpoint's
+    housekeeping is due
+    ------------------------------------------------*/
+    init->work->waitForWork( AsyncUpdateRate );
   }
 }
 
@@ -305,7 +349,7 @@ static void ChildNode_001_ConnectCallback( NetResult result, NetId id )
 
 static void ChildNodeThread_001( EndpointInitializer *init )
 {
-  SetThreadDescription( GetCurrentThread(), L"ChildNode-001" );
+  Sim::Platform::setThreadName( "ChildNode-001" );
 
   /*------------------------------------------------
   Initialize the device logger
@@ -349,13 +393,13 @@ static void ChildNodeThread_001( EndpointInitializer *init )
   ------------------------------------------------*/
   isConnected = NetResult::CONNECT_PROC_UNKNOWN;
 
-  Chimera::delayMilliseconds( BootDelay );
+  Sim::Clock::delayMilliseconds( init->bootDelay );
 
   init->device->connectAsync( ChildNode_001_ConnectCallback, ConnectTimeout );
   while ( isConnected == NetResult::CONNECT_PROC_UNKNOWN )
   {
     init->device->processNetworking();
-    Chimera::delayMilliseconds( 10 );
+    init->work->waitForWork( 10 );
   }
 
   if ( isConnected == NetResult::CONNECT_PROC_SUCCESS )
@@ -372,33 +416,31 @@ static void ChildNodeThread_001( EndpointInitializer *init )
   /*------------------------------------------------
   Device Processing Thread
   ------------------------------------------------*/
-  size_t current_time = Chimera::millis();
-
   while ( true )
   {
-    if ( ( Chimera::millis() - current_time ) > AsyncUpdateRate )
-    {
-      init->device->doAsyncProcessing();
-      current_time = Chimera::millis();
-    }
+    init->device->doAsyncProcessing();
 
-    if ( init->device->packetAvailable() )
+    for ( size_t x = 0; ( x < MaxReadsPerPass ) && init->device->packetAvailable(); x++ )
     {
-      size_t packetSize = init->device->nextPacketLength();
-
-      if ( packetSize == sizeof( MessageType ) )
+      if ( !ReadMessage( init->device, rxData ) )
       {
-        init->device->read( &rxData, sizeof( MessageType ) );
-        logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Chimera::millis(),
-                       init->deviceAddress, rxData.crc, rxData.node );
+        continue;
       }
 
+      logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Sim::Clock::millis(),
+                     init->deviceAddress, rxData.crc, rxData.node );
+
       rxData.crc    = 0xDEADBEEF;
       rxData.node = 1;
       init->device->write( 000, &rxData, sizeof( MessageType ) );
+      init->work->notify();
     }
 
-    Chimera::delayMilliseconds( ThreadUpdateRate );
+    /*------------------------------------------------
+    Sleep until data gets queued or the endpoint's
+    housekeeping is due
+    ------------------------------------------------*/
+    init->work->waitForWork( AsyncUpdateRate );
   }
 }
 
@@ -413,7 +455,7 @@ static void ChildNode_002_ConnectCallback( NetResult result, NetId id )
 
 static void ChildNodeThread_002( EndpointInitializer *init )
 {
-  SetThreadDescription( GetCurrentThread(), L"ChildNode-002" );
+  Sim::Platform::setThreadName( "ChildNode-002" );
 
   /*------------------------------------------------
   Initialize the device logger
@@ -457,13 +499,13 @@ static void ChildNodeThread_002( EndpointInitializer *init )
   ------------------------------------------------*/
   isConnected_002 = NetResult::CONNECT_PROC_UNKNOWN;
 
-  Chimera::delayMilliseconds( BootDelay );
+  Sim::Clock::delayMilliseconds( init->bootDelay );
 
   init->device->connectAsync( ChildNode_002_ConnectCallback, ConnectTimeout );
   while ( isConnected_002 == NetResult::CONNECT_PROC_UNKNOWN )
   {
     init->device->processNetworking();
-    Chimera::delayMilliseconds( 10 );
+    init->work->waitForWork( 10 );
   }
 
   if ( isConnected_002 == NetResult::CONNECT_PROC_SUCCESS )
@@ -480,33 +522,31 @@ static void ChildNodeThread_002( EndpointInitializer *init )
   /*------------------------------------------------
   Device Processing Thread
   ------------------------------------------------*/
-  size_t current_time = Chimera::millis();
-
   while ( true )
   {
-    if ( ( Chimera::millis() - current_time ) > AsyncUpdateRate )
-    {
-      init->device->doAsyncProcessing();
-      current_time = Chimera::millis();
-    }
+    init->device->doAsyncProcessing();
 
-    if ( init->device->packetAvailable() )
+    for ( size_t x = 0; ( x < MaxReadsPerPass ) && init->device->packetAvailable(); x++ )
     {
-      size_t packetSize = init->device->nextPacketLength();
-
-      if ( packetSize == sizeof( MessageType ) )
+      if ( !ReadMessage( init->device, rxData ) )
       {
-        init->device->read( &rxData, sizeof( MessageType ) );
-        logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Chimera::millis(),
-                       init->deviceAddress, rxData.crc, rxData.node );
+        continue;
       }
 
+      logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Sim::Clock::millis(),
+                     init->deviceAddress, rxData.crc, rxData.node );
+
       rxData.crc    = 0xBEE5BEE5;
       rxData.node = 2;
       init->device->write( 000, &rxData, sizeof( MessageType ) );
+      init->work->notify();
     }
 
-    Chimera::delayMilliseconds( ThreadUpdateRate );
+    /*------------------------------------------------
+    Sleep until data gets queued or the endpoint's
+    housekeeping is due
+    ------------------------------------------------*/
+    init->work->waitForWork( AsyncUpdateRate );
   }
 }
 
@@ -521,7 +561,7 @@ static void ChildNode_003_ConnectCallback( NetResult result, NetId id )
 
 static void ChildNodeThread_003( EndpointInitializer *init )
 {
-  SetThreadDescription( GetCurrentThread(), L"ChildNode-003" );
+  Sim::Platform::setThreadName( "ChildNode-003" );
 
   /*------------------------------------------------
   Initialize the device logger
@@ -565,13 +605,13 @@ static void ChildNodeThread_003( EndpointInitializer *init )
   ------------------------------------------------*/
   isConnected_003 = NetResult::CONNECT_PROC_UNKNOWN;
 
-  Chimera::delayMilliseconds( BootDelay );
+  Sim::Clock::delayMilliseconds( init->bootDelay );
 
   init->device->connectAsync( ChildNode_003_ConnectCallback, ConnectTimeout );
   while ( isConnected_003 == NetResult::CONNECT_PROC_UNKNOWN )
   {
     init->device->processNetworking();
-    Chimera::delayMilliseconds( 10 );
+    init->work->waitForWork( 10 );
   }
 
   if ( isConnected_003 == NetResult::CONNECT_PROC_SUCCESS )
@@ -588,34 +628,32 @@ static void ChildNodeThread_003( EndpointInitializer *init )
   /*------------------------------------------------
   Device Processing Thread
   ------------------------------------------------*/
-  size_t current_time = Chimera::millis();
-
   while ( true )
   {
-    if ( ( Chimera::millis() - current_time ) > AsyncUpdateRate )
-    {
-      init->device->doAsyncProcessing();
-      current_time = Chimera::millis();
-    }
+    init->device->doAsyncProcessing();
 
 
-    if ( init->device->packetAvailable() )
+    for ( size_t x = 0; ( x < MaxReadsPerPass ) && init->device->packetAvailable(); x++ )
     {
-      size_t packetSize = init->device->nextPacketLength();
-
-      if ( packetSize == sizeof( MessageType ) )
+      if ( !ReadMessage( init->device, rxData ) )
       {
-        init->device->read( &rxData, sizeof( MessageType ) );
-        logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Chimera::millis(),
-                       init->deviceAddress, rxData.crc, rxData.node );
+        continue;
       }
 
+      logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Sim::Clock::millis(),
+                     init->deviceAddress, rxData.crc, rxData.node );
+
       rxData.crc    = 0xAAAAAAAA;
       rxData.node = 3;
       init->device->write( 000, &rxData, sizeof( MessageType ) );
+      init->work->notify();
     }
 
-    Chimera::delayMilliseconds( ThreadUpdateRate );
+    /*------------------------------------------------
+    Sleep until data gets queued or the endpoint's
+    housekeeping is due
+    ------------------------------------------------*/
+    init->work->waitForWork( AsyncUpdateRate );
   }
 }
 
@@ -630,7 +668,7 @@ static void ChildNode_012_ConnectCallback( NetResult result, NetId id )
 
 static void ChildNodeThread_012( EndpointInitializer *init )
 {
-  SetThreadDescription( GetCurrentThread(), L"ChildNode-012" );
+  Sim::Platform::setThreadName( "ChildNode-012" );
 
   /*------------------------------------------------
   Initialize the device logger
@@ -674,13 +712,13 @@ static void ChildNodeThread_012( EndpointInitializer *init )
   ------------------------------------------------*/
   isConnected_012 = NetResult::CONNECT_PROC_UNKNOWN;
 
-  Chimera::delayMilliseconds( BootDelay );
+  Sim::Clock::delayMilliseconds( init->bootDelay );
 
   init->device->connectAsync( ChildNode_012_ConnectCallback, ConnectTimeout );
   while ( isConnected_012 == NetResult::CONNECT_PROC_UNKNOWN )
   {
     init->device->processNetworking();
-    Chimera::delayMilliseconds( 10 );
+    init->work->waitForWork( 10 );
   }
 
   if ( isConnected_012 == NetResult::CONNECT_PROC_SUCCESS )
@@ -697,33 +735,31 @@ static void ChildNodeThread_012( EndpointInitializer *init )
   /*------------------------------------------------
   Device Processing Thread
   ------------------------------------------------*/
-  size_t current_time = Chimera::millis();
-
   while ( true )
   {
-    if ( ( Chimera::millis() - current_time ) > AsyncUpdateRate )
-    {
-      init->device->doAsyncProcessing();
-      current_time = Chimera::millis();
-    }
+    init->device->doAsyncProcessing();
 
     
-    if ( init->device->packetAvailable() )
+    for ( size_t x = 0; ( x < MaxReadsPerPass ) && init->device->packetAvailable(); x++ )
     {
-      size_t packetSize = init->device->nextPacketLength();
-
-      if ( packetSize == sizeof( MessageType ) )
+      if ( !ReadMessage( init->device, rxData ) )
       {
-        init->device->read( &rxData, sizeof( MessageType ) );
-        logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Chimera::millis(), init->deviceAddress, rxData.crc, rxData.node );
+        continue;
       }
 
+      logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Sim::Clock::millis(), init->deviceAddress, rxData.crc, rxData.node );
+
       rxData.crc    = 0xCAFECAFE;
       rxData.node = 12;
       init->device->write( 000, &rxData, sizeof( MessageType ) );
+      init->work->notify();
     }
 
-    Chimera::delayMilliseconds( ThreadUpdateRate );
+    /*------------------------------------------------
+    Sleep until data gets queued or the endpoint's
+    housekeeping is due
+    ------------------------------------------------*/
+    init->work->waitForWork( AsyncUpdateRate );
   }
 }
 
@@ -738,7 +774,7 @@ static void ChildNode_013_ConnectCallback( NetResult result, NetId id )
 
 static void ChildNodeThread_013( EndpointInitializer *init )
 {
-  SetThreadDescription( GetCurrentThread(), L"ChildNode-013" );
+  Sim::Platform::setThreadName( "ChildNode-013" );
 
   /*------------------------------------------------
   Initialize the device logger
@@ -782,13 +818,13 @@ static void ChildNodeThread_013( EndpointInitializer *init )
   ------------------------------------------------*/
   isConnected_013 = NetResult::CONNECT_PROC_UNKNOWN;
 
-  Chimera::delayMilliseconds( BootDelay );
+  Sim::Clock::delayMilliseconds( init->bootDelay );
 
   init->device->connectAsync( ChildNode_013_ConnectCallback, ConnectTimeout );
   while ( isConnected_013 == NetResult::CONNECT_PROC_UNKNOWN )
   {
     init->device->processNetworking();
-    Chimera::delayMilliseconds( 10 );
+    init->work->waitForWork( 10 );
   }
 
   if ( isConnected_013 == NetResult::CONNECT_PROC_SUCCESS )
@@ -805,29 +841,26 @@ static void ChildNodeThread_013( EndpointInitializer *init )
   /*------------------------------------------------
   Device Processing Thread
   ------------------------------------------------*/
-  size_t current_time = Chimera::millis();
-
   while ( true )
   {
-    if ( ( Chimera::millis() - current_time ) > AsyncUpdateRate )
-    {
-      init->device->doAsyncProcessing();
-      current_time = Chimera::millis();
-    }
+    init->device->doAsyncProcessing();
 
-    if ( init->device->packetAvailable() )
+    for ( size_t x = 0; ( x < MaxReadsPerPass ) && init->device->packetAvailable(); x++ )
     {
-      size_t packetSize = init->device->nextPacketLength();
-
-      if ( packetSize == sizeof( MessageType ) )
+      if ( !ReadMessage( init->device, rxData ) )
       {
-        init->device->read( &rxData, sizeof( MessageType ) );
-        logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Chimera::millis(),
-                       init->deviceAddress, rxData.crc, rxData.node );
+        continue;
       }
+
+      logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Sim::Clock::millis(),
+                     init->deviceAddress, rxData.crc, rxData.node );
     }
 
-    Chimera::delayMilliseconds( ThreadUpdateRate );
+    /*------------------------------------------------
+    Sleep until data gets queued or the endpoint's
+    housekeeping is due
+    ------------------------------------------------*/
+    init->work->waitForWork( AsyncUpdateRate );
   }
 }
 
@@ -842,7 +875,7 @@ static void ChildNode_0113_ConnectCallback( NetResult result, NetId id )
 
 static void ChildNodeThread_0113( EndpointInitializer *init )
 {
-  SetThreadDescription( GetCurrentThread(), L"ChildNode-0113" );
+  Sim::Platform::setThreadName( "ChildNode-0113" );
 
   /*------------------------------------------------
   Initialize the device logger
@@ -886,13 +919,13 @@ static void ChildNodeThread_0113( EndpointInitializer *init )
   ------------------------------------------------*/
   isConnected_0113 = NetResult::CONNECT_PROC_UNKNOWN;
 
-  Chimera::delayMilliseconds( BootDelay );
+  Sim::Clock::delayMilliseconds( init->bootDelay );
 
   init->device->connectAsync( ChildNode_0113_ConnectCallback, ConnectTimeout );
   while ( isConnected_0113 == NetResult::CONNECT_PROC_UNKNOWN )
   {
     init->device->processNetworking();
-    Chimera::delayMilliseconds( 10 );
+    init->work->waitForWork( 10 );
   }
 
   if ( isConnected_0113 == NetResult::CONNECT_PROC_SUCCESS )
@@ -909,29 +942,26 @@ static void ChildNodeThread_0113( EndpointInitializer *init )
   /*------------------------------------------------
   Device Processing Thread
   ------------------------------------------------*/
-  size_t current_time = Chimera::millis();
-
   while ( true )
   {
-    if ( ( Chimera::millis() - current_time ) > AsyncUpdateRate )
-    {
-      init->device->doAsyncProcessing();
-      current_time = Chimera::millis();
-    }
+    init->device->doAsyncProcessing();
 
-    if ( init->device->packetAvailable() )
+    for ( size_t x = 0; ( x < MaxReadsPerPass ) && init->device->packetAvailable(); x++ )
     {
-      size_t packetSize = init->device->nextPacketLength();
-
-      if ( packetSize == sizeof( MessageType ) )
+      if ( !ReadMessage( init->device, rxData ) )
       {
-        init->device->read( &rxData, sizeof( MessageType ) );
-        logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Chimera::millis(),
-                       init->deviceAddress, rxData.crc, rxData.node );
+        continue;
       }
+
+      logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Sim::Clock::millis(),
+                     init->deviceAddress, rxData.crc, rxData.node );
     }
 
-    Chimera::delayMilliseconds( ThreadUpdateRate );
+    /*------------------------------------------------
+    Sleep until data gets queued or the endpoint's
+    housekeeping is due
+    ------------------------------------------------*/
+    init->work->waitForWork( AsyncUpdateRate );
   }
 }
 
@@ -946,7 +976,7 @@ static void ChildNode_02113_ConnectCallback( NetResult result, NetId id )
 
 static void ChildNodeThread_02113( EndpointInitializer *init )
 {
-  SetThreadDescription( GetCurrentThread(), L"ChildNode-02113" );
+  Sim::Platform::setThreadName( "ChildNode-02113" );
 
   /*------------------------------------------------
   Initialize the device logger
@@ -990,13 +1020,13 @@ static void ChildNodeThread_02113( EndpointInitializer *init )
   ------------------------------------------------*/
   isConnected_02113 = NetResult::CONNECT_PROC_UNKNOWN;
 
-  Chimera::delayMilliseconds( BootDelay );
+  Sim::Clock::delayMilliseconds( init->bootDelay );
 
   init->device->connectAsync( ChildNode_02113_ConnectCallback, ConnectTimeout );
   while ( isConnected_02113 == NetResult::CONNECT_PROC_UNKNOWN )
   {
     init->device->processNetworking();
-    Chimera::delayMilliseconds( 10 );
+    init->work->waitForWork( 10 );
   }
 
   if ( isConnected_02113 == NetResult::CONNECT_PROC_SUCCESS )
@@ -1013,29 +1043,26 @@ static void ChildNodeThread_02113( EndpointInitializer *init )
   /*------------------------------------------------
   Device Processing Thread
   ------------------------------------------------*/
-  size_t current_time = Chimera::millis();
-
   while ( true )
   {
-    if ( ( Chimera::millis() - current_time ) > AsyncUpdateRate )
-    {
-      init->device->doAsyncProcessing();
-      current_time = Chimera::millis();
-    }
+    init->device->doAsyncProcessing();
 
-    if ( init->device->packetAvailable() )
+    for ( size_t x = 0; ( x < MaxReadsPerPass ) && init->device->packetAvailable(); x++ )
     {
-      size_t packetSize = init->device->nextPacketLength();
-
-      if ( packetSize == sizeof( MessageType ) )
+      if ( !ReadMessage( init->device, rxData ) )
       {
-        init->device->read( &rxData, sizeof( MessageType ) );
-        logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Chimera::millis(),
-                       init->deviceAddress, rxData.crc, rxData.node );
+        continue;
       }
+
+      logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Sim::Clock::millis(),
+                     init->deviceAddress, rxData.crc, rxData.node );
     }
 
-    Chimera::delayMilliseconds( ThreadUpdateRate );
+    /*------------------------------------------------
+    Sleep until data gets queued or the endpoint's
+    housekeeping is due
+    ------------------------------------------------*/
+    init->work->waitForWork( AsyncUpdateRate );
   }
 }
 
@@ -1050,7 +1077,7 @@ static void ChildNode_042113_ConnectCallback( NetResult result, NetId id )
 
 static void ChildNodeThread_042113( EndpointInitializer *init )
 {
-  SetThreadDescription( GetCurrentThread(), L"ChildNode-042113" );
+  Sim::Platform::setThreadName( "ChildNode-042113" );
 
   /*------------------------------------------------
   Initialize the device logger
@@ -1094,13 +1121,13 @@ static void ChildNodeThread_042113( EndpointInitializer *init )
   ------------------------------------------------*/
   isConnected_042113 = NetResult::CONNECT_PROC_UNKNOWN;
 
-  Chimera::delayMilliseconds( BootDelay );
+  Sim::Clock::delayMilliseconds( init->bootDelay );
 
   init->device->connectAsync( ChildNode_042113_ConnectCallback, ConnectTimeout );
   while ( isConnected_042113 == NetResult::CONNECT_PROC_UNKNOWN )
   {
     init->device->processNetworking();
-    Chimera::delayMilliseconds( 10 );
+    init->work->waitForWork( 10 );
   }
 
   if ( isConnected_042113 == NetResult::CONNECT_PROC_SUCCESS )
@@ -1117,36 +1144,35 @@ static void ChildNodeThread_042113( EndpointInitializer *init )
   /*------------------------------------------------
   Device Processing Thread
   ------------------------------------------------*/
-  size_t current_time = Chimera::millis();
-
   while ( true )
   {
-    if ( ( Chimera::millis() - current_time ) > AsyncUpdateRate )
-    {
-      init->device->doAsyncProcessing();
-      current_time = Chimera::millis();
-    }
+    init->device->doAsyncProcessing();
 
-    if ( init->device->packetAvailable() )
+    for ( size_t x = 0; ( x < MaxReadsPerPass ) && init->device->packetAvailable(); x++ )
     {
-      size_t packetSize = init->device->nextPacketLength();
-
-      if ( packetSize == sizeof( MessageType ) )
+      if ( !ReadMessage( init->device, rxData ) )
       {
-        init->device->read( &rxData, sizeof( MessageType ) );
-        logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Chimera::millis(),
-                       init->deviceAddress, rxData.crc, rxData.node );
+        continue;
       }
 
+      logSink->flog( uLog::Level::LVL_INFO, "%d-APP: Node %04o Received CRC: 0x%08X, Node: %d\n", Sim::Clock::millis(),
+                     init->deviceAddress, rxData.crc, rxData.node );
+
       rxData.crc = 0xDEADBEEF;
       rxData.node = 42113;
       init->device->write( 000, &rxData, sizeof( MessageType ) );
+      init->work->notify();
 
       rxData.crc = 0xFEEDFACE;
       rxData.node = 42113;
       init->device->write( 012, &rxData, sizeof( MessageType ) );
+      init->work->notify();
     }
 
-    Chimera::delayMilliseconds( ThreadUpdateRate );
+    /*------------------------------------------------
+    Sleep until data gets queued or the endpoint's
+    housekeeping is due
+    ------------------------------------------------*/
+    init->work->waitForWork( AsyncUpdateRate );
   }
 }
@@ -0,0 +1,202 @@
+/* STL Includes */
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+#include <RF24Node/src/common/conversion.hpp>
+
+/* Dev Includes */
+#include <sim_channel.hpp>
+#include <sim_clock.hpp>
+#include <sim_medium.hpp>
+#include <sim_shockburst.hpp>
+
+static constexpr size_t NumSenders       = 6;
+static constexpr size_t SendPeriodUs     = 10000;
+static constexpr size_t PeriodSpreadUs   = 137;
+static constexpr size_t RunTimeMs        = 10000;
+static constexpr size_t DrainRateUs      = 250;
+static constexpr double LinkLoss         = 0.05;
+static constexpr uint8_t TestChannel     = 96;
+static constexpr RF24::LogicalAddress Receiver = RF24::RootNode0;
+
+struct TuningResult
+{
+  uint64_t latencySumUs;
+  size_t latencySamples;
+};
+
+static void SenderThread( Sim::ShockBurst::Transceiver_sPtr radio, const Sim::Medium::Address destination,
+                          const uint64_t periodUs, const uint64_t endTime, TuningResult *result );
+static void DrainThread( const Sim::Medium::Address address, const uint64_t endTime );
+
+/*------------------------------------------------
+Sweeps the auto retransmit delay and count for a star of
+senders talking to one receiver over a lossy, shared
+channel. Prints how each setting trades latency against
+delivery so retry settings can be picked from data.
+------------------------------------------------*/
+void RunRetryTuningTests()
+{
+  static const uint8_t delays[] = { 0, 1, 3, 5, 15 };
+  static const uint8_t counts[] = { 0, 3, 8, 15 };
+
+  printf( "ARD(us) ARC stagger  tx_ok  max_rt  attempts/frame  mean_latency(us)  dups\n" );
+
+  /*------------------------------------------------
+  Senders sharing one ARD that collide once will keep
+  colliding on every retry, so also try giving each
+  sender its own delay.
+  ------------------------------------------------*/
+  for ( const bool stagger : { false, true } )
+  {
+    for ( const uint8_t ard : delays )
+    {
+      for ( const uint8_t arc : counts )
+      {
+        Sim::Channel::reset();
+        Sim::Channel::Config channelCfg              = Sim::Channel::defaultConfig();
+        channelCfg.enabled                           = true;
+        channelCfg.jitterUs                          = 500;
+        channelCfg.defaultLink.lossProbability       = LinkLoss;
+        Sim::Channel::configure( channelCfg );
+
+        Sim::ShockBurst::Config radioCfg;
+        radioCfg.channel    = TestChannel;
+        radioCfg.dataRate   = RF24::Hardware::DataRate::DR_1MBPS;
+        radioCfg.retryDelay = ard;
+        radioCfg.retryCount = arc;
+        radioCfg.autoAck    = true;
+        radioCfg.streamTx   = false;
+        radioCfg.spiClockHz = 0;
+
+        const auto rxAddress = RF24::Physical::Conversion::getPhysicalAddress( Receiver, RF24::Hardware::PIPE_NUM_1 );
+        auto receiver        = Sim::ShockBurst::Transceiver::createShared( radioCfg );
+        receiver->openReadingPipe( RF24::Hardware::PIPE_NUM_1, rxAddress );
+
+        std::vector<Sim::ShockBurst::Transceiver_sPtr> senders;
+        std::vector<TuningResult> results( NumSenders, TuningResult{ 0, 0 } );
+        std::vector<std::thread> threads;
+        const uint64_t endTime = Sim::Clock::micros() + ( RunTimeMs * 1000 );
+
+        {
+          Sim::Clock::HoldScope hold;
+
+          for ( size_t x = 0; x < NumSenders; x++ )
+          {
+            Sim::ShockBurst::Config senderCfg = radioCfg;
+            if ( stagger )
+            {
+              senderCfg.retryDelay = static_cast<uint8_t>( std::min<size_t>( ard + x, 15 ) );
+            }
+
+            auto radio = Sim::ShockBurst::Transceiver::createShared( senderCfg );
+            radio->openReadingPipe( RF24::Hardware::PIPE_NUM_0, RF24::Physical::Conversion::getPhysicalAddress(
+                                                                     static_cast<RF24::LogicalAddress>( x + 1 ), RF24::Hardware::PIPE_NUM_0 ) );
+            senders.push_back( radio );
+
+            /*------------------------------------------------
+            Slightly different periods keep the senders from
+            settling into a fixed phase with each other, much
+            like the clock drift between real nodes.
+            ------------------------------------------------*/
+            const uint64_t period = SendPeriodUs + ( x * PeriodSpreadUs );
+            threads.push_back( Sim::Clock::createThread( SenderThread, radio, rxAddress, period, endTime, &results[ x ] ) );
+          }
+
+          threads.push_back( Sim::Clock::createThread( DrainThread, rxAddress, endTime ) );
+        }
+
+        for ( auto &thread : threads )
+        {
+          thread.join();
+        }
+
+        /*------------------------------------------------
+        Roll up the per-endpoint statistics
+        ------------------------------------------------*/
+        size_t framesSent = 0;
+        size_t maxRetries = 0;
+        size_t attempts   = 0;
+        uint64_t latency  = 0;
+        size_t samples    = 0;
+
+        for ( size_t x = 0; x < NumSenders; x++ )
+        {
+          const auto stats = senders[ x ]->getStats();
+          framesSent += stats.framesSent;
+          maxRetries += stats.maxRetryEvents;
+          attempts += stats.attempts;
+          latency += results[ x ].latencySumUs;
+          samples += results[ x ].latencySamples;
+        }
+
+        const size_t frames = framesSent + maxRetries;
+        printf( "%7llu %3u %7s  %5zu  %6zu  %14.2f  %16.1f  %4zu\n",
+                static_cast<unsigned long long>( Sim::ShockBurst::retryDelayUs( ard ) ), arc, stagger ? "yes" : "no", framesSent, maxRetries,
+                frames ? ( static_cast<double>( attempts ) / static_cast<double>( frames ) ) : 0.0,
+                samples ? ( static_cast<double>( latency ) / static_cast<double>( samples ) ) : 0.0,
+                receiver->getStats().duplicatesDropped );
+      }
+    }
+  }
+}
+
+static void SenderThread( Sim::ShockBurst::Transceiver_sPtr radio, const Sim::Medium::Address destination,
+                          const uint64_t periodUs, const uint64_t endTime, TuningResult *result )
+{
+  /*------------------------------------------------
+  The IRQ hook may still be queued on the clock after
+  this thread exits, so it shares ownership of the signal.
+  ------------------------------------------------*/
+  auto irq = std::make_shared<Sim::Clock::Signal>();
+  radio->setIrqHook( [ irq ]() { irq->notify(); } );
+
+  uint8_t payload[ 16 ] = { 0 };
+
+  while ( Sim::Clock::micros() < endTime )
+  {
+    const uint64_t start = Sim::Clock::micros();
+    payload[ 0 ]++;
+
+    if ( radio->transmit( destination, payload, sizeof( payload ) ) )
+    {
+      while ( radio->getStatus().txBusy )
+      {
+        irq->wait( Sim::Clock::WAIT_FOREVER );
+      }
+
+      if ( radio->getStatus().txDataSent )
+      {
+        result->latencySumUs += Sim::Clock::micros() - start;
+        result->latencySamples++;
+      }
+
+      radio->clearStatus();
+    }
+
+    Sim::Clock::delayMicroseconds( periodUs );
+  }
+
+  radio->setIrqHook( nullptr );
+}
+
+static void DrainThread( const Sim::Medium::Address address, const uint64_t endTime )
+{
+  Sim::Medium::Pipe pipe = Sim::Medium::openPipe( address );
+  Sim::Medium::Frame frame;
+
+  while ( Sim::Clock::micros() < endTime )
+  {
+    while ( pipe->pop( frame ) )
+    {
+    }
+
+    Sim::Clock::delayMicroseconds( DrainRateUs );
+  }
+}
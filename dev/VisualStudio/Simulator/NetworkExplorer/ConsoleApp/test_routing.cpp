@@ -0,0 +1,116 @@
+/* STL Includes */
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+#include <RF24Node/src/common/utility.hpp>
+
+/* Dev Includes */
+#include <sim_routing.hpp>
+
+static constexpr size_t NumDestinations   = 4096;
+static constexpr size_t NumPasses         = 2000;
+static constexpr uint32_t DestinationSeed = 0x5EED;
+
+static std::vector<RF24::LogicalAddress> EnumerateTree();
+
+/*------------------------------------------------
+Times the per frame forwarding decision made by walking
+the address against a precomputed next hop table, for
+routers at each depth of a fully populated tree. Every
+destination is checked against the reference first, so
+a faster but wrong table can't go unnoticed.
+------------------------------------------------*/
+void RunRoutingBenchmark()
+{
+  using Clock = std::chrono::steady_clock;
+
+  const std::vector<RF24::LogicalAddress> tree = EnumerateTree();
+  std::vector<RF24::LogicalAddress> destinations( NumDestinations );
+  std::mt19937 rng( DestinationSeed );
+
+  for ( auto &destination : destinations )
+  {
+    destination = tree[ rng() % tree.size() ];
+  }
+
+  printf( "router  level  reference(ns/frame)  table(ns/frame)  speedup  mismatches\n" );
+
+  for ( const RF24::LogicalAddress router : { 00000, 00001, 00021, 00321, 04321, 054321 } )
+  {
+    const Sim::Routing::NextHopTable table( router );
+    size_t mismatches = 0;
+
+    for ( const RF24::LogicalAddress destination : tree )
+    {
+      mismatches += ( table.nextHop( destination ) != Sim::Routing::referenceNextHop( router, destination ) ) ? 1 : 0;
+    }
+
+    /*------------------------------------------------
+    Fold every result into a checksum that gets printed,
+    otherwise the compiler is free to drop the lookups.
+    ------------------------------------------------*/
+    uint32_t checksum = 0;
+
+    const auto referenceStart = Clock::now();
+    for ( size_t pass = 0; pass < NumPasses; pass++ )
+    {
+      for ( const RF24::LogicalAddress destination : destinations )
+      {
+        checksum += Sim::Routing::referenceNextHop( router, destination );
+      }
+    }
+    const auto referenceEnd = Clock::now();
+
+    for ( size_t pass = 0; pass < NumPasses; pass++ )
+    {
+      for ( const RF24::LogicalAddress destination : destinations )
+      {
+        checksum += table.nextHop( destination );
+      }
+    }
+    const auto tableEnd = Clock::now();
+
+    const double frames      = static_cast<double>( NumPasses * NumDestinations );
+    const double referenceNs = std::chrono::duration<double, std::nano>( referenceEnd - referenceStart ).count() / frames;
+    const double tableNs     = std::chrono::duration<double, std::nano>( tableEnd - referenceEnd ).count() / frames;
+
+    printf( "%06o  %5u  %19.2f  %15.2f  %6.1fx  %10zu  (checksum %08X)\n", router, RF24::getLevel( router ), referenceNs,
+            tableNs, ( tableNs > 0.0 ) ? ( referenceNs / tableNs ) : 0.0, mismatches, checksum );
+  }
+}
+
+/**
+ *  Every address a fully populated tree can hand out, root included
+ *
+ *  @return std::vector<RF24::LogicalAddress>
+ */
+static std::vector<RF24::LogicalAddress> EnumerateTree()
+{
+  const auto first = static_cast<size_t>( RF24::Connection::BindSite::FIRST );
+  const auto last  = static_cast<size_t>( RF24::Connection::BindSite::LAST );
+
+  std::vector<RF24::LogicalAddress> tree    = { RF24::RootNode0 };
+  std::vector<RF24::LogicalAddress> parents = { RF24::RootNode0 };
+
+  for ( size_t level = RF24::NODE_LEVEL_1; level <= RF24::NODE_LEVEL_MAX; level++ )
+  {
+    std::vector<RF24::LogicalAddress> children;
+
+    for ( const RF24::LogicalAddress parent : parents )
+    {
+      for ( size_t site = first; site <= last; site++ )
+      {
+        children.push_back( RF24::getChild( parent, static_cast<RF24::Connection::BindSite>( site ) ) );
+      }
+    }
+
+    tree.insert( tree.end(), children.begin(), children.end() );
+    parents = children;
+  }
+
+  return tree;
+}
@@ -0,0 +1,213 @@
+/* STL Includes */
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/* RF24 Includes */
+#include <RF24Node/common>
+#include <RF24Node/src/common/conversion.hpp>
+
+/* Dev Includes */
+#include <sim_channel.hpp>
+#include <sim_clock.hpp>
+#include <sim_medium.hpp>
+#include <sim_shockburst.hpp>
+
+static constexpr size_t NumFrames        = 2000;
+static constexpr size_t FrameBytes       = 32;
+static constexpr size_t MaxReuse         = 2;
+static constexpr size_t DrainRateUs      = 100;
+static constexpr double LinkLoss         = 0.02;
+static constexpr uint8_t TestChannel     = 96;
+static constexpr RF24::LogicalAddress Sender   = 01;
+static constexpr RF24::LogicalAddress Receiver = RF24::RootNode0;
+
+struct StreamResult
+{
+  uint64_t elapsedUs;
+  size_t dropped;
+};
+
+static void SenderThread( Sim::ShockBurst::Transceiver_sPtr radio, const Sim::Medium::Address destination,
+                          std::atomic<bool> *done, StreamResult *result );
+static void DrainThread( const Sim::Medium::Address address, std::atomic<bool> *done, std::atomic<size_t> *received );
+
+/*------------------------------------------------
+Pushes a bulk transfer over a single link, once waiting
+for each frame to complete before loading the next and
+once keeping the TX FIFO topped up. Prints how close
+each gets to what the air itself allows.
+------------------------------------------------*/
+void RunStreamingTests()
+{
+  static const RF24::Hardware::DataRate rates[] = { RF24::Hardware::DataRate::DR_1MBPS, RF24::Hardware::DataRate::DR_2MBPS };
+  static const uint32_t spiClocks[]             = { 1000000, 4000000, 8000000 };
+
+  printf( "rate  spi(MHz)  mode       elapsed(ms)  kbps    air_limit(kbps)  received  dropped  reused\n" );
+
+  for ( const auto rate : rates )
+  {
+    /*------------------------------------------------
+    Best case per frame: the frame itself, then its ACK,
+    each after the PLL has settled
+    ------------------------------------------------*/
+    const uint64_t cycleUs = ( 2 * Sim::Channel::PLL_SETTLE_US ) + Sim::Channel::airtimeUs( rate, FrameBytes ) +
+                             Sim::Channel::airtimeUs( rate, 0 );
+    const double airLimit  = ( FrameBytes * 8.0 * 1000.0 ) / static_cast<double>( cycleUs );
+
+    for ( const uint32_t spiClock : spiClocks )
+    {
+      for ( const bool stream : { false, true } )
+      {
+        Sim::Channel::reset();
+        Sim::Channel::Config channelCfg        = Sim::Channel::defaultConfig();
+        channelCfg.enabled                     = true;
+        channelCfg.jitterUs                    = 0;
+        channelCfg.defaultLink.lossProbability = LinkLoss;
+        Sim::Channel::configure( channelCfg );
+
+        Sim::ShockBurst::Config radioCfg;
+        radioCfg.channel    = TestChannel;
+        radioCfg.dataRate   = rate;
+        radioCfg.retryDelay = 1;
+        radioCfg.retryCount = 3;
+        radioCfg.autoAck    = true;
+        radioCfg.streamTx   = stream;
+        radioCfg.spiClockHz = spiClock;
+
+        const auto rxAddress = RF24::Physical::Conversion::getPhysicalAddress( Receiver, RF24::Hardware::PIPE_NUM_1 );
+        auto receiver        = Sim::ShockBurst::Transceiver::createShared( radioCfg );
+        receiver->openReadingPipe( RF24::Hardware::PIPE_NUM_1, rxAddress );
+
+        auto sender = Sim::ShockBurst::Transceiver::createShared( radioCfg );
+        sender->openReadingPipe( RF24::Hardware::PIPE_NUM_0,
+                                 RF24::Physical::Conversion::getPhysicalAddress( Sender, RF24::Hardware::PIPE_NUM_0 ) );
+
+        std::atomic<bool> done( false );
+        std::atomic<size_t> received( 0 );
+        StreamResult result{ 0, 0 };
+        std::vector<std::thread> threads;
+
+        {
+          Sim::Clock::HoldScope hold;
+          threads.push_back( Sim::Clock::createThread( SenderThread, sender, rxAddress, &done, &result ) );
+          threads.push_back( Sim::Clock::createThread( DrainThread, rxAddress, &done, &received ) );
+        }
+
+        for ( auto &thread : threads )
+        {
+          thread.join();
+        }
+
+        const double kbps = result.elapsedUs ? ( ( received * FrameBytes * 8.0 * 1000.0 ) / static_cast<double>( result.elapsedUs ) ) : 0.0;
+
+        printf( "%4s  %8.1f  %-9s  %11.1f  %6.1f  %15.1f  %8zu  %7zu  %6zu\n",
+                ( rate == RF24::Hardware::DataRate::DR_2MBPS ) ? "2M" : "1M", spiClock / 1e6, stream ? "streaming" : "single",
+                result.elapsedUs / 1000.0, kbps, airLimit, received.load(), result.dropped, sender->getStats().framesReused );
+      }
+    }
+  }
+}
+
+static void SenderThread( Sim::ShockBurst::Transceiver_sPtr radio, const Sim::Medium::Address destination,
+                          std::atomic<bool> *done, StreamResult *result )
+{
+  auto irq = std::make_shared<Sim::Clock::Signal>();
+  radio->setIrqHook( [ irq ]() { irq->notify(); } );
+
+  uint8_t payload[ FrameBytes ] = { 0 };
+  size_t loaded                 = 0;
+  size_t headSent               = 0;
+  size_t headReuses             = 0;
+  const uint64_t start          = Sim::Clock::micros();
+
+  while ( true )
+  {
+    /*------------------------------------------------
+    Load everything the FIFO will take. Outside of
+    streaming mode that is a single frame, and only once
+    the previous one has completed.
+    ------------------------------------------------*/
+    while ( loaded < NumFrames )
+    {
+      payload[ 0 ] = static_cast<uint8_t>( loaded );
+      if ( !radio->transmit( destination, payload, sizeof( payload ) ) )
+      {
+        break;
+      }
+
+      loaded++;
+    }
+
+    auto status = radio->getStatus();
+
+    /*------------------------------------------------
+    A frame that ran out of retransmits gets a couple
+    more tries before it is given up on, the frames
+    queued behind it wait either way.
+    ------------------------------------------------*/
+    if ( status.maxRetries )
+    {
+      const size_t sent = radio->getStats().framesSent;
+      if ( sent != headSent )
+      {
+        headSent   = sent;
+        headReuses = 0;
+      }
+
+      if ( ( headReuses < MaxReuse ) && radio->retryTransmit() )
+      {
+        headReuses++;
+      }
+      else
+      {
+        radio->clearStatus();
+        result->dropped++;
+        headReuses = 0;
+      }
+
+      continue;
+    }
+
+    if ( status.txDataSent )
+    {
+      radio->clearStatus();
+    }
+
+    if ( ( loaded == NumFrames ) && !status.txBusy )
+    {
+      break;
+    }
+
+    irq->wait( Sim::Clock::WAIT_FOREVER );
+  }
+
+  result->elapsedUs = Sim::Clock::micros() - start;
+  radio->setIrqHook( nullptr );
+  done->store( true );
+}
+
+static void DrainThread( const Sim::Medium::Address address, std::atomic<bool> *done, std::atomic<size_t> *received )
+{
+  Sim::Medium::Pipe pipe = Sim::Medium::openPipe( address );
+  Sim::Medium::Frame frame;
+
+  while ( true )
+  {
+    const bool finished = done->load();
+
+    while ( pipe->pop( frame ) )
+    {
+      received->fetch_add( 1 );
+    }
+
+    if ( finished )
+    {
+      break;
+    }
+
+    Sim::Clock::delayMicroseconds( DrainRateUs );
+  }
+}
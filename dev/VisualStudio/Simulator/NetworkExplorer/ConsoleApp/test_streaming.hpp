@@ -0,0 +1,2 @@
+#pragma once
+extern void RunStreamingTests();
@@ -0,0 +1,359 @@
+/********************************************************************************
+*  File Name:
+*    test_device.cpp
+*
+*  Description:
+*    Tests the NRF24L01+ emulator against the behavior described in the
+*    datasheet, driving it only through SPI transactions and the CE pin
+*
+*  2020 | Brandon Braun | brandonbraun653@gmail.com
+********************************************************************************/
+
+/* GTest Includes */
+#include "gtest/gtest.h"
+
+/* C++ Includes */
+#include <array>
+#include <vector>
+
+/* Dev Includes */
+#include <sim_device.hpp>
+#include <sim_registers.hpp>
+
+using namespace Sim::Device;
+using namespace Sim::Registers;
+
+/*-------------------------------------------------------------------------------
+Test Fixtures
+-------------------------------------------------------------------------------*/
+/**
+ *  Thin stand-in for the driver's SPI helpers
+ */
+class DeviceTest : public ::testing::Test
+{
+protected:
+  Emulator radio{ defaultConfig() };
+
+  uint8_t command( const uint8_t cmd, std::vector<uint8_t> args = {} )
+  {
+    args.insert( args.begin(), cmd );
+    radio.transfer( args.data(), args.data(), args.size() );
+    return args[ 0 ];
+  }
+
+  uint8_t readReg( const uint8_t reg )
+  {
+    std::array<uint8_t, 2> buffer = { static_cast<uint8_t>( CMD_R_REGISTER | reg ), CMD_NOP };
+    radio.transfer( buffer.data(), buffer.data(), buffer.size() );
+    return buffer[ 1 ];
+  }
+
+  void writeReg( const uint8_t reg, const uint8_t value )
+  {
+    command( CMD_W_REGISTER | reg, { value } );
+  }
+
+  void powerUp( const bool rx )
+  {
+    writeReg( REG_CONFIG, CONFIG_EN_CRC | CONFIG_CRCO | CONFIG_PWR_UP | ( rx ? CONFIG_PRIM_RX : 0 ) );
+    radio.advance( POWER_UP_US );
+  }
+
+  void pulseCE()
+  {
+    radio.setCE( true );
+    radio.advance( 10 );
+    radio.setCE( false );
+  }
+};
+
+/*-------------------------------------------------------------------------------
+Tests
+-------------------------------------------------------------------------------*/
+TEST_F( DeviceTest, ResetValues )
+{
+  EXPECT_EQ( command( CMD_NOP ), 0x0E );
+  EXPECT_EQ( readReg( REG_CONFIG ), 0x08 );
+  EXPECT_EQ( readReg( REG_EN_AA ), 0x3F );
+  EXPECT_EQ( readReg( REG_RF_CH ), 0x02 );
+  EXPECT_EQ( readReg( REG_FIFO_STATUS ), FIFO_STATUS_TX_EMPTY | FIFO_STATUS_RX_EMPTY );
+  EXPECT_EQ( radio.mode(), Mode::POWER_DOWN );
+
+  std::array<uint8_t, 6> address = { CMD_R_REGISTER | REG_RX_ADDR_P1, 0, 0, 0, 0, 0 };
+  radio.transfer( address.data(), address.data(), address.size() );
+  EXPECT_EQ( address[ 1 ], 0xC2 );
+  EXPECT_EQ( address[ 5 ], 0xC2 );
+}
+
+TEST_F( DeviceTest, ReadOnlyBitsIgnoreWrites )
+{
+  writeReg( REG_RF_CH, 0xFF );
+  writeReg( REG_FIFO_STATUS, 0xFF );
+  writeReg( REG_SETUP_AW, 0xFF );
+
+  EXPECT_EQ( readReg( REG_RF_CH ), 0x7F );
+  EXPECT_EQ( readReg( REG_FIFO_STATUS ), FIFO_STATUS_TX_EMPTY | FIFO_STATUS_RX_EMPTY );
+  EXPECT_EQ( readReg( REG_SETUP_AW ), 0x03 );
+}
+
+TEST_F( DeviceTest, PowerUpTakesCrystalStartup )
+{
+  writeReg( REG_CONFIG, CONFIG_EN_CRC | CONFIG_PWR_UP );
+  EXPECT_EQ( radio.mode(), Mode::START_UP );
+
+  radio.advance( POWER_UP_US - 10 );
+  EXPECT_EQ( radio.mode(), Mode::START_UP );
+
+  radio.advance( 10 );
+  EXPECT_EQ( radio.mode(), Mode::STANDBY );
+
+  writeReg( REG_CONFIG, CONFIG_EN_CRC );
+  EXPECT_EQ( radio.mode(), Mode::POWER_DOWN );
+}
+
+TEST_F( DeviceTest, TransmitOnCePulse )
+{
+  std::vector<Payload> sent;
+  radio.setLinkHook( [ &sent ]( const Payload &payload, const size_t ) {
+    sent.push_back( payload );
+    return true;
+  } );
+
+  powerUp( false );
+  command( CMD_W_TX_PAYLOAD, { 1, 2, 3, 4 } );
+
+  /*------------------------------------------------
+  Nothing happens in Standby-I until CE is pulsed
+  ------------------------------------------------*/
+  radio.advance( 1000 );
+  EXPECT_TRUE( sent.empty() );
+  EXPECT_EQ( readReg( REG_FIFO_STATUS ) & FIFO_STATUS_TX_EMPTY, 0 );
+
+  pulseCE();
+  EXPECT_EQ( radio.mode(), Mode::TX );
+  EXPECT_FALSE( radio.irqAsserted() );
+
+  radio.advance( 1000 );
+  EXPECT_EQ( radio.mode(), Mode::STANDBY );
+  EXPECT_TRUE( radio.irqAsserted() );
+  EXPECT_EQ( command( CMD_NOP ) & STATUS_TX_DS, STATUS_TX_DS );
+  EXPECT_EQ( readReg( REG_FIFO_STATUS ) & FIFO_STATUS_TX_EMPTY, FIFO_STATUS_TX_EMPTY );
+
+  ASSERT_EQ( sent.size(), 1 );
+  EXPECT_EQ( sent[ 0 ].length, 4 );
+  EXPECT_EQ( sent[ 0 ].data[ 3 ], 4 );
+
+  /*------------------------------------------------
+  Writing a one clears the flag and releases the IRQ
+  ------------------------------------------------*/
+  writeReg( REG_STATUS, STATUS_TX_DS );
+  EXPECT_EQ( command( CMD_NOP ) & STATUS_TX_DS, 0 );
+  EXPECT_FALSE( radio.irqAsserted() );
+}
+
+TEST_F( DeviceTest, PacketTimingFollowsDatasheet )
+{
+  powerUp( false );
+  writeReg( REG_EN_AA, 0x00 );
+  writeReg( REG_CONFIG, CONFIG_PWR_UP );
+  writeReg( REG_RF_SETUP, 0x06 );    // 1Mbps, the reset value selects 2Mbps
+  command( CMD_W_TX_PAYLOAD, std::vector<uint8_t>( 32, 0xAA ) );
+
+  /*------------------------------------------------
+  No ACK and no CRC at 1Mbps: 130us settling, then
+  (1 + 5 + 32) bytes plus the 9 bit PCF on the air
+  ------------------------------------------------*/
+  const uint64_t start  = radio.micros();
+  const uint64_t expect = SETTLE_US + ( ( 1 + 5 + 32 ) * 8 ) + PCF_BITS;
+
+  radio.setCE( true );
+  radio.advance( expect - 1 );
+  EXPECT_EQ( command( CMD_NOP ) & STATUS_TX_DS, 0 );
+
+  radio.advance( 1 );
+  EXPECT_EQ( command( CMD_NOP ) & STATUS_TX_DS, STATUS_TX_DS );
+  EXPECT_GE( radio.micros() - start, expect );
+}
+
+TEST_F( DeviceTest, MaxRetriesKeepsPayload )
+{
+  size_t attempts = 0;
+  radio.setLinkHook( [ &attempts ]( const Payload &, const size_t ) {
+    attempts++;
+    return false;
+  } );
+
+  powerUp( false );
+  writeReg( REG_SETUP_RETR, 0x13 );    // 500us, 3 retransmits
+  command( CMD_W_TX_PAYLOAD, { 0x55 } );
+  pulseCE();
+  radio.advance( 10000 );
+
+  EXPECT_EQ( attempts, 4 );
+  EXPECT_EQ( command( CMD_NOP ) & STATUS_MAX_RT, STATUS_MAX_RT );
+  EXPECT_EQ( readReg( REG_OBSERVE_TX ), 0x13 );    // PLOS_CNT 1, ARC_CNT 3
+  EXPECT_EQ( readReg( REG_FIFO_STATUS ) & FIFO_STATUS_TX_EMPTY, 0 );
+
+  /*------------------------------------------------
+  MAX_RT blocks the radio until it is cleared
+  ------------------------------------------------*/
+  pulseCE();
+  radio.advance( 10000 );
+  EXPECT_EQ( attempts, 4 );
+
+  writeReg( REG_STATUS, STATUS_MAX_RT );
+  pulseCE();
+  radio.advance( 10000 );
+  EXPECT_EQ( attempts, 8 );
+  EXPECT_EQ( readReg( REG_OBSERVE_TX ), 0x23 );
+
+  /*------------------------------------------------
+  Writing RF_CH resets the lost packet count
+  ------------------------------------------------*/
+  writeReg( REG_RF_CH, 40 );
+  EXPECT_EQ( readReg( REG_OBSERVE_TX ), 0x03 );
+
+  command( CMD_FLUSH_TX );
+  EXPECT_EQ( readReg( REG_FIFO_STATUS ) & FIFO_STATUS_TX_EMPTY, FIFO_STATUS_TX_EMPTY );
+}
+
+TEST_F( DeviceTest, CeHeldHighEmptiesTheFifo )
+{
+  size_t attempts = 0;
+  radio.setLinkHook( [ &attempts ]( const Payload &, const size_t ) {
+    attempts++;
+    return true;
+  } );
+
+  powerUp( false );
+
+  for ( uint8_t x = 0; x < 4; x++ )
+  {
+    command( CMD_W_TX_PAYLOAD, { x } );
+  }
+
+  EXPECT_EQ( command( CMD_NOP ) & STATUS_TX_FULL, STATUS_TX_FULL );
+
+  radio.setCE( true );
+  radio.advance( 10000 );
+
+  EXPECT_EQ( attempts, 3 );
+  EXPECT_EQ( radio.mode(), Mode::STANDBY );
+  EXPECT_EQ( readReg( REG_FIFO_STATUS ) & FIFO_STATUS_TX_EMPTY, FIFO_STATUS_TX_EMPTY );
+
+  /*------------------------------------------------
+  Standby-II sends a new payload as soon as it lands
+  ------------------------------------------------*/
+  command( CMD_W_TX_PAYLOAD, { 9 } );
+  EXPECT_EQ( radio.mode(), Mode::TX );
+}
+
+TEST_F( DeviceTest, ReceiveDynamicPayloads )
+{
+  writeReg( REG_FEATURE, FEATURE_EN_DPL | FEATURE_EN_ACK_PAY );
+  writeReg( REG_DYNPD, 0x3F );
+  powerUp( true );
+
+  const uint8_t frame[] = { 0xDE, 0xAD, 0xBE, 0xEF, 0x01 };
+
+  EXPECT_FALSE( radio.receive( 1, frame, sizeof( frame ) ) );    // Receiver is still off
+
+  radio.setCE( true );
+  radio.advance( SETTLE_US );
+  ASSERT_EQ( radio.mode(), Mode::RX );
+
+  command( CMD_W_ACK_PAYLOAD | 1, { 0x42 } );
+
+  EXPECT_TRUE( radio.receive( 1, frame, sizeof( frame ) ) );
+  EXPECT_FALSE( radio.receive( 3, frame, sizeof( frame ) ) );    // Pipe isn't enabled
+
+  const uint8_t status = command( CMD_NOP );
+  EXPECT_EQ( status & STATUS_RX_DR, STATUS_RX_DR );
+  EXPECT_EQ( status & STATUS_TX_DS, STATUS_TX_DS );              // The ACK payload went out
+  EXPECT_EQ( ( status & STATUS_RX_P_NO ) >> 1, 1 );
+
+  std::array<uint8_t, 2> width = { CMD_R_RX_PL_WID, CMD_NOP };
+  radio.transfer( width.data(), width.data(), width.size() );
+  EXPECT_EQ( width[ 1 ], sizeof( frame ) );
+
+  std::array<uint8_t, 6> payload = { CMD_R_RX_PAYLOAD };
+  radio.transfer( payload.data(), payload.data(), payload.size() );
+  EXPECT_EQ( payload[ 1 ], 0xDE );
+  EXPECT_EQ( payload[ 5 ], 0x01 );
+  EXPECT_EQ( ( command( CMD_NOP ) & STATUS_RX_P_NO ) >> 1, 7 );
+}
+
+TEST_F( DeviceTest, StaticWidthAndFullFifo )
+{
+  writeReg( REG_RX_PW_P0, 8 );
+  powerUp( true );
+  radio.setCE( true );
+  radio.advance( SETTLE_US );
+
+  const uint8_t frame[] = { 1, 2, 3 };
+
+  EXPECT_FALSE( radio.receive( 1, frame, sizeof( frame ) ) );    // RX_PW_P1 is zero
+  EXPECT_TRUE( radio.receive( 0, frame, sizeof( frame ) ) );
+  EXPECT_TRUE( radio.receive( 0, frame, sizeof( frame ) ) );
+  EXPECT_TRUE( radio.receive( 0, frame, sizeof( frame ) ) );
+  EXPECT_FALSE( radio.receive( 0, frame, sizeof( frame ) ) );
+
+  EXPECT_EQ( readReg( REG_FIFO_STATUS ) & FIFO_STATUS_RX_FULL, FIFO_STATUS_RX_FULL );
+
+  std::array<uint8_t, 2> width = { CMD_R_RX_PL_WID, CMD_NOP };
+  radio.transfer( width.data(), width.data(), width.size() );
+  EXPECT_EQ( width[ 1 ], 8 );
+
+  command( CMD_FLUSH_RX );
+  EXPECT_EQ( readReg( REG_FIFO_STATUS ) & FIFO_STATUS_RX_EMPTY, FIFO_STATUS_RX_EMPTY );
+}
+
+TEST_F( DeviceTest, BusStatisticsPerOperation )
+{
+  radio.beginOperation( "configure" );
+  writeReg( REG_RF_CH, 76 );
+  writeReg( REG_RF_SETUP, 0x06 );
+  radio.endOperation();
+
+  radio.beginOperation( "poll" );
+  command( CMD_NOP );
+  radio.endOperation();
+
+  command( CMD_NOP );
+
+  const auto totals  = radio.getTotals();
+  const auto profile = radio.getProfile();
+
+  EXPECT_EQ( totals.transactions, 4 );
+  EXPECT_EQ( totals.bytes, 6 );
+  EXPECT_EQ( totals.busTimeNs, 6000 );    // 8 bits at 8MHz per byte
+
+  ASSERT_EQ( profile.count( "configure" ), 1 );
+  EXPECT_EQ( profile.at( "configure" ).calls, 1 );
+  EXPECT_EQ( profile.at( "configure" ).bus.transactions, 2 );
+  EXPECT_EQ( profile.at( "configure" ).bus.bytes, 4 );
+  EXPECT_EQ( profile.at( "poll" ).bus.transactions, 1 );
+}
+
+TEST_F( DeviceTest, ShadowSavesTransactions )
+{
+  RegisterBus bus( radio );
+  Shadow shadow( bus );
+
+  shadow.prime();
+  const size_t primed = radio.getTotals().transactions;
+
+  /*------------------------------------------------
+  Flipping between TX and RX the way a driver would
+  ------------------------------------------------*/
+  for ( size_t x = 0; x < 10; x++ )
+  {
+    shadow.update( REG_CONFIG, CONFIG_PRIM_RX, CONFIG_PRIM_RX );
+    shadow.update( REG_CONFIG, CONFIG_PRIM_RX, 0 );
+    shadow.write( REG_RF_CH, 76 );
+  }
+
+  EXPECT_EQ( radio.getTotals().transactions - primed, 21 );
+  EXPECT_EQ( readReg( REG_CONFIG ), CONFIG_EN_CRC );
+  EXPECT_EQ( readReg( REG_RF_CH ), 76 );
+}
@@ -0,0 +1,224 @@
+/********************************************************************************
+*  File Name:
+*    test_registers.cpp
+*
+*  Description:
+*    Tests the NRF24L01 register shadow against a fake radio that counts
+*    every bus transaction
+*
+*  2020 | Brandon Braun | brandonbraun653@gmail.com
+********************************************************************************/
+
+/* GTest Includes */
+#include "gtest/gtest.h"
+
+/* C++ Includes */
+#include <array>
+#include <cstring>
+
+/* Dev Includes */
+#include <sim_registers.hpp>
+
+using namespace Sim::Registers;
+
+/*-------------------------------------------------------------------------------
+Test Fixtures
+-------------------------------------------------------------------------------*/
+/**
+ *  Register file with power on defaults that records how often it was accessed
+ */
+class FakeRadio : public Bus
+{
+public:
+  std::array<std::array<uint8_t, MAX_REGISTER_WIDTH>, NUM_REGISTERS> regs;
+  size_t reads  = 0;
+  size_t writes = 0;
+
+  FakeRadio()
+  {
+    for ( auto &reg : regs )
+    {
+      reg.fill( 0 );
+    }
+
+    regs[ REG_CONFIG ][ 0 ]     = 0x08;
+    regs[ REG_EN_AA ][ 0 ]      = 0x3F;
+    regs[ REG_EN_RXADDR ][ 0 ]  = 0x03;
+    regs[ REG_SETUP_AW ][ 0 ]   = 0x03;
+    regs[ REG_SETUP_RETR ][ 0 ] = 0x03;
+    regs[ REG_RF_CH ][ 0 ]      = 0x02;
+    regs[ REG_RF_SETUP ][ 0 ]   = 0x0E;
+    regs[ REG_STATUS ][ 0 ]     = 0x0E;
+    regs[ REG_RX_ADDR_P0 ].fill( 0xE7 );
+    regs[ REG_RX_ADDR_P1 ].fill( 0xC2 );
+    regs[ REG_TX_ADDR ].fill( 0xE7 );
+  }
+
+  void readRegister( const uint8_t reg, uint8_t *const data, const size_t length ) override
+  {
+    reads++;
+    memcpy( data, regs[ reg ].data(), length );
+  }
+
+  void writeRegister( const uint8_t reg, const uint8_t *const data, const size_t length ) override
+  {
+    writes++;
+    memcpy( regs[ reg ].data(), data, length );
+  }
+};
+
+/*-------------------------------------------------------------------------------
+Tests
+-------------------------------------------------------------------------------*/
+TEST( Registers, RepeatReadsServedFromShadow )
+{
+  FakeRadio radio;
+  Shadow shadow( radio );
+
+  EXPECT_EQ( shadow.read( REG_RF_CH ), 0x02 );
+  EXPECT_EQ( shadow.read( REG_RF_CH ), 0x02 );
+  EXPECT_EQ( shadow.read( REG_RF_CH ), 0x02 );
+
+  EXPECT_EQ( radio.reads, 1 );
+  EXPECT_EQ( shadow.getStats().reads, 3 );
+  EXPECT_EQ( shadow.getStats().readHits, 2 );
+}
+
+TEST( Registers, WritesGoThroughAndUnchangedOnesAreSkipped )
+{
+  FakeRadio radio;
+  Shadow shadow( radio );
+
+  shadow.write( REG_RF_CH, 96 );
+  shadow.write( REG_RF_CH, 96 );
+
+  EXPECT_EQ( radio.writes, 1 );
+  EXPECT_EQ( radio.regs[ REG_RF_CH ][ 0 ], 96 );
+  EXPECT_EQ( shadow.read( REG_RF_CH ), 96 );
+  EXPECT_EQ( radio.reads, 0 );
+
+  shadow.write( REG_RF_CH, 90 );
+
+  EXPECT_EQ( radio.writes, 2 );
+  EXPECT_EQ( radio.regs[ REG_RF_CH ][ 0 ], 90 );
+  EXPECT_EQ( shadow.getStats().writesSkipped, 1 );
+}
+
+TEST( Registers, VolatileRegistersAlwaysUseTheBus )
+{
+  FakeRadio radio;
+  Shadow shadow( radio );
+
+  shadow.read( REG_STATUS );
+  radio.regs[ REG_STATUS ][ 0 ] = 0x4E;
+  EXPECT_EQ( shadow.read( REG_STATUS ), 0x4E );
+
+  shadow.write( REG_STATUS, 0x70 );
+  shadow.write( REG_STATUS, 0x70 );
+
+  shadow.read( REG_FIFO_STATUS );
+  shadow.read( REG_OBSERVE_TX );
+  shadow.read( REG_RPD );
+
+  EXPECT_EQ( radio.reads, 5 );
+  EXPECT_EQ( radio.writes, 2 );
+  EXPECT_EQ( shadow.getStats().readHits, 0 );
+}
+
+TEST( Registers, UpdateOnlyWritesChangedBits )
+{
+  FakeRadio radio;
+  Shadow shadow( radio );
+
+  /*------------------------------------------------
+  Switching between TX and RX flips PRIM_RX in CONFIG.
+  Only the first access has to read the register.
+  ------------------------------------------------*/
+  shadow.update( REG_CONFIG, 0x01, 0x01 );
+  shadow.update( REG_CONFIG, 0x01, 0x00 );
+  shadow.update( REG_CONFIG, 0x01, 0x01 );
+  shadow.update( REG_CONFIG, 0x01, 0x01 );
+
+  EXPECT_EQ( radio.reads, 1 );
+  EXPECT_EQ( radio.writes, 3 );
+  EXPECT_EQ( radio.regs[ REG_CONFIG ][ 0 ], 0x09 );
+}
+
+TEST( Registers, AddressesTrackTheirWidth )
+{
+  FakeRadio radio;
+  Shadow shadow( radio );
+
+  const std::array<uint8_t, 5> address = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+  std::array<uint8_t, 5> readBack;
+
+  shadow.write( REG_RX_ADDR_P1, address.data(), address.size() );
+  shadow.read( REG_RX_ADDR_P1, readBack.data(), readBack.size() );
+
+  EXPECT_EQ( readBack, address );
+  EXPECT_EQ( radio.reads, 0 );
+
+  /*------------------------------------------------
+  A narrower read than the cached value goes to the
+  radio, the address width may have changed
+  ------------------------------------------------*/
+  readBack.fill( 0 );
+  shadow.read( REG_RX_ADDR_P1, readBack.data(), 3 );
+
+  EXPECT_EQ( radio.reads, 1 );
+  EXPECT_EQ( readBack[ 0 ], 0x01 );
+  EXPECT_EQ( readBack[ 2 ], 0x03 );
+}
+
+TEST( Registers, PrimeThenNoMisses )
+{
+  FakeRadio radio;
+  Shadow shadow( radio );
+  std::array<uint8_t, MAX_REGISTER_WIDTH> scratch;
+
+  shadow.prime();
+  const size_t primed = radio.reads;
+
+  for ( uint8_t reg = 0; reg < NUM_REGISTERS; reg++ )
+  {
+    if ( isCacheable( reg ) )
+    {
+      shadow.read( reg, scratch.data(), widthOf( reg, 5 ) );
+    }
+  }
+
+  EXPECT_EQ( radio.reads, primed );
+  EXPECT_EQ( shadow.read( REG_EN_AA ), 0x3F );
+}
+
+TEST( Registers, InvalidateForgetsEverything )
+{
+  FakeRadio radio;
+  Shadow shadow( radio );
+
+  shadow.write( REG_RF_SETUP, 0x26 );
+  radio.regs[ REG_RF_SETUP ][ 0 ] = 0x0E;    // Power cycled behind the shadow's back
+  shadow.invalidate();
+
+  EXPECT_EQ( shadow.read( REG_RF_SETUP ), 0x0E );
+  shadow.write( REG_RF_SETUP, 0x26 );
+
+  EXPECT_EQ( radio.writes, 2 );
+  EXPECT_EQ( radio.regs[ REG_RF_SETUP ][ 0 ], 0x26 );
+}
+
+TEST( Registers, RegisterMap )
+{
+  EXPECT_TRUE( isCacheable( REG_CONFIG ) );
+  EXPECT_TRUE( isCacheable( REG_TX_ADDR ) );
+  EXPECT_TRUE( isCacheable( REG_FEATURE ) );
+  EXPECT_FALSE( isCacheable( REG_STATUS ) );
+  EXPECT_FALSE( isCacheable( REG_FIFO_STATUS ) );
+  EXPECT_FALSE( isCacheable( 0x18 ) );
+  EXPECT_FALSE( isCacheable( NUM_REGISTERS ) );
+
+  EXPECT_EQ( widthOf( REG_RX_ADDR_P0, 4 ), 4 );
+  EXPECT_EQ( widthOf( REG_RX_ADDR_P2, 4 ), 1 );
+  EXPECT_EQ( widthOf( REG_DYNPD, 5 ), 1 );
+  EXPECT_EQ( widthOf( 0x1A, 5 ), 0 );
+}
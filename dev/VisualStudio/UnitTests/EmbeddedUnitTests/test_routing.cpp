@@ -0,0 +1,164 @@
+/********************************************************************************
+*  File Name:
+*    test_routing.cpp
+*
+*  Description:
+*    Tests the precomputed next hop table against hand worked routes and the
+*    address walking routing logic it replaces
+*
+*  2020 | Brandon Braun | brandonbraun653@gmail.com
+********************************************************************************/
+
+/* GTest Includes */
+#include "gtest/gtest.h"
+
+/* C++ Includes */
+#include <array>
+#include <vector>
+
+/* RF24 Includes */
+#include <RF24Node/src/common/definitions.hpp>
+#include <RF24Node/src/common/types.hpp>
+#include <RF24Node/src/common/utility.hpp>
+#include <RF24Node/src/network/definitions.hpp>
+
+/* Dev Includes */
+#include <sim_routing.hpp>
+
+using namespace RF24;
+using namespace Sim::Routing;
+
+/*-------------------------------------------------------------------------------
+Test Vector Structures
+-------------------------------------------------------------------------------*/
+struct NextHopTestSuite
+{
+  LogicalAddress router;
+  LogicalAddress destination;
+  LogicalAddress expected;
+};
+
+/*-------------------------------------------------------------------------------
+Test Data
+-------------------------------------------------------------------------------*/
+/* clang-format off */
+static std::vector<NextHopTestSuite> NextHopTestCandidates = {
+  /*Router        Destination                  Expected   */
+  { RootNode0,    RootNode0,                   RootNode0                  },  // Arrived
+  { 000321,       000321,                      000321                     },
+  { RootNode0,    000004,                      000004                     },  // Direct child
+  { 000021,       000321,                      000321                     },
+  { RootNode0,    054321,                      000001                     },  // Deeper descendant
+  { 000001,       054321,                      000021                     },
+  { 000021,       054321,                      000321                     },
+  { 004321,       054321,                      054321                     },
+  { 000001,       RootNode0,                   RootNode0                  },  // Up towards the root
+  { 000321,       000004,                      000021                     },
+  { 054321,       000002,                      004321                     },
+  { 000021,       000031,                      000001                     },  // Sibling branch
+  { 000321,       000421,                      000021                     },
+  { 054321,       044321,                      004321                     },
+  { 054321,       054322,                      004321                     },
+};
+
+/*------------------------------------------------
+Next hop from every node of a fixed tree to every other
+node, worked out by hand. Destinations run across in
+the same order as the routers run down.
+
+000 -+- 001
+     +- 002 --- 012
+     +- 003 --- 013 --- 0113 --- 02113 --- 042113
+------------------------------------------------*/
+static constexpr size_t FixedTreeSize = 9;
+
+static const std::array<LogicalAddress, FixedTreeSize> FixedTree = {
+  RootNode0, 000001, 000002, 000003, 000012, 000013, 000113, 002113, 042113
+};
+
+static const std::array<std::array<LogicalAddress, FixedTreeSize>, FixedTreeSize> FixedTreeNextHops = {{
+  /*  000      001      002      003      012      013      0113     02113    042113 */
+  { { 000000,  000001,  000002,  000003,  000002,  000003,  000003,  000003,  000003 } },  // 000
+  { { 000000,  000001,  000000,  000000,  000000,  000000,  000000,  000000,  000000 } },  // 001
+  { { 000000,  000000,  000002,  000000,  000012,  000000,  000000,  000000,  000000 } },  // 002
+  { { 000000,  000000,  000000,  000003,  000000,  000013,  000013,  000013,  000013 } },  // 003
+  { { 000002,  000002,  000002,  000002,  000012,  000002,  000002,  000002,  000002 } },  // 012
+  { { 000003,  000003,  000003,  000003,  000003,  000013,  000113,  000113,  000113 } },  // 013
+  { { 000013,  000013,  000013,  000013,  000013,  000013,  000113,  002113,  002113 } },  // 0113
+  { { 000113,  000113,  000113,  000113,  000113,  000113,  000113,  002113,  042113 } },  // 02113
+  { { 002113,  002113,  002113,  002113,  002113,  002113,  002113,  002113,  042113 } },  // 042113
+}};
+/* clang-format on */
+
+/*-------------------------------------------------------------------------------
+Tests
+-------------------------------------------------------------------------------*/
+TEST( Routing, KnownRoutes )
+{
+  for ( NextHopTestSuite& test : NextHopTestCandidates )
+  {
+    NextHopTable table( test.router );
+
+    EXPECT_EQ( table.nextHop( test.destination ), test.expected );
+    EXPECT_EQ( referenceNextHop( test.router, test.destination ), test.expected );
+  }
+}
+
+TEST( Routing, FixedTreeEverywhere )
+{
+  std::array<char, 100> errMsg;
+
+  for ( size_t x = 0; x < FixedTree.size(); x++ )
+  {
+    NextHopTable table( FixedTree[ x ] );
+
+    for ( size_t y = 0; y < FixedTree.size(); y++ )
+    {
+      const auto expected = FixedTreeNextHops[ x ][ y ];
+      const auto actual   = table.nextHop( FixedTree[ y ] );
+
+      if ( actual != expected )
+      {
+        snprintf( errMsg.data(), errMsg.size(), "Router: %05o, Destination: %05o, Expected: %05o, Actual: %05o",
+                  FixedTree[ x ], FixedTree[ y ], expected, actual );
+        ADD_FAILURE() << errMsg.data();
+      }
+    }
+  }
+}
+
+TEST( Routing, DeepestLevelOnlyRoutesUp )
+{
+  NextHopTable table( 054321 );
+
+  EXPECT_EQ( table.nextHop( 054321 ), 054321 );
+  EXPECT_EQ( table.nextHop( RootNode0 ), 004321 );
+  EXPECT_EQ( table.nextHop( 012345 ), 004321 );
+}
+
+TEST( Routing, InvalidRouterRoutesNothing )
+{
+  NextHopTable empty;
+  NextHopTable invalid( 006666 );
+
+  EXPECT_FALSE( invalid.build( 006666 ) );
+  EXPECT_EQ( empty.nextHop( RootNode0 ), Network::RSVD_ADDR_INVALID );
+  EXPECT_EQ( empty.nextHop( 000001 ), Network::RSVD_ADDR_INVALID );
+  EXPECT_EQ( invalid.nextHop( 000001 ), Network::RSVD_ADDR_INVALID );
+  EXPECT_EQ( invalid.nextHop( 054321 ), Network::RSVD_ADDR_INVALID );
+}
+
+TEST( Routing, RebuildFollowsNewAddress )
+{
+  NextHopTable table;
+
+  EXPECT_TRUE( table.build( 000003 ) );
+  EXPECT_EQ( table.self(), 000003 );
+  EXPECT_EQ( table.nextHop( 000043 ), 000043 );
+  EXPECT_EQ( table.nextHop( 000042 ), RootNode0 );
+
+  EXPECT_TRUE( table.build( 000042 ) );
+  EXPECT_EQ( table.self(), 000042 );
+  EXPECT_EQ( table.nextHop( 000043 ), 000002 );
+  EXPECT_EQ( table.nextHop( 000542 ), 000542 );
+}